@@ -0,0 +1,33 @@
+/*
+ * Minimal benchmark harness shared by benchmarks/bench_*.c, included after
+ * skr.h.
+ */
+
+#ifndef SKR_BENCH_H
+#define SKR_BENCH_H
+
+#include <stdio.h>
+
+/**
+ * @brief Monotonic time in nanoseconds, from ::skr_clock_now.
+ */
+static inline double bench_now_ns(void) { return skr_clock_now() * 1e9; }
+
+/**
+ * @brief Run `body` `iters` times and print the mean time per iteration.
+ *
+ * @usage
+ * BENCH("append 1k models", 100, { ... });
+ */
+#define BENCH(name, iters, body)                                               \
+	do {                                                                   \
+		const double bench_start_ = bench_now_ns();                    \
+		for (long bench_i_ = 0; bench_i_ < (iters); ++bench_i_) {      \
+			body                                                   \
+		}                                                              \
+		const double bench_ns_ =                                       \
+		        (bench_now_ns() - bench_start_) / (double)(iters);     \
+		printf("%-40s %14.1f ns/iter\n", (name), bench_ns_);           \
+	} while (0)
+
+#endif /* SKR_BENCH_H */
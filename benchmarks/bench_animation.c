@@ -0,0 +1,140 @@
+/*
+ * Animation sampling for 1000 skeletons of 100 bones per frame: clip
+ * sampling, local-to-model composition and palette writes, on one thread
+ * versus the job pool, then a crowd of 2000 through SkrAnimations spread
+ * from 2 to 400 units away.
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define SKR_BACKEND_API 0    // using opengl
+#define SKR_BACKEND_WINDOW 0 // using glfw
+#include "../skr/skr.h"
+
+#include "bench.h"
+
+#define SKELETONS 1000
+#define BONES 100
+#define KEYS 30
+#define CROWD 2000
+
+typedef struct Crowd {
+	SkrSkeleton   Skeleton;
+	SkrClip       Clip;
+	SkrSkinning   Skinning;
+	SkrClipCursor Cursors[SKELETONS];
+	int           Palettes[SKELETONS];
+	float         Time;
+} Crowd;
+
+static void animate(void* user, unsigned int begin, unsigned int end) {
+	Crowd*      c = user;
+	SkrBonePose pose[BONES];
+	mat4        model[BONES];
+
+	for (unsigned int i = begin; i < end; ++i) {
+		/* Offset each instance so cursors sit on different keys. */
+		const float t = fmodf(c->Time + (float)i * 0.013f,
+		                      c->Clip.Duration);
+
+		memcpy(pose, c->Skeleton.BindPose, sizeof(pose));
+		skr_clip_sample(&c->Clip, &c->Cursors[i], t, pose);
+		skr_skeleton_model(&c->Skeleton, pose, model);
+		skr_skeleton_palette(&c->Skeleton, (const mat4*)model,
+		                     &c->Skinning, c->Palettes[i]);
+	}
+}
+
+int main(void) {
+	static Crowd          c;
+	static float          times[KEYS];
+	static float          values[BONES * SKR_TRACK_TYPES][KEYS * 4];
+	static SkrTrackSource tracks[BONES * SKR_TRACK_TYPES];
+
+	for (int k = 0; k < KEYS; ++k)
+		times[k] = (float)k / (KEYS - 1);
+
+	skr_skeleton_init(&c.Skeleton, BONES);
+	for (int b = 0; b < BONES; ++b) {
+		c.Skeleton.Parent[b] = b - 1;
+
+		for (int type = 0; type < SKR_TRACK_TYPES; ++type) {
+			float* v = values[b * SKR_TRACK_TYPES + type];
+			for (int k = 0; k < KEYS; ++k) {
+				const float a = (float)(k + b) * 0.1f;
+				if (type == SKR_TRACK_ROTATION) {
+					glm_quatv(&v[k * 4], a, (vec3){0, 1, 0});
+				} else {
+					const bool scale = type == SKR_TRACK_SCALE;
+					v[k * 3 + 0] = scale ? 1.0f : sinf(a);
+					v[k * 3 + 1] = 1.0f;
+					v[k * 3 + 2] = scale ? 1.0f : cosf(a);
+				}
+			}
+
+			tracks[b * SKR_TRACK_TYPES + type] =
+			        (SkrTrackSource){times, v, KEYS};
+		}
+	}
+
+	skr_clip_build(&c.Clip, 1.0f, BONES, tracks);
+	for (int i = 0; i < SKELETONS; ++i) {
+		skr_clip_cursor_init(&c.Cursors[i], &c.Clip);
+		c.Palettes[i] = skr_skinning_alloc(&c.Skinning, BONES);
+	}
+
+	printf("clip: %u keys, %zu bytes (%zu uncompressed)\n",
+	       c.Clip.KeyCount, c.Clip.KeyCount * sizeof(SkrKey),
+	       (size_t)BONES * KEYS * (sizeof(float) * 11));
+
+	BENCH("1000x100 bones, 1 thread", 50, {
+		c.Time += 1.0f / 60.0f;
+		animate(&c, 0, SKELETONS);
+		skr_skinning_mark(&c.Skinning, 0, c.Skinning.Count);
+	});
+
+	SkrJobs jobs;
+	skr_jobs_init(&jobs, 0);
+	printf("job pool: %u workers + caller\n", jobs.ThreadCount);
+
+	BENCH("1000x100 bones, job pool", 50, {
+		c.Time += 1.0f / 60.0f;
+		skr_jobs_for(&jobs, SKELETONS, 16, animate, &c);
+		skr_skinning_mark(&c.Skinning, 0, c.Skinning.Count);
+	});
+
+	skr_jobs_free(&jobs);
+
+	static SkrMesh     mesh;
+	static SkrMaterial material;
+	SkrRenderables     r = {0};
+	SkrView            view = {.Valid = 1};
+	SkrAnimations      anims = {0};
+	SkrSkinning        skin = {0};
+
+	for (int p = 0; p < 6; ++p)
+		view.Planes[p][3] = 1.0f;
+	for (int i = 0; i < CROWD; ++i) {
+		const int row = skr_renderables_add(
+		        &r, 0, &mesh, &material,
+		        (vec4){0, 0, 2.0f + (float)i * 0.2f, 1}, 0);
+		skr_animations_add(&anims, &skin, &c.Skeleton, &c.Clip,
+		                   skr_renderables_handle(&r, (unsigned int)row));
+	}
+
+	BENCH("2000x100 bones, LOD 2-400 units", 50, {
+		skr_animations_update(&anims, &skin, &view, &r, 1.0f / 60.0f);
+	});
+	printf("sampled %u of %u per frame\n", anims.Sampled, anims.Count);
+
+	skr_animations_free(&anims);
+	skr_renderables_free(&r);
+	skr_skinning_free(&skin);
+	for (int i = 0; i < SKELETONS; ++i)
+		skr_clip_cursor_free(&c.Cursors[i]);
+	skr_clip_free(&c.Clip);
+	skr_skinning_free(&c.Skinning);
+	skr_skeleton_free(&c.Skeleton);
+	return 0;
+}
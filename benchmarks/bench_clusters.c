@@ -0,0 +1,92 @@
+/*
+ * Splitting a 1M-triangle grid into clusters, then culling those clusters
+ * against a camera that sees part of the grid, front and back.
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define SKR_BACKEND_API 0    // using opengl
+#define SKR_BACKEND_WINDOW 0 // using glfw
+#include "../skr/skr.h"
+
+#include "bench.h"
+
+#define W 512
+#define H 1024
+
+int main(void) {
+	SkrMesh mesh = {.VertexCount = (W + 1) * (H + 1),
+	                .IndexCount = W * H * 6};
+
+	mesh.Vertices = (SkrVertex*)calloc(mesh.VertexCount, sizeof(SkrVertex));
+	mesh.Indices =
+	        (unsigned int*)malloc(mesh.IndexCount * sizeof(unsigned int));
+	if (!mesh.Vertices || !mesh.Indices)
+		return 1;
+
+	for (unsigned int y = 0; y <= H; ++y)
+		for (unsigned int x = 0; x <= W; ++x) {
+			float* p = mesh.Vertices[y * (W + 1) + x].Position;
+			p[0] = (float)x * 0.25f - W * 0.125f;
+			p[1] = (float)y * 0.25f - H * 0.125f;
+		}
+	for (unsigned int q = 0; q < W * H; ++q) {
+		const unsigned int v = q / W * (W + 1) + q % W;
+		unsigned int*      i = &mesh.Indices[q * 6];
+		i[0] = v;
+		i[1] = v + 1;
+		i[2] = v + W + 2;
+		i[3] = v;
+		i[4] = v + W + 2;
+		i[5] = v + W + 1;
+	}
+
+	BENCH("build clusters, 1M triangles", 5,
+	      { skr_mesh_build_clusters(&mesh, 0); });
+	printf("  clusters: %u\n", mesh.ClusterCount);
+
+	SkrRenderables r = {0};
+	SkrMaterial    material = {.CullBackFaces = true};
+	SkrCamera      camera = *SkrDefaultFPSCamera;
+	SkrView        view = {0};
+
+	skr_renderables_add(&r, 0, &mesh, &material,
+	                    (vec4){0.0f, 0.0f, 0.0f, H * 0.2f},
+	                    SKR_RENDERABLE_VISIBLE);
+	camera.Position[2] = 40.0f;
+	skr_camera_rotate(&camera, 0.0f, 0.0f);
+	skr_view_update(&view, &camera, 1.0f);
+
+	BENCH("cull clusters, facing", 200, {
+		skr_renderables_cull(&r, NULL);
+		skr_renderables_cull_clusters(&r, NULL, &view);
+	});
+	printf("  visible: %u of %u in %u runs\n", r.ClusterVisible,
+	       r.ClusterCount, r.RunCount);
+
+	camera.Position[2] = -40.0f;
+	camera.Yaw = 90.0f;
+	skr_camera_rotate(&camera, 0.0f, 0.0f);
+	skr_view_update(&view, &camera, 1.0f);
+
+	/* Frustum-only count from behind, to see what the cone test rejects. */
+	material.CullBackFaces = false;
+	skr_renderables_cull(&r, NULL);
+	skr_renderables_cull_clusters(&r, NULL, &view);
+	const unsigned int in_frustum = r.ClusterVisible;
+	material.CullBackFaces = true;
+
+	BENCH("cull clusters, from behind", 200, {
+		skr_renderables_cull(&r, NULL);
+		skr_renderables_cull_clusters(&r, NULL, &view);
+	});
+	printf("  visible: %u of %u, %u rejected by cones\n", r.ClusterVisible,
+	       r.ClusterCount, in_frustum - r.ClusterVisible);
+
+	skr_renderables_free(&r);
+	skr_mesh_free_clusters(&mesh);
+	free(mesh.Vertices);
+	free(mesh.Indices);
+	return 0;
+}
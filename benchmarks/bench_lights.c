@@ -0,0 +1,51 @@
+/*
+ * Clustered light binning: 4096 point lights scattered in front of the
+ * camera, binned into the view's clusters every frame.
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define SKR_BACKEND_API 0    // using opengl
+#define SKR_BACKEND_WINDOW 0 // using glfw
+#include "../skr/skr.h"
+
+#include "bench.h"
+
+#define LIGHTS 4096
+
+int main(void) {
+	SkrCamera camera = *SkrDefaultFPSCamera;
+	SkrView   view = {0};
+	SkrLights lights = {0};
+
+	skr_camera_rotate(&camera, 0.0f, 0.0f);
+	skr_view_update(&view, &camera, 16.0f / 9.0f);
+
+	/* A 200 x 20 x 200 hall of small lights, fixed seed. */
+	unsigned int seed = 1;
+	for (int i = 0; i < LIGHTS; ++i) {
+		float v[3];
+		for (int c = 0; c < 3; ++c) {
+			seed = seed * 1664525u + 1013904223u;
+			v[c] = (float)(seed >> 8) / (float)(1u << 24);
+		}
+		skr_lights_add(&lights,
+		               (vec3){v[0] * 200.0f - 100.0f, v[1] * 20.0f,
+		                      -v[2] * 200.0f},
+		               2.0f + v[1] * 4.0f, (vec3){1, 1, 1}, 1.0f);
+	}
+
+	BENCH("bin 4096 lights", 1000, { skr_lights_bin(&lights, &view); });
+	printf("%u indices, %.1f lights per cluster\n", lights.IndexCount,
+	       (double)lights.IndexCount / SKR_CLUSTERS);
+
+	BENCH("bin 4096 lights, moving", 1000, {
+		for (unsigned int i = 0; i < lights.Count; ++i)
+			lights.Points[i].Position[1] += 0.001f;
+		skr_lights_bin(&lights, &view);
+	});
+
+	skr_lights_free(&lights);
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Frustum culling 1M renderables: packed SkrRenderables columns versus the
+ * SkrState::Models layout (model -> meshes -> program, world matrix looked up
+ * through the scene).
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define SKR_BACKEND_API 0    // using opengl
+#define SKR_BACKEND_WINDOW 0 // using glfw
+#include "../skr/skr.h"
+
+#include "bench.h"
+
+#define COUNT 1000000
+#define RADIUS 1.0f
+
+static const vec4 planes[6] = {
+        {1.0f, 0.0f, 0.0f, 500.0f},  {-1.0f, 0.0f, 0.0f, 500.0f},
+        {0.0f, 1.0f, 0.0f, 500.0f},  {0.0f, -1.0f, 0.0f, 500.0f},
+        {0.0f, 0.0f, 1.0f, 1000.0f}, {0.0f, 0.0f, -1.0f, 1000.0f},
+};
+
+static int sphere_visible(const float* c, const float r) {
+	int inside = 1;
+	for (int p = 0; p < 6; ++p)
+		inside &= planes[p][0] * c[0] + planes[p][1] * c[1] +
+		                  planes[p][2] * c[2] + planes[p][3] >=
+		          -r;
+	return inside;
+}
+
+int main(void) {
+	SkrScene          scene = {0};
+	SkrRenderables    r = {0};
+	SkrShaderProgram  program = {0};
+	SkrMaterial       material = {.Program = &program};
+	SkrState          state = {0};
+	static const vec4 bounds = {0.0f, 0.0f, 0.0f, RADIUS};
+
+	state.Models = (SkrModel*)calloc(COUNT, sizeof(SkrModel));
+	state.ModelCount = COUNT;
+
+	for (unsigned int i = 0; i < COUNT; ++i) {
+		const SkrNode node = skr_scene_node_create(&scene, 0);
+		skr_scene_node_set_position(
+		        &scene, node,
+		        (vec3){(float)(i % 1000) * 2.0f - 1000.0f,
+		               (float)(i / 1000 % 1000) * 2.0f - 1000.0f,
+		               0.0f});
+
+		/* Old layout: one heap mesh per model. */
+		SkrMesh* mesh = (SkrMesh*)calloc(1, sizeof(SkrMesh));
+		mesh->VAO = 1;
+		mesh->VertexCount = 3;
+		mesh->Program = &program;
+		state.Models[i].Meshes = mesh;
+		state.Models[i].MeshCount = 1;
+		state.Models[i].Node = node;
+
+		skr_renderables_add(&r, node, mesh, &material, bounds,
+		                    SKR_RENDERABLE_VISIBLE);
+	}
+	skr_scene_update(&scene);
+	skr_renderables_update_bounds(&r, &scene);
+
+	unsigned int visible = 0;
+
+	BENCH("cull 1M: SkrState::Models", 10, {
+		visible = 0;
+		for (unsigned int i = 0; i < state.ModelCount; ++i) {
+			const SkrModel* model = &state.Models[i];
+			for (unsigned int j = 0; j < model->MeshCount; ++j) {
+				const SkrMesh* mesh = &model->Meshes[j];
+				if (mesh->VAO == 0 || !mesh->Program)
+					continue;
+				vec4* m = scene.World[scene.Slot[model->Node]];
+				visible += sphere_visible(m[3], RADIUS);
+			}
+		}
+	});
+	printf("  visible: %u\n", visible);
+
+	BENCH("cull 1M: SkrRenderables", 10,
+	      { visible = skr_renderables_cull(&r, planes); });
+	printf("  visible: %u\n", visible);
+
+	BENCH("cull + sort 1M: SkrRenderables", 5, {
+		skr_renderables_cull(&r, planes);
+		skr_renderables_sort(&r);
+	});
+
+	BENCH("update bounds 1M: SkrRenderables", 10,
+	      { skr_renderables_update_bounds(&r, &scene); });
+
+	for (unsigned int i = 0; i < COUNT; ++i)
+		free(state.Models[i].Meshes);
+	free(state.Models);
+	skr_renderables_free(&r);
+	skr_scene_free(&scene);
+	return 0;
+}
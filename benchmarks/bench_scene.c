@@ -0,0 +1,48 @@
+/*
+ * Transform hierarchy updates on a 100k-node scene: moving a single leaf
+ * versus a change at the root that dirties every node.
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define SKR_BACKEND_API 0    // using opengl
+#define SKR_BACKEND_WINDOW 0 // using glfw
+#include "../skr/skr.h"
+
+#include "bench.h"
+
+#define NODES 100000
+#define FANOUT 8
+
+int main(void) {
+	SkrScene scene = {0};
+	SkrNode  root = skr_scene_node_create(&scene, 0);
+
+	/* Balanced tree, each node has up to FANOUT children. */
+	for (unsigned int i = 1; i < NODES; ++i)
+		skr_scene_node_create(&scene, 1 + (i - 1) / FANOUT);
+
+	skr_scene_update(&scene);
+
+	const SkrNode leaf = NODES;
+	float         x = 0.0f;
+
+	BENCH("move 1 leaf of 100k", 10000, {
+		x += 1.0f;
+		skr_scene_node_set_position(&scene, leaf, (vec3){x, 0, 0});
+		skr_scene_update(&scene);
+	});
+
+	BENCH("move root of 100k (full update)", 20, {
+		x += 1.0f;
+		skr_scene_node_set_position(&scene, root, (vec3){x, 0, 0});
+		skr_scene_update(&scene);
+	});
+
+	BENCH("update with nothing dirty", 100000,
+	      { skr_scene_update(&scene); });
+
+	skr_scene_free(&scene);
+	return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * Back-to-front ordering of 1M float depths: qsort versus the radix sort on
+ * one thread and on the job pool, then culling and sorting 100k transparent
+ * renderables.
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define SKR_BACKEND_API 0    // using opengl
+#define SKR_BACKEND_WINDOW 0 // using glfw
+#include "../skr/skr.h"
+
+#include "bench.h"
+
+#define COUNT 1000000
+#define TRANSPARENT 100000
+
+typedef struct Entry {
+	float        Depth;
+	unsigned int Index;
+} Entry;
+
+static int farther(const void* a, const void* b) {
+	const float x = ((const Entry*)a)->Depth;
+	const float y = ((const Entry*)b)->Depth;
+	return (x < y) - (x > y);
+}
+
+static float depths[COUNT];
+static Entry entries[COUNT];
+
+static void fill(SkrRadixSort* sort) {
+	for (unsigned int i = 0; i < COUNT; ++i) {
+		sort->Keys[i] = ~skr_radix_float_key(depths[i]);
+		sort->Values[i] = i;
+	}
+}
+
+int main(void) {
+	SkrRadixSort sort = {0};
+	unsigned int seed = 1;
+
+	skr_radix_reserve(&sort, COUNT);
+	for (unsigned int i = 0; i < COUNT; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		depths[i] = (float)(seed >> 8) * (1000.0f / 16777216.0f);
+	}
+
+	BENCH("sort 1M depths: qsort", 5, {
+		for (unsigned int i = 0; i < COUNT; ++i) {
+			entries[i].Depth = depths[i];
+			entries[i].Index = i;
+		}
+		qsort(entries, COUNT, sizeof(Entry), farther);
+	});
+
+	BENCH("sort 1M depths: radix, 1 thread", 5, {
+		fill(&sort);
+		skr_radix_sort(&sort, COUNT, NULL);
+	});
+	printf("  passes: %u, first: %u\n", sort.Passes, sort.Values[0]);
+
+	SkrJobs jobs;
+	skr_jobs_init(&jobs, 0);
+	printf("job pool: %u workers + caller\n", jobs.ThreadCount);
+
+	BENCH("sort 1M depths: radix, job pool", 5, {
+		fill(&sort);
+		skr_radix_sort(&sort, COUNT, &jobs);
+	});
+
+	SkrRenderables    r = {0};
+	SkrShaderProgram  program = {0};
+	SkrMaterial       material = {.Program = &program};
+	SkrMesh           mesh = {.VertexCount = 3};
+	SkrCamera         camera = *SkrDefaultFPSCamera;
+	SkrView           view = {0};
+	static const vec4 bounds = {0.0f, 0.0f, 0.0f, 1.0f};
+
+	for (unsigned int i = 0; i < TRANSPARENT; ++i) {
+		const int row = skr_renderables_add(
+		        &r, 0, &mesh, &material, bounds,
+		        SKR_RENDERABLE_VISIBLE | SKR_RENDERABLE_TRANSPARENT);
+		r.Bounds[row][2] = -depths[i];
+	}
+	skr_camera_rotate(&camera, 0.0f, 0.0f);
+	skr_view_update(&view, &camera, 1.0f);
+
+	BENCH("cull + sort 100k transparent", 20, {
+		skr_renderables_cull(&r, NULL);
+		skr_renderables_sort_transparent(&r, &view, &sort, &jobs);
+	});
+
+	skr_jobs_free(&jobs);
+	skr_renderables_free(&r);
+	skr_radix_free(&sort);
+	return 0;
+}
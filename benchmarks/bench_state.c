@@ -0,0 +1,38 @@
+/*
+ * CPU cost of building the engine state: appending vertices, meshes and
+ * models.
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define SKR_BACKEND_API 0    // using opengl
+#define SKR_BACKEND_WINDOW 0 // using glfw
+#include "../skr/skr.h"
+
+#include "bench.h"
+
+#define MODELS 1000
+#define VERTICES 4096
+
+int main(void) {
+	static SkrVertex vertices[VERTICES];
+
+	BENCH("append 4096 vertices (x16 chunks)", 100, {
+		SkrMesh mesh = {0};
+		for (int c = 0; c < 16; ++c)
+			m_skr_mesh_append_vertices(&mesh, vertices,
+			                           VERTICES / 16);
+		free(mesh.Vertices);
+	});
+
+	BENCH("append 1000 models", 100, {
+		SkrState state = {0};
+		SkrModel model = {0};
+		for (int m = 0; m < MODELS; ++m)
+			skr_state_append_model(&state, &model);
+		free(state.Models);
+	});
+
+	return 0;
+}
@@ -0,0 +1,25 @@
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+# Extracts the ```c fenced block of a markdown example into a C file, keeping
+# compiler diagnostics pointing at the markdown source.
+#
+# Usage: cmake -DINPUT=<example.md> -DOUTPUT=<example.c> -P SkrExtractExample.cmake
+
+file(READ "${INPUT}" content)
+
+string(FIND "${content}" "```c\n" fence)
+if(fence EQUAL -1)
+	message(FATAL_ERROR "${INPUT}: no ```c code block found")
+endif()
+
+string(SUBSTRING "${content}" 0 ${fence} before)
+string(REGEX MATCHALL "\n" newlines "${before}")
+list(LENGTH newlines line)
+math(EXPR line "${line} + 2")
+
+math(EXPR start "${fence} + 5")
+string(SUBSTRING "${content}" ${start} -1 code)
+string(FIND "${code}" "```" end)
+string(SUBSTRING "${code}" 0 ${end} code)
+
+file(WRITE "${OUTPUT}" "#line ${line} \"${INPUT}\"\n${code}")
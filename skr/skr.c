@@ -0,0 +1,26 @@
+/**
+ * @file skr.c
+ *
+ * Compiled library mode of skr.h.
+ *
+ * This is the single translation unit that holds the engine's function
+ * bodies when SKR is built as a library. Consumers link against it and define
+ * SKR_LIBRARY before including skr.h.
+ *
+ * @copyright (C) 2025 SKR Authors
+ *
+ * @license SPDX-License-Identifier: GPL-3.0-or-later (see LICENSE).
+ */
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#ifndef SKR_BACKEND_API
+#define SKR_BACKEND_API 0 // opengl
+#endif
+#ifndef SKR_BACKEND_WINDOW
+#define SKR_BACKEND_WINDOW 0 // glfw
+#endif
+
+#define SKR_IMPLEMENTATION
+#include "skr.h"
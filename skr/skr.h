@@ -28,10 +28,80 @@
 extern "C" {
 #endif
 
+#include <math.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+/* Strict ISO C hides the POSIX clocks, C11 threads still sleep. */
+#if !defined(CLOCK_MONOTONIC) && !defined(__cplusplus) &&                     \
+        !defined(__STDC_NO_THREADS__)
+#include <threads.h>
+#endif
+#endif
+
+/*
+ * SKR can be consumed in two ways:
+ *
+ * - Header-only (default): every function is `static inline` and compiled
+ *   into each translation unit that includes skr.h.
+ *
+ * - Compiled library: exactly one translation unit defines
+ *   SKR_IMPLEMENTATION before including skr.h (see skr/skr.c), every other
+ *   translation unit defines SKR_LIBRARY and only sees the declarations.
+ *   The engine is then compiled once, which keeps build times and binary
+ *   size flat and lets LTO/PGO see the hot paths as a single unit.
+ */
+
+/**
+ * @brief Linkage of public SKR functions.
+ */
+#if defined(SKR_IMPLEMENTATION)
+#define SKR_API
+#elif defined(SKR_LIBRARY)
+#define SKR_API extern
+#else
+#define SKR_API static inline
+#endif
+
+/**
+ * @internal
+ * @brief Defined when this translation unit must contain function bodies.
+ */
+#if defined(SKR_IMPLEMENTATION) || !defined(SKR_LIBRARY)
+#define M_SKR_DEFINE_IMPL
+#endif
+
+/**
+ * @brief Counter shared between threads, only touched through the API.
+ *
+ * C++ has no `atomic_uint` or `_Alignas`, so C++ translation units (which
+ * can only link against the compiled library) see a plain `unsigned int`
+ * with the same size and alignment instead.
+ */
+#ifdef __cplusplus
+typedef unsigned int SkrAtomicUint;
+#define SKR_ALIGNAS(n) alignas(n)
+#else
+#include <stdatomic.h>
+typedef atomic_uint SkrAtomicUint;
+#define SKR_ALIGNAS(n) _Alignas(n)
+_Static_assert(sizeof(SkrAtomicUint) == sizeof(unsigned int),
+               "C++ consumers assume a lock-free unsigned int layout");
+#endif
 
 /**
  * @brief Identifies the type of graphics API backend in use.
@@ -64,6 +134,9 @@ typedef enum SkrAPIBackendType {
 #include <vulkan/vulkan.h>
 #endif
 
+/* Default backend if none was specified: OpenGL */
+#define SKR_BACKEND_API 0
+
 #else
 
 #if !defined(VULKAN_H_)
@@ -105,7 +178,7 @@ typedef enum SkrWindowBackendType {
 #endif
 
 /* Default backend if none was specified: GLFW */
-#define SKR_BACKEND_WINDOW SKR_BACKEND_WINDOW_GLFW
+#define SKR_BACKEND_WINDOW 0
 
 #endif
 
@@ -115,9 +188,9 @@ typedef enum SkrWindowBackendType {
 
 /**
  * @internal
- * @brief Size of the global error buffer (in bytes).
+ * @brief Size of the per-thread error buffers (in bytes).
  *
- * This constant defines the maximum length of the error string stored in
+ * This constant defines the maximum length of the error string returned by
  * `SKR_LAST_ERROR`, including the null terminator.
  */
 #ifndef SKR_LAST_ERROR_SIZE
@@ -125,34 +198,61 @@ typedef enum SkrWindowBackendType {
 #endif
 
 /**
- * @brief Global error buffer.
+ * @brief Status codes.
  *
- * Holds the most recent error message set by the error handling system. Its
- * size is fixed at `SKR_LAST_ERROR_SIZE`.
+ * Public functions return 1 on success and 0 on failure; the code of the most
+ * recent failure on the calling thread is returned by ::SkrLastError.
+ */
+typedef enum SkrResult {
+	SKR_SUCCESS = 0,            /*!< No error. */
+	SKR_ERROR_INVALID_ARGUMENT, /*!< NULL or out-of-range argument. */
+	SKR_ERROR_OUT_OF_MEMORY,    /*!< Allocation failed. */
+	SKR_ERROR_IO,               /*!< File could not be read. */
+	SKR_ERROR_WINDOW,           /*!< Window backend failure. */
+	SKR_ERROR_BACKEND,          /*!< Backend not available. */
+	SKR_ERROR_SHADER,           /*!< Shader compile or link failure. */
+	SKR_ERROR_TEXTURE,          /*!< Texture could not be loaded. */
+} SkrResult;
+
+/**
+ * @internal
+ * @brief Storage class of the per-thread error state.
+ */
+#if defined(__cplusplus)
+#define M_SKR_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define M_SKR_THREAD_LOCAL __declspec(thread)
+#else
+#define M_SKR_THREAD_LOCAL _Thread_local
+#endif
+
+/**
+ * @brief Last error message of the calling thread.
  *
- * @details
- * If the buffer is empty (first character == '\0'),
- * then no error is currently set.
+ * Formatted on first access after a failure, the string is owned by the
+ * thread and valid until its next failure. Empty if no error is set.
  *
- * @see m_skr_last_error_clear
- * @see m_skr_last_error_set
+ * @see SkrLastErrorMessage
  * @see SKR_OK
  */
-static char SKR_LAST_ERROR[SKR_LAST_ERROR_SIZE];
+#define SKR_LAST_ERROR (SkrLastErrorMessage())
 
 /**
- * @brief Checks if there is no error set.
- *
- * Returns true (nonzero) if `SKR_LAST_ERROR` is empty, false (0) otherwise.
+ * @brief Checks if there is no error set on the calling thread.
  *
  * @return int 1 if no error, 0 if an error exists.
  *
+ * @details
+ * Failures always set the error. Successful calls only clear it in debug
+ * builds (NDEBUG undefined), so in release builds check the function's return
+ * value, or call ::SkrClearError before the call being tested.
+ *
  * @usage
  * if (!SKR_OK) {
  *     fprintf(stderr, "Error: %s\n", SKR_LAST_ERROR);
  * }
  */
-#define SKR_OK (SKR_LAST_ERROR[0] == '\0')
+#define SKR_OK (SkrLastError() == SKR_SUCCESS)
 
 /**
  * @brief Maximum number of bone influences per vertex.
@@ -208,6 +308,9 @@ typedef struct SkrShaderProgram {
 	union {
 		struct {
 			GLuint ID;
+			GLint  Model; /*!< Location of `model`, -1 if unused. */
+			GLint  BoneBase; /*!< Location of `skr_bone_base`. */
+			GLint  MorphBase; /*!< Location of `skr_morph_base`. */
 		} GL;
 	} Backend;
 } SkrShaderProgram;
@@ -257,14 +360,16 @@ typedef struct SkrVertex {
 	vec3 Bitangent; // layout (location = 5)
 
 	/**
-	 * @brief Indices of influencing bones.
+	 * @brief Indices of influencing bones, relative to the renderable's
+	 * palette. Uploaded as integers (`ivec4`).
 	 */
 	int BoneIDs[MAX_BONE_INFLUENCE]; // layout (location = 6, optional)
 
 	/**
-	 * @brief Weights of influencing bones.
+	 * @brief Weights of influencing bones, summing to 1 (see
+	 * ::skr_mesh_normalize_weights), or all 0 for a rigid vertex.
 	 */
-	int BoneWeights[MAX_BONE_INFLUENCE]; // layout (location = 7, optional)
+	float BoneWeights[MAX_BONE_INFLUENCE]; // layout (location = 7, optional)
 } SkrVertex;
 
 /**
@@ -325,6 +430,43 @@ typedef struct SkrTexture {
 	} Backend;
 } SkrTexture;
 
+/**
+ * @brief One vertex moved by a morph target, 16 bytes.
+ *
+ * Deltas are quantized to 16 bits: positions by SkrMorphTarget::Scale,
+ * normals over [-2, 2].
+ */
+typedef struct SkrMorphDelta {
+	unsigned int Vertex;
+	short        Position[3];
+	short        Normal[3];
+} SkrMorphDelta;
+
+/**
+ * @brief Blend shape, a run of SkrMesh::Deltas.
+ */
+typedef struct SkrMorphTarget {
+	unsigned int First; /*!< First delta. */
+	unsigned int Count; /*!< Vertices the target moves. */
+	float        Scale; /*!< Position units per quantization step. */
+} SkrMorphTarget;
+
+/**
+ * @brief Triangle cluster of a mesh, see ::skr_mesh_build_clusters.
+ */
+typedef struct SkrCluster {
+	vec4 Bounds; /*!< Object-space sphere (xyz, radius). */
+
+	/**
+	 * @brief Normal cone: axis xyz and the sine of its half-angle in w,
+	 * 1 when the normals spread too far to ever be all back-facing.
+	 */
+	vec4 Cone;
+
+	unsigned int First; /*!< First index in SkrMesh::Indices. */
+	unsigned int Count; /*!< Indices, three per triangle. */
+} SkrCluster;
+
 /**
  * @brief Renderable mesh data.
  *
@@ -354,6 +496,15 @@ typedef struct SkrMesh {
 	 */
 	unsigned int EBO;
 
+	/**
+	 * @brief Tightly packed positions and a VAO reading only them.
+	 *
+	 * Depth-only passes draw from this stream, 12 bytes per vertex
+	 * instead of a whole SkrVertex. It shares the EBO.
+	 */
+	unsigned int PositionVBO;
+	unsigned int PositionVAO;
+
 	/**
 	 * @brief Vertex data.
 	 *
@@ -369,9 +520,93 @@ typedef struct SkrMesh {
 	unsigned int* Indices;
 	unsigned int  IndexCount;
 
+	/**
+	 * @brief Morph targets, see ::skr_mesh_add_morph_target.
+	 *
+	 * Only the vertices a target moves are stored, so a head with dozens
+	 * of facial targets costs little more than the regions they touch.
+	 */
+	SkrMorphTarget* Targets;
+	unsigned int    TargetCount;
+	SkrMorphDelta*  Deltas; /*!< Deltas of every target. */
+	unsigned int    DeltaCount;
+
+	/**
+	 * @brief Clusters covering `Indices` in order, see
+	 * ::skr_mesh_build_clusters.
+	 */
+	SkrCluster*  Clusters;
+	unsigned int ClusterCount;
+
 	SkrShaderProgram* Program;
 } SkrMesh;
 
+/**
+ * @brief Handle of a transform node in a ::SkrScene.
+ *
+ * Stable for the lifetime of the scene. 0 means "no node".
+ */
+typedef unsigned int SkrNode;
+
+/**
+ * @brief Transform hierarchy.
+ *
+ * Nodes hold a local translation/rotation/scale and a parent. World matrices
+ * are only recomputed by ::skr_scene_update for subtrees below nodes whose
+ * local transform or parent changed since the last update.
+ *
+ * Storage is structure-of-arrays indexed by slot. Slots are kept sorted by
+ * depth, so parents always precede their children and a level can be walked
+ * linearly; handles map to slots through `Slot`. Each array has `Capacity`
+ * elements.
+ */
+typedef struct SkrScene {
+	unsigned int Count;    /*!< Number of nodes. */
+	unsigned int Capacity; /*!< Allocated slots. */
+
+	/* Per slot. Links hold slots, SKR_SCENE_NONE when absent. */
+	unsigned int* Parent;
+	unsigned int* FirstChild;
+	unsigned int* NextSibling;
+	unsigned int* Depth;
+	SkrNode*      Node; /*!< Handle of each slot. */
+
+	vec3*          Position; /*!< Local translation. */
+	versor*        Rotation; /*!< Local rotation. */
+	vec3*          Scale;    /*!< Local scale. */
+	mat4*          World;    /*!< World matrix, valid after update. */
+	unsigned char* Dirty;    /*!< Slot is queued in `DirtyList`. */
+
+	unsigned int* Slot; /*!< Slot of each handle, index 0 unused. */
+
+	unsigned int* DirtyList; /*!< Slots whose subtree needs an update. */
+	unsigned int  DirtyCount;
+
+	bool Unsorted; /*!< Depth order must be restored before update. */
+
+	/**
+	 * @brief Interpolate moving nodes between simulation steps.
+	 *
+	 * When set, local transforms changed during a fixed step are
+	 * remembered together with their value at the start of the step, and
+	 * world matrices are built from the blend of both by `Alpha`.
+	 */
+	bool  Interpolate;
+	float Alpha; /*!< Blend factor, 0 = previous step, 1 = current. */
+
+	vec3*          PrevPosition; /*!< Local translation at step start. */
+	versor*        PrevRotation; /*!< Local rotation at step start. */
+	vec3*          PrevScale;    /*!< Local scale at step start. */
+	unsigned char* Moving;       /*!< Slot is queued in `MovingList`. */
+	unsigned int*  MovingList;   /*!< Slots changed during this step. */
+	unsigned int   MovingCount;
+} SkrScene;
+
+/**
+ * @brief Missing parent/child/sibling link in ::SkrScene.
+ */
+#define SKR_SCENE_NONE 0xffffffffu
+
 /**
  * @brief 3D model representation.
  *
@@ -393,630 +628,9944 @@ typedef struct SkrModel {
 	unsigned int TextureCount;
 
 	char* Directory; /*!< Filesystem path of the model directory. */
+
+	/**
+	 * @brief Transform node in SkrState::Scene, 0 for identity.
+	 *
+	 * Its world matrix is uploaded to the `model` uniform of each mesh.
+	 */
+	SkrNode Node;
 } SkrModel;
 
 /**
- * @brief Tagged union that wraps a backend window handle.
+ * @brief Shading state shared by renderables.
  *
- * Contains both the backend type (`Tag`) and the backend-specific handle
- * (`Handler`). Only the member corresponding to the active backend type is
- * valid.
+ * The program and texture set bound for a draw. Renderables sorted by
+ * material are submitted with one bind per material.
  */
-typedef struct SkrWindowBackend {
-	const SkrWindowBackendType Type; /*!< Backend type. */
-
-	union {
-		struct GLFWwindow* GLFW; /*!< Handle to a GLFW window. */
-		                         /* TODO: more backends */
-	} Handler;                       /*!< Backend-specific handle. */
-} SkrWindowBackend;
+typedef struct SkrMaterial {
+	SkrShaderProgram* Program;
+	SkrTexture*       Textures; /*!< Bound to texture units 0..N-1. */
+	unsigned int      TextureCount;
 
-struct SkrWindow;
+	/**
+	 * @brief Draw front faces only.
+	 *
+	 * Enables back-face culling for the material's draws, and lets
+	 * ::skr_renderables_cull_clusters drop clusters facing away from the
+	 * eye. Leave false for open or double-sided meshes, which are then
+	 * drawn from both sides.
+	 */
+	bool CullBackFaces;
+} SkrMaterial;
 
 /**
- * @brief Function type for input event callbacks.
+ * @brief Renderable flags.
  */
-typedef void SkrInputHandler(struct SkrWindow* w);
+typedef enum SkrRenderableFlags {
+	SKR_RENDERABLE_VISIBLE = 1u << 0,     /*!< Considered for drawing. */
+	SKR_RENDERABLE_CAST_SHADOW = 1u << 1, /*!< Drawn into shadow maps. */
+	SKR_RENDERABLE_STATIC = 1u << 2,      /*!< Cached in far cascades. */
+	SKR_RENDERABLE_TRANSPARENT = 1u << 3, /*!< Blended after the scene. */
+} SkrRenderableFlags;
 
 /**
- * @brief Generic engine window.
- *
- * A portable window structure that abstracts over different windowing backends.
- * Encapsulates title, size, optional input handler, and backend data.
+ * @brief One draw produced by culling, in submission order.
  */
-typedef struct SkrWindow {
-	char* Title;  /*!< Window title (UTF-8 string). */
-	int   Width;  /*!< Width of the window in pixels. */
-	int   Height; /*!< Height of the window in pixels. */
+typedef struct SkrDrawItem {
+	const SkrMaterial* Material;
+	const SkrMesh*     Mesh;
+	unsigned int       Index; /*!< Renderable index. */
 
-	SkrInputHandler* InputHandler; /*!< Pointer to input handler. */
-	SkrWindowBackend Backend;      /*!< Backend type and handle. */
-} SkrWindow;
+	unsigned int FirstRun; /*!< First of its SkrRenderables::Runs. */
+	unsigned int RunCount; /*!< Runs drawn, 0 for the whole mesh. */
+} SkrDrawItem;
 
 /**
- * @brief First-person camera structure.
+ * @brief Handle of a row in a ::SkrRenderables.
  *
- * Stores position, orientation, and field-of-view.
- * Can be controlled by mouse and keyboard input.
+ * Stable until the row is removed, after which it may be reused.
+ * 0 means "no renderable".
  */
-typedef struct SkrCamera {
-	vec3 Position; /*!< Camera position in world space. */
-	vec3 Front;    /*!< Normalized forward vector. */
-	vec3 Up;       /*!< Normalized up vector. */
-	vec3 Right;    /*!< Normalized right vector. */
-	vec3 WorldUp;  /*!< Global up direction, usually {0, 1, 0}. */
-
-	float Yaw;
-	float Pitch;
-	float FOV;
-	float Zoom;
+typedef unsigned int SkrRenderable;
 
-	float Sensitivity;
-	float Speed;
-} SkrCamera;
+/**
+ * @brief Packed renderable tables.
+ *
+ * Each renderable is a row spread over tightly packed columns (transform
+ * node, bounds, mesh, material, flags), so bounds updates, culling, sorting
+ * and submission each stream through only the columns they need.
+ *
+ * Rows are dense: removal moves the last row into the hole, so indices are
+ * only stable until the next ::skr_renderables_remove. Keep a
+ * ::SkrRenderable to refer to a row across removals.
+ */
+typedef struct SkrRenderables {
+	unsigned int Count;    /*!< Number of rows. */
+	unsigned int Capacity; /*!< Allocated rows. */
+
+	SkrNode*      Node;        /*!< Transform in SkrState::Scene, or 0. */
+	vec4*         LocalBounds; /*!< Object-space sphere (xyz, radius). */
+	vec4*         Bounds;      /*!< World-space sphere (xyz, radius). */
+	SkrMesh**     Mesh;        /*!< Geometry. */
+	SkrMaterial** Material;    /*!< Shading state. */
+	unsigned int* Flags;       /*!< ::SkrRenderableFlags. */
+	int*          Skin;        /*!< First palette bone, -1 if rigid. */
+	unsigned int* Skinned;     /*!< SkrSkinning::Outputs index + 1. */
+	int*          Morph;       /*!< SkrMorphs::Instances index, or -1. */
+	mat4*         Previous;    /*!< Last frame's world, zero if none. */
+
+	SkrRenderable* Handle; /*!< Handle of each row. */
+	unsigned int*  Row;    /*!< Row of each handle, at handle - 1. */
+	SkrRenderable* Free;   /*!< Handles released by removal. */
+	unsigned int   FreeCount;
+
+	SkrDrawItem* Draws; /*!< Output of culling, `Capacity` entries. */
+	unsigned int DrawCount;
 
-static char* skr_camera_3d_vert =
-        "#version 330 core\n"
-        "layout (location = 0) in vec3 aPos;\n"
-        "layout (location = 1) in vec2 aTexCoord;\n"
-        "out vec2 TexCoord;\n"
-        "uniform mat4 model;\n"
-        "uniform mat4 view;\n"
-        "uniform mat4 projection;\n"
-        "void main() {\n"
-        "gl_Position = projection * view * model * vec4(aPos, "
-        "1.0f);\n"
-        "TexCoord = vec2(aTexCoord.x, aTexCoord.y);\n"
-        "}\n";
+	/**
+	 * @brief Culled ::SKR_RENDERABLE_TRANSPARENT rows, `Capacity` entries,
+	 * back to front after ::skr_renderables_sort_transparent.
+	 */
+	SkrDrawItem* Transparent;
+	unsigned int TransparentCount;
 
-#define SkrDefaultFPSCamera                                                    \
-	(&(SkrCamera){                                                         \
-	        .Position = {0.0f, 0.0f, 3.0f},                                \
-	        .Front = {0.0f, 0.0f, -1.0f},                                  \
-	        .Up = {0.0f, 1.0f, 0.0f},                                      \
-                                                                               \
-	        .Yaw = -90.0f,                                                 \
-	        .Pitch = 0.0f,                                                 \
-	        .FOV = 70.0f,                                                  \
-	        .Zoom = 1.0f,                                                  \
-                                                                               \
-	        .Sensitivity = 0.1f,                                           \
-	        .Speed = 0.1f,                                                 \
-	})
+	/**
+	 * @brief Index ranges left by ::skr_renderables_cull_clusters, as
+	 * first index and count pairs.
+	 */
+	unsigned int* Runs;
+	unsigned int  RunCount;
+	unsigned int  RunCapacity; /*!< Pairs `Runs` holds. */
 
-typedef struct SkrState {
-	SkrWindow* Window;
+	unsigned int ClusterCount;   /*!< Clusters tested by the last cull. */
+	unsigned int ClusterVisible; /*!< Clusters it kept. */
+} SkrRenderables;
 
-	SkrModel*    Models;
-	unsigned int ModelCount;
+/**
+ * @brief Texture unit the bone palette buffer texture is bound to.
+ */
+#ifndef SKR_SKINNING_UNIT
+#define SKR_SKINNING_UNIT 15
+#endif
 
-	SkrCamera* Camera;
+/**
+ * @brief Skinned vertices of one renderable, written by the pre-pass.
+ *
+ * Two vec4 per vertex: position (w = 1) and normal (w = 0).
+ */
+typedef struct SkrSkinOutput {
+	SkrMesh*      Mesh;        /*!< Source mesh. */
+	int           Base;        /*!< Palette it was skinned with. */
+	unsigned int  VertexCount; /*!< Vertices the buffer holds. */
+	unsigned long Frame;       /*!< SkrRenderStats::Frame last skinned. */
 
 	union {
-		bool GL;
+		struct {
+			GLuint Buffer; /*!< Skinned positions and normals. */
+			GLuint VAO;    /*!< Skinned stream + mesh attributes. */
+		} GL;
 	} Backend;
-} SkrState;
-
-static bool m_skr_renderer_initialized = false;
+} SkrSkinOutput;
 
 /**
- * @internal
- * @brief Set the last error message with source metadata.
+ * @brief Bone palettes of every skinned renderable, in one GPU buffer.
  *
- * Formats a string with printf-style arguments and stores it into the global
- * error buffer 'SKR_LAST_ERROR'. The message will typically be set through the
- * @ref SKR_LAST_ERROR_SET macro, which automatically includes the file, line,
- * and function name where the error occurred.
- *
- * @param file  Source file where the error occurred (use __FILE__).
- * @param line  Line number where the error occurred (use __LINE__).
- * @param func  Function name where the error occurred (use __func__).
- * @param fmt   Format string (printf-style).
- * @param ...   Arguments corresponding to the format specifiers in `fmt`.
+ * Each bone takes three texels: the rows of its 3x4 skinning matrix
+ * (::skr_skinning_set), or a dual quaternion in the first two
+ * (::skr_skinning_set_dq). Palettes are carved out with
+ * ::skr_skinning_alloc and only the range written since the last frame is
+ * uploaded, so hundreds of characters cost one buffer update and no extra
+ * binds per draw.
  */
-static inline void m_skr_last_error_set_with_meta(const char* file, int line,
-                                                  const char* func,
-                                                  const char* fmt, ...) {
-	va_list args;
-	va_start(args, fmt);
+typedef struct SkrSkinning {
+	vec4*        Bones;    /*!< Three texels per bone. */
+	unsigned int Count;    /*!< Bones allocated. */
+	unsigned int Capacity; /*!< Bones `Bones` has room for. */
+
+	unsigned int DirtyBegin; /*!< First bone to upload. */
+	unsigned int DirtyEnd;   /*!< One past the last bone to upload. */
 
-	unsigned long written = (unsigned long)snprintf(
-	        SKR_LAST_ERROR, SKR_LAST_ERROR_SIZE,
-	        "[SKR] ERROR %s:%d:%s: ", file, line, func);
+	/**
+	 * @brief Skin each visible skinned renderable once per frame.
+	 *
+	 * Instead of skinning in every pass's vertex shader, a pre-pass
+	 * writes skinned positions and normals (linear blend) to a buffer
+	 * per renderable that all passes then draw from. Runs as a compute
+	 * shader on GL 4.3, on the CPU otherwise.
+	 */
+	bool Prepass;
 
-	if (written < 0 || written >= SKR_LAST_ERROR_SIZE)
-		written = 0;
+	SkrSkinOutput* Outputs;     /*!< Pre-pass results. */
+	unsigned int   OutputCount;
+	unsigned int   OutputCapacity;
 
-	vsnprintf(SKR_LAST_ERROR + written, SKR_LAST_ERROR_SIZE - written, fmt,
-	          args);
+	vec4*        Scratch;         /*!< CPU pre-pass output staging. */
+	unsigned int ScratchCapacity; /*!< Vertices `Scratch` can hold. */
 
-	va_end(args);
-}
+	union {
+		struct {
+			GLuint       Buffer;   /*!< GL_TEXTURE_BUFFER storage. */
+			GLuint       Texture;  /*!< RGBA32F view of `Buffer`. */
+			unsigned int Capacity; /*!< Bones `Buffer` has room for. */
+			GLuint       Compute;  /*!< Pre-pass program, 0 for CPU. */
+			GLint        ComputeBase;  /*!< `skr_bone_base` location. */
+			GLint        ComputeCount; /*!< `skr_count` location. */
+			GLint ComputeMorph; /*!< `skr_morph_base` location. */
+		} GL;
+	} Backend;
+} SkrSkinning;
 
 /**
- * @brief Set the last error message with automatic source metadata.
- *
- * Use this macro instead of calling 'm_skr_last_error_set_with_meta()'
- * directly. It automatically includes the source file, line number, and
- * function name in the error message prefix.
- *
- * @usage
- * m_skr_last_error_set("Failed to load texture: %s", path);
+ * @brief Texture unit the morph delta buffer texture is bound to.
  */
-#define m_skr_last_error_set(...)                                              \
-	m_skr_last_error_set_with_meta(__FILE__, __LINE__, __func__,           \
-	                               __VA_ARGS__)
+#ifndef SKR_MORPH_UNIT
+#define SKR_MORPH_UNIT 14
+#endif
 
 /**
- * @internal
- * @brief Clears the global error buffer.
- *
- * Sets the first character of `SKR_LAST_ERROR` to '\0', effectively removing
- * any previously stored error message.
- *
- * @usage
- * m_skr_last_error_clear();
+ * @brief Morph weights of one mesh instance.
  */
-static inline void m_skr_last_error_clear(void) { SKR_LAST_ERROR[0] = '\0'; }
+typedef struct SkrMorphInstance {
+	SkrMesh*      Mesh;
+	unsigned int  Base;        /*!< First vertex in SkrMorphs::Deltas. */
+	float*        Weights;     /*!< One per target, `TargetCount` long. */
+	unsigned int  TargetCount; /*!< Grows as the mesh gains targets. */
+	bool          Dirty;       /*!< Weights changed since the last apply. */
+	unsigned int* Touched; /*!< Vertices holding a delta. */
+	unsigned int  TouchedCount;
+} SkrMorphInstance;
 
 /**
- * @internal
- * @brief Load an image from a file into raw pixel memory.
- *
- * This function **must be implemented by the user** of the engine. The engine
- * will call it when loading textures, but does not provide its own image
- * loading backend.
- *
- * @param path     Filesystem path to the image file.
- * @param width    Output pointer to receive image width in pixels.
- * @param height   Output pointer to receive image height in pixels.
- * @param channels Output pointer to receive the number of color channels.
- *
- * @return Pointer to raw pixel data (heap-allocated). The exact format (e.g.
- *         RGB vs. RGBA) is determined by the user's implementation. Returns
- *         NULL if the image could not be loaded.
+ * @brief Blended morph deltas of every morphed mesh instance, in one GPU
+ * buffer.
  *
- * @note The returned memory must be freed with ::skr_free_image.
+ * Each instance owns two texels per vertex of its mesh: the position and
+ * normal deltas with every weighted target summed in. ::skr_morphs_update
+ * rebuilds an instance from the sparse deltas of its targets with a
+ * non-zero weight only, after clearing the vertices it touched before,
+ * and only the changed range is uploaded. Shaders add the deltas with
+ * `skr_morph`, or the skinning pre-pass applies them before skinning.
  */
-extern unsigned char* m_skr_load_image_from_file(const char* path, int* width,
-                                                 int* height, int* channels);
+typedef struct SkrMorphs {
+	vec4*        Deltas;   /*!< Two texels per vertex. */
+	unsigned int Count;    /*!< Vertices allocated. */
+	unsigned int Capacity; /*!< Vertices `Deltas` has room for. */
+
+	unsigned int DirtyBegin; /*!< First vertex to upload. */
+	unsigned int DirtyEnd;   /*!< One past the last vertex to upload. */
+
+	SkrMorphInstance* Instances;
+	unsigned int      InstanceCount;
+	unsigned int      InstanceCapacity;
+
+	union {
+		struct {
+			GLuint       Buffer;   /*!< GL_TEXTURE_BUFFER storage. */
+			GLuint       Texture;  /*!< RGBA32F view of `Buffer`. */
+			unsigned int Capacity; /*!< Vertices `Buffer` holds. */
+		} GL;
+	} Backend;
+} SkrMorphs;
 
 /**
- * @internal
- * @brief Free pixel memory previously allocated by
- * ::m_skr_load_image_from_file.
+ * @brief GLSL morph helper, pasted after a vertex shader's `#version`.
  *
- * This function **must be implemented by the user** of the engine to match the
- * allocation strategy used in their m_skr_load_image_from_file.
- *
- * @param image_data Pointer to the pixel data to free. Safe to pass NULL.
+ * Declares the delta sampler and `skr_morph_base` and defines
+ * `skr_morph(inout vec3 position, inout vec3 normal)`, which adds the
+ * renderable's blended deltas and leaves unmorphed draws untouched. Call
+ * it before `skr_skin_lbs`; the normal is not renormalized. Requires GLSL
+ * 1.40 or later.
  */
-extern void m_skr_free_image(unsigned char* image_data);
+#define SKR_MORPH_GLSL                                                         \
+	"uniform samplerBuffer skr_morphs;\n"                                 \
+	"uniform int skr_morph_base = -1;\n"                                  \
+	"void skr_morph(inout vec3 position, inout vec3 normal) {\n"          \
+	"  if (skr_morph_base < 0) return;\n"                                 \
+	"  int at = (skr_morph_base + gl_VertexID) * 2;\n"                    \
+	"  position += texelFetch(skr_morphs, at).xyz;\n"                     \
+	"  normal += texelFetch(skr_morphs, at + 1).xyz;\n"                   \
+	"}\n"
 
 /**
- * @internal
- * @brief Read a whole file into memory.
+ * @brief GLSL skinning helpers, pasted after a vertex shader's `#version`.
  *
- * Opens the file in binary mode, reads its contents into a null-terminated
+ * Declares the bone attributes (locations 6 and 7), the palette sampler
+ * and `skr_bone_base`, and defines `skr_skin_lbs(inout vec3 position,
+ * inout vec3 normal)` for linear-blend skinning and `skr_skin_dq` for
+ * dual-quaternion skinning. Rigid renderables and vertices are left
+ * untouched. Requires GLSL 1.40 or later.
+ */
+#define SKR_SKINNING_GLSL                                                      \
+	"layout (location = 6) in ivec4 aBoneIDs;\n"                          \
+	"layout (location = 7) in vec4 aBoneWeights;\n"                       \
+	"uniform samplerBuffer skr_bones;\n"                                  \
+	"uniform int skr_bone_base = -1;\n"                                   \
+	"vec4 skr_bone(int i, int row) {\n"                                   \
+	"  return texelFetch(skr_bones, (skr_bone_base + i) * 3 + row);\n"    \
+	"}\n"                                                                 \
+	"bool skr_rigid() {\n"                                                \
+	"  return skr_bone_base < 0 ||\n"                                     \
+	"         dot(aBoneWeights, vec4(1.0)) <= 0.0;\n"                     \
+	"}\n"                                                                 \
+	"void skr_skin_lbs(inout vec3 p, inout vec3 n) {\n"                   \
+	"  if (skr_rigid()) return;\n"                                        \
+	"  vec4 r0 = vec4(0.0), r1 = vec4(0.0), r2 = vec4(0.0);\n"            \
+	"  for (int i = 0; i < 4; ++i) {\n"                                   \
+	"    float w = aBoneWeights[i];\n"                                    \
+	"    r0 += w * skr_bone(aBoneIDs[i], 0);\n"                           \
+	"    r1 += w * skr_bone(aBoneIDs[i], 1);\n"                           \
+	"    r2 += w * skr_bone(aBoneIDs[i], 2);\n"                           \
+	"  }\n"                                                               \
+	"  vec4 h = vec4(p, 1.0), d = vec4(n, 0.0);\n"                        \
+	"  p = vec3(dot(r0, h), dot(r1, h), dot(r2, h));\n"                   \
+	"  n = normalize(vec3(dot(r0, d), dot(r1, d), dot(r2, d)));\n"        \
+	"}\n"                                                                 \
+	"void skr_skin_dq(inout vec3 p, inout vec3 n) {\n"                    \
+	"  if (skr_rigid()) return;\n"                                        \
+	"  vec4 q0 = skr_bone(aBoneIDs[0], 0);\n"                             \
+	"  vec4 r = vec4(0.0), t = vec4(0.0);\n"                              \
+	"  for (int i = 0; i < 4; ++i) {\n"                                   \
+	"    vec4 q = skr_bone(aBoneIDs[i], 0);\n"                            \
+	"    float w = aBoneWeights[i] * sign(dot(q, q0) + 1e-6);\n"          \
+	"    r += w * q;\n"                                                   \
+	"    t += w * skr_bone(aBoneIDs[i], 1);\n"                            \
+	"  }\n"                                                               \
+	"  float len = length(r);\n"                                          \
+	"  r /= len;\n"                                                       \
+	"  t /= len;\n"                                                       \
+	"  p += 2.0 * cross(r.xyz, cross(r.xyz, p) + r.w * p);\n"             \
+	"  p += 2.0 * (r.w * t.xyz - t.w * r.xyz + cross(r.xyz, t.xyz));\n"   \
+	"  n += 2.0 * cross(r.xyz, cross(r.xyz, n) + r.w * n);\n"             \
+	"}\n"
+
+/**
+ * @brief Local transform of one bone.
+ *
+ * Every member is a full vec4 so poses can be blended with vector loads.
+ */
+typedef struct SkrBonePose {
+	versor Rotation;
+	vec4   Translation; /*!< xyz, w unused. */
+	vec4   Scale;       /*!< xyz, w unused. */
+} SkrBonePose;
+
+/**
+ * @brief Number of animation LOD levels.
+ */
+#define SKR_ANIM_LODS 4
+
+/**
+ * @brief Bone hierarchy shared by every instance of a character.
+ *
+ * Bones are ordered so each parent precedes its children. Allocate with
+ * ::skr_skeleton_init to get arrays aligned for the matrix code.
+ */
+typedef struct SkrSkeleton {
+	unsigned int BoneCount;
+	int*         Parent;      /*!< Parent bone, -1 for roots. */
+	mat4*        InverseBind; /*!< Model space to bone space at bind. */
+	SkrBonePose* BindPose;    /*!< Local transforms at bind. */
+
+	/**
+	 * @brief Bone LOD remap tables, one per animation LOD, NULL for all
+	 * bones.
+	 *
+	 * `Remap[lod][b]` is `b` for an animated bone, or the animated
+	 * ancestor whose skinning matrix a dropped bone follows. Animated
+	 * bones must have animated parents. Not owned by the skeleton.
+	 */
+	const int* Remap[SKR_ANIM_LODS];
+} SkrSkeleton;
+
+/**
+ * @brief Track order within a bone, see SkrClip::Tracks.
+ */
+typedef enum SkrTrackType {
+	SKR_TRACK_TRANSLATION,
+	SKR_TRACK_ROTATION,
+	SKR_TRACK_SCALE,
+	SKR_TRACK_TYPES,
+} SkrTrackType;
+
+/**
+ * @brief Uncompressed keys of one track, input of ::skr_clip_build.
+ */
+typedef struct SkrTrackSource {
+	const float* Times;  /*!< Ascending key times in seconds. */
+	const float* Values; /*!< 4 floats (xyzw) per rotation key, else 3. */
+	unsigned int Count;  /*!< Keys, 0 to leave the bone's value alone. */
+} SkrTrackSource;
+
+/**
+ * @brief Quantized keyframe, 8 bytes.
+ *
+ * `Time` is a fraction of the clip duration in 1/65535 steps. Rotations use
+ * the smallest-three encoding: the three smaller quaternion components in
+ * 15 bits each and the index of the largest in the two top bits, 47 bits
+ * in all. Translations and scales store 16 bits per component within the
+ * track's range.
+ */
+typedef struct SkrKey {
+	uint16_t Time;
+	uint16_t Value[3];
+} SkrKey;
+
+/**
+ * @brief Keys of one track within SkrClip::Keys.
+ */
+typedef struct SkrTrack {
+	unsigned int First; /*!< Index of the first key. */
+	unsigned int Count; /*!< Number of keys. */
+	vec3         Min;   /*!< Value of quantized 0 (translation, scale). */
+	vec3         Step;  /*!< Value of one quantized unit. */
+} SkrTrack;
+
+/**
+ * @brief Compressed animation clip, built by ::skr_clip_build.
+ */
+typedef struct SkrClip {
+	float        Duration;  /*!< Length in seconds. */
+	unsigned int BoneCount;
+	SkrTrack*    Tracks;    /*!< ::SKR_TRACK_TYPES tracks per bone. */
+	SkrKey*      Keys;
+	unsigned int KeyCount;
+} SkrClip;
+
+/**
+ * @brief Per-instance playback position of a clip.
+ *
+ * Remembers the key each track was last sampled at, so playing forward
+ * only steps over the keys passed since the previous sample instead of
+ * searching the track.
+ */
+typedef struct SkrClipCursor {
+	float         Time; /*!< Time of the last sample. */
+	unsigned int* Key;  /*!< Current key of each track. */
+} SkrClipCursor;
+
+/**
+ * @brief One animation LOD level.
+ */
+typedef struct SkrAnimLod {
+	/**
+	 * @brief Smallest on-screen size using this level.
+	 *
+	 * Size is the bounding radius over the distance to the camera, so
+	 * roughly the fraction of the view height the character covers.
+	 */
+	float MinSize;
+
+	unsigned int Interval; /*!< Frames between samples, 0 freezes. */
+} SkrAnimLod;
+
+/**
+ * @brief Animated skeleton instances, one row each.
+ *
+ * Rows are updated by ::skr_animations_update at a rate picked from their
+ * screen size. Between samples their palette is interpolated towards a
+ * pose sampled ahead, so throttled characters still move every frame.
+ */
+typedef struct SkrAnimations {
+	unsigned int Count;    /*!< Number of rows. */
+	unsigned int Capacity; /*!< Allocated rows. */
+
+	SkrSkeleton**  Skeleton;
+	SkrClip**      Clip;
+	SkrClipCursor* Cursor;
+	float*         Time;       /*!< Playback position in the clip. */
+	float*         Speed;      /*!< Playback rate, 1 by default. */
+	int*           Palette;    /*!< First bone in SkrState::Skinning. */
+	SkrRenderable* Renderable; /*!< Bounds picking the LOD, or 0. */
+	unsigned char* Lod;        /*!< Level this frame, LODS if offscreen. */
+	unsigned int*  Age;        /*!< Frames since the last sample. */
+	unsigned int*  Interval;   /*!< Frames the last sample spans. */
+	unsigned int*  Frame;      /*!< Offset of the row's poses in Frames. */
+
+	/**
+	 * @brief Levels from most to least detailed.
+	 *
+	 * Zeroed levels take defaults when the first row is added.
+	 */
+	SkrAnimLod   Lods[SKR_ANIM_LODS];
+	unsigned int OffscreenInterval; /*!< Outside the frustum, 0 freezes. */
+
+	/**
+	 * @brief Sampling time allowed per frame in microseconds, 0 for none.
+	 *
+	 * Rows most overdue are sampled first; the rest keep interpolating
+	 * and are picked up on a later frame.
+	 */
+	float Budget;
+
+	unsigned int Sampled;  /*!< Rows sampled last update. */
+	unsigned int Deferred; /*!< Rows due but over budget. */
+	unsigned int Frozen;   /*!< Rows not animated. */
+
+	/**
+	 * @brief Palette rows blended from and to, two poses per row.
+	 *
+	 * Throttled rows show the pose at their last sample blending into
+	 * one sampled ahead by their interval.
+	 */
+	vec4*        Frames;
+	unsigned int FrameCount;    /*!< Used vec4s. */
+	unsigned int FrameCapacity; /*!< Allocated vec4s. */
+
+	uint64_t*    Queue;        /*!< Scratch: rows due, by priority. */
+	void*        Scratch;      /*!< Scratch: pose and model matrices. */
+	unsigned int ScratchBones; /*!< Bones Scratch holds. */
+} SkrAnimations;
+
+/**
+ * @brief Tagged union that wraps a backend window handle.
+ *
+ * Contains both the backend type (`Tag`) and the backend-specific handle
+ * (`Handler`). Only the member corresponding to the active backend type is
+ * valid.
+ */
+typedef struct SkrWindowBackend {
+	const SkrWindowBackendType Type; /*!< Backend type. */
+
+	union {
+		struct GLFWwindow* GLFW; /*!< Handle to a GLFW window. */
+		                         /* TODO: more backends */
+	} Handler;                       /*!< Backend-specific handle. */
+} SkrWindowBackend;
+
+struct SkrWindow;
+
+/**
+ * @brief Function type for input event callbacks.
+ */
+typedef void SkrInputHandler(struct SkrWindow* w);
+
+/**
+ * @brief Kind of a queued input event.
+ */
+typedef enum SkrInputEventType {
+	SKR_INPUT_KEY,          /*!< `Code` key, `Action` press/release. */
+	SKR_INPUT_MOUSE_BUTTON, /*!< `Code` button, `Action` press/release. */
+	SKR_INPUT_MOUSE_MOVE,   /*!< Cursor moved to `X`, `Y`. */
+	SKR_INPUT_SCROLL,       /*!< Scrolled by `X`, `Y`. */
+	SKR_INPUT_CHAR,         /*!< `Code` Unicode code point typed. */
+} SkrInputEventType;
+
+/**
+ * @brief Timestamped input event.
+ *
+ * Codes, actions and modifiers are those of the window backend.
+ */
+typedef struct SkrInputEvent {
+	double            Time; /*!< ::skr_clock_now when it was received. */
+	SkrInputEventType Type;
+
+	int Code;
+	int Action;
+	int Mods;
+
+	double X;
+	double Y;
+} SkrInputEvent;
+
+/**
+ * @brief Capacity of the input ring, a power of two.
+ */
+#ifndef SKR_INPUT_CAPACITY
+#define SKR_INPUT_CAPACITY 256
+#endif
+
+/**
+ * @brief Single-producer single-consumer input event ring.
+ *
+ * Window callbacks push from the thread that pumps events, the simulation
+ * pops, without locks. `Head` and `Tail` sit on separate cache lines so the
+ * two sides don't contend.
+ */
+typedef struct SkrInput {
+	SkrInputEvent Events[SKR_INPUT_CAPACITY];
+
+	SKR_ALIGNAS(64) SkrAtomicUint Head; /*!< Next slot to write. */
+	SKR_ALIGNAS(64) SkrAtomicUint Tail; /*!< Next slot to read. */
+	SkrAtomicUint Dropped;              /*!< Events lost to a full ring. */
+
+	/**
+	 * @brief Use unaccelerated mouse motion while the cursor is captured.
+	 */
+	bool RawMotion;
+
+	double CursorX; /*!< Cursor position at the last sample. */
+	double CursorY;
+	bool   Sampled; /*!< `CursorX`/`CursorY` hold a sample. */
+} SkrInput;
+
+/**
+ * @brief Generic engine window.
+ *
+ * A portable window structure that abstracts over different windowing backends.
+ * Encapsulates title, size, optional input handler, and backend data.
+ */
+typedef struct SkrWindow {
+	char* Title;  /*!< Window title (UTF-8 string). */
+	int   Width;  /*!< Width of the window in pixels. */
+	int   Height; /*!< Height of the window in pixels. */
+
+	SkrInputHandler* InputHandler; /*!< Pointer to input handler. */
+	SkrWindowBackend Backend;      /*!< Backend type and handle. */
+
+	bool Debug; /*!< Request a debug context and driver messages. */
+
+	SkrInput Input; /*!< Events received from the window backend. */
+} SkrWindow;
+
+/**
+ * @brief First-person camera structure.
+ *
+ * Stores position, orientation, and field-of-view.
+ * Can be controlled by mouse and keyboard input.
+ */
+typedef struct SkrCamera {
+	vec3 Position; /*!< Camera position in world space. */
+	vec3 Front;    /*!< Normalized forward vector. */
+	vec3 Up;       /*!< Normalized up vector. */
+	vec3 Right;    /*!< Normalized right vector. */
+	vec3 WorldUp;  /*!< Global up direction, usually {0, 1, 0}. */
+
+	float Yaw;
+	float Pitch;
+	float FOV;
+	float Zoom;
+
+	float Sensitivity;
+	float Speed;
+
+	float Near; /*!< Near plane distance, 0 for 0.1. The far plane is at
+	                 infinity. */
+} SkrCamera;
+
+/**
+ * @brief Uniform block binding of the per-frame `SkrFrame` block.
+ *
+ * Shaders may declare, with std140 layout:
+ *
+ *     layout(std140) uniform SkrFrame {
+ *         mat4 View;
+ *         mat4 Projection;
+ *         mat4 ViewProjection;
+ *         vec4 CameraPosition;
+ *     };
+ */
+#ifndef SKR_FRAME_BINDING
+#define SKR_FRAME_BINDING 0
+#endif
+
+/**
+ * @brief Matrices and frustum derived from a camera.
+ *
+ * Built by ::skr_view_update, which only recomputes them when the camera or
+ * aspect ratio changed, so culling, LOD selection and uniform uploads can
+ * share one set per frame.
+ */
+typedef struct SkrView {
+	mat4 View;
+	mat4 Projection;
+	mat4 ViewProjection;
+	mat4 InverseView;
+	mat4 InverseViewProjection;
+
+	vec4 Planes[6]; /*!< Frustum planes, normals pointing inside. */
+	vec3 Position;  /*!< Eye position in world space. */
+
+	/**
+	 * @brief Sub-pixel offset added to clip space, in NDC units.
+	 *
+	 * Shifts `Projection` and the matrices built from it; culling planes
+	 * and `Unjittered` ignore it. Clear `Valid` after changing it.
+	 */
+	vec2 Jitter;
+	mat4 Unjittered; /*!< ViewProjection without `Jitter`. */
+
+	/**
+	 * @brief Depth is 1 at the near plane and 0 at infinity.
+	 *
+	 * Chosen by the renderer when the API can map clip depth to [0, 1],
+	 * which keeps float depth precision roughly uniform with distance.
+	 */
+	bool ReverseZ;
+
+	bool          Valid;   /*!< Matrices match `Source`; clear to force. */
+	unsigned long Version; /*!< Incremented on each recompute. */
+	float         Aspect;  /*!< Aspect ratio the matrices were built for. */
+	SkrCamera     Source;  /*!< Camera the matrices were built from. */
+
+	union {
+		struct {
+			GLuint        Buffer;  /*!< `SkrFrame` uniform buffer. */
+			unsigned long Version; /*!< View version uploaded. */
+		} GL;
+	} Backend;
+} SkrView;
+
+/**
+ * @internal
+ * @brief Stringify a macro's value, for building GLSL sources.
+ */
+#define M_SKR_STR_(x) #x
+#define M_SKR_STR(x) M_SKR_STR_(x)
+
+/**
+ * @brief Light clusters along the view x and y axes and depth.
+ *
+ * Depth slices are spaced exponentially from the near plane to
+ * SkrLights::Far, so clusters stay roughly cubic; the last slice runs to
+ * infinity.
+ */
+#ifndef SKR_CLUSTER_X
+#define SKR_CLUSTER_X 16
+#endif
+#ifndef SKR_CLUSTER_Y
+#define SKR_CLUSTER_Y 9
+#endif
+#ifndef SKR_CLUSTER_Z
+#define SKR_CLUSTER_Z 24
+#endif
+#define SKR_CLUSTERS (SKR_CLUSTER_X * SKR_CLUSTER_Y * SKR_CLUSTER_Z)
+
+/**
+ * @brief Texture units of the light, cluster grid and light index buffer
+ * textures.
+ */
+#ifndef SKR_LIGHTS_UNIT
+#define SKR_LIGHTS_UNIT 13
+#endif
+#ifndef SKR_LIGHT_GRID_UNIT
+#define SKR_LIGHT_GRID_UNIT 12
+#endif
+#ifndef SKR_LIGHT_INDEX_UNIT
+#define SKR_LIGHT_INDEX_UNIT 11
+#endif
+
+/**
+ * @brief Uniform block binding of the `SkrClusters` block of
+ * ::SKR_LIGHTING_GLSL.
+ */
+#ifndef SKR_CLUSTER_BINDING
+#define SKR_CLUSTER_BINDING 1
+#endif
+
+/**
+ * @brief Point light, two texels in the light buffer.
+ */
+typedef struct SkrPointLight {
+	vec4 Position; /*!< World position, w is the radius of influence. */
+	vec4 Color;    /*!< Linear color, w is the intensity. */
+} SkrPointLight;
+
+/**
+ * @brief Point lights binned into view-space clusters.
+ *
+ * ::skr_lights_bin assigns every light to the clusters its sphere
+ * overlaps, then each cluster's lights are stored contiguously in
+ * `Indices`. Fragment shaders look up their cluster with
+ * `skr_lighting` and only loop over its lights, so thousands of small
+ * lights cost about as much per pixel as the few that reach it.
+ */
+typedef struct SkrLights {
+	SkrPointLight* Points;   /*!< Lights, written freely between frames. */
+	unsigned int   Count;    /*!< Number of lights. */
+	unsigned int   Capacity; /*!< Allocated lights. */
+
+	float Far; /*!< Depth of the last slice boundary, 0 for 500. */
+
+	unsigned int* Grid;    /*!< First index and count per cluster. */
+	unsigned int* Indices; /*!< Light indices grouped by cluster. */
+	unsigned int  IndexCount;
+	unsigned int  IndexCapacity;
+	unsigned int* Ranges;  /*!< Scratch: cluster bounds per light. */
+
+	float Near;  /*!< Near plane the grid was built for. */
+	float Scale; /*!< Slices per unit of log depth. */
+
+	union {
+		struct {
+			GLuint       Buffers[3];  /*!< Lights, grid, indices. */
+			GLuint       Textures[3]; /*!< Views of `Buffers`. */
+			unsigned int Capacity[2]; /*!< Lights, indices held. */
+			GLuint       Block;       /*!< `SkrClusters` buffer. */
+		} GL;
+	} Backend;
+} SkrLights;
+
+/**
+ * @brief How SkrRendererRender shades the scene.
+ */
+typedef enum SkrRenderPath {
+	SKR_RENDER_FORWARD,  /*!< Each material shades its own fragments. */
+	SKR_RENDER_DEFERRED, /*!< Materials fill a G-buffer, lit once. */
+} SkrRenderPath;
+
+/**
+ * @brief Compact G-buffer of the deferred path, 12 bytes per pixel.
+ *
+ * Materials write it through ::SKR_GBUFFER_GLSL: RGBA8 albedo and
+ * metallic, RGB10_A2 octahedral normal and roughness, and 32-bit float
+ * depth. A single fullscreen pass then reconstructs each position from
+ * depth and lights it from SkrState::Lights, so lighting costs the same
+ * per pixel whatever the geometry. The targets are transient resources of
+ * SkrState::Graph, sized to the viewport.
+ */
+typedef struct SkrGBuffer {
+	int Targets[3]; /*!< Albedo, normal and depth in SkrState::Graph. */
+
+	SkrShaderProgram Resolve; /*!< Fullscreen lighting pass. */
+
+	union {
+		struct {
+			GLuint VAO; /*!< Empty, for the resolve. */
+			GLint  InverseViewProjection; /*!< Uniform location. */
+			GLint  Depth; /*!< Location of `skr_depth`. */
+		} GL;
+	} Backend;
+} SkrGBuffer;
+
+/**
+ * @brief Depth-only drawing, shared by the depth pre-pass and shadow maps.
+ */
+typedef struct SkrDepthPass {
+	/**
+	 * @brief Lay down the depth of renderables before shading them.
+	 *
+	 * Renderables are first drawn from their position-only stream, then
+	 * shaded with GL_EQUAL depth testing and depth writes off, so their
+	 * fragment shaders run about once per pixel. Materials must compute
+	 * `gl_Position` as ::skr_lit_3d_vert does. Renderables deformed by
+	 * their material's vertex shader are shaded with the usual test.
+	 */
+	bool Prepass;
+
+	union {
+		struct {
+			GLuint Program;
+			GLint  Matrix; /*!< Location of `skr_depth_matrix`. */
+			GLint  Model;  /*!< Location of `model`. */
+
+			/* Variant skinning and morphing shadow casters. */
+			GLuint Deform;       /*!< 0 if unavailable. */
+			GLint  DeformMatrix; /*!< `skr_depth_matrix`. */
+			GLint  DeformModel;  /*!< `model`. */
+			GLint  DeformBone;   /*!< `skr_bone_base`. */
+			GLint  DeformMorph;  /*!< `skr_morph_base`. */
+		} GL;
+	} Backend;
+} SkrDepthPass;
+
+/**
+ * @brief Number of shadow cascades, fixed by the `SkrShadows` block.
+ */
+#define SKR_CASCADES 4
+
+/**
+ * @brief Texture unit of the cascaded shadow map.
+ */
+#ifndef SKR_SHADOW_UNIT
+#define SKR_SHADOW_UNIT 10
+#endif
+
+/**
+ * @brief Uniform block binding of the `SkrShadows` block of
+ * ::SKR_SHADOW_GLSL.
+ */
+#ifndef SKR_SHADOW_BINDING
+#define SKR_SHADOW_BINDING 2
+#endif
+
+/**
+ * @brief One slice of the view frustum and the shadow map layer covering
+ * it.
+ */
+typedef struct SkrCascade {
+	mat4  Matrix; /*!< World to shadow clip space, depth in [-1, 1]. */
+	float Far;    /*!< View depth the cascade ends at. */
+	float Radius; /*!< Radius of the sphere it covers. */
+	float Texel;  /*!< World size of a shadow map texel. */
+
+	bool Cached; /*!< Static casters only, kept across frames. */
+	bool Dirty;  /*!< Needs rendering this frame. */
+	bool Valid;  /*!< The layer holds `Rendered`, if cached. */
+	mat4 Rendered; /*!< `Matrix` the layer was last rendered with. */
+
+	unsigned int* Casters; /*!< Renderables to draw, when `Dirty`. */
+	unsigned int  CasterCount;
+	unsigned int  CasterCapacity;
+} SkrCascade;
+
+/**
+ * @brief Directional light with cascaded shadow maps.
+ *
+ * ::skr_shadows_update splits the view depth up to `Distance` into
+ * cascades, each covering a bounding sphere of its slice. The sphere only
+ * depends on the projection, and its center is snapped to shadow map
+ * texels in light space, so shadow edges do not shimmer as the camera
+ * turns or moves.
+ *
+ * Cascades from `Static` on are cached: they hold renderables flagged
+ * SKR_RENDERABLE_STATIC only, are fitted with a margin and snapped to a
+ * coarse grid, and are only redrawn when the camera leaves the margin,
+ * the light turns, or ::skr_shadows_invalidate is called after static
+ * geometry changes. Moving casters therefore only shadow the near
+ * cascades.
+ */
+typedef struct SkrShadows {
+	vec3 Direction; /*!< Direction the light travels, zero for none. */
+	vec3 Color;     /*!< Linear color times intensity. */
+
+	unsigned int Size;         /*!< Shadow map resolution, 0 for 2048. */
+	unsigned int CascadeCount; /*!< Cascades used, 0 for SKR_CASCADES. */
+	unsigned int Static; /*!< First cached cascade, 0 for half of them. */
+	float        Distance; /*!< Shadowed view depth, 0 for 100. */
+	float        Lambda;   /*!< Log to uniform split blend, 0 for 0.75. */
+
+	unsigned int Count; /*!< Cascades fitted by the last update. */
+
+	SkrCascade Cascades[SKR_CASCADES];
+
+	union {
+		struct {
+			GLuint Texture; /*!< Depth array, a layer per cascade. */
+			GLuint FBO;
+			GLuint Block; /*!< `SkrShadows` buffer. */
+			unsigned int Size;   /*!< Resolution allocated. */
+			unsigned int Layers; /*!< Layers allocated. */
+		} GL;
+	} Backend;
+} SkrShadows;
+
+/**
+ * @brief Maximum reads, and writes, of a render graph pass.
+ */
+#define SKR_GRAPH_SLOTS 8
+
+/**
+ * @brief Pixel format of a transient render graph resource.
+ */
+typedef enum SkrFormat {
+	SKR_FORMAT_RGBA8,    /*!< 8-bit normalized color. */
+	SKR_FORMAT_RGB10_A2, /*!< 10-bit normalized color, 2-bit alpha. */
+	SKR_FORMAT_RGBA16F,  /*!< Half float color. */
+	SKR_FORMAT_RG16F,    /*!< Half float pair. */
+	SKR_FORMAT_DEPTH32F, /*!< Float depth. */
+} SkrFormat;
+
+struct SkrState;
+struct SkrGraph;
+
+/**
+ * @brief Records the commands of a render graph pass.
+ *
+ * Called with the framebuffer of the pass's writes bound, and with the
+ * texture of every resource in SkrGraphResource::Backend.
+ */
+typedef void SkrGraphFunc(struct SkrState* s, const struct SkrGraph* g,
+                          void* user);
+
+/**
+ * @brief Render target read or written by render graph passes.
+ *
+ * Transient resources only live during the frame. Their memory comes from
+ * SkrGraph::Targets, shared between resources whose lifetimes do not
+ * overlap. Imported resources are owned outside of the graph, and writing
+ * one is what makes a pass worth running.
+ */
+typedef struct SkrGraphResource {
+	const char* Name;
+	SkrFormat   Format; /*!< Transient format. */
+	int         Width;  /*!< Size, 0 if imported at viewport size. */
+	int         Height;
+	bool        Imported;
+
+	int First;  /*!< Position of the first pass using it, -1 if none. */
+	int Last;   /*!< Position of the last pass using it. */
+	int Target; /*!< Index in SkrGraph::Targets, -1 if none. */
+
+	union {
+		struct {
+			GLuint Texture; /*!< Set on import, or at execution. */
+			GLuint FBO;     /*!< Framebuffer of an imported one. */
+		} GL;
+	} Backend;
+} SkrGraphResource;
+
+/**
+ * @brief Render graph pass, declared with ::skr_graph_pass.
+ */
+typedef struct SkrGraphPass {
+	const char*   Name;
+	SkrGraphFunc* Execute;
+	void*         User;
+
+	unsigned int Reads[SKR_GRAPH_SLOTS];  /*!< Sampled resources. */
+	unsigned int Writes[SKR_GRAPH_SLOTS]; /*!< Attached resources. */
+	unsigned int ReadCount;
+	unsigned int WriteCount;
+
+	bool SideEffects; /*!< Never culled. */
+
+	int          Position; /*!< Index in SkrGraph::Order, -1 if culled. */
+	unsigned int Pending;  /*!< Unscheduled dependencies while ordering. */
+} SkrGraphPass;
+
+/**
+ * @brief Memory backing one or more transient resources.
+ *
+ * Kept across frames so an unchanged graph reuses the same textures.
+ */
+typedef struct SkrGraphTarget {
+	SkrFormat Format;
+	int       Width; /*!< 0 once released. */
+	int       Height;
+	int       Free; /*!< Position after which it can be shared again. */
+	bool      Used; /*!< Backs a resource of the compiled graph. */
+
+	union {
+		struct {
+			GLuint Texture;
+		} GL;
+	} Backend;
+} SkrGraphTarget;
+
+/**
+ * @brief Cached framebuffer over a set of SkrGraph::Targets.
+ */
+typedef struct SkrGraphFramebuffer {
+	unsigned int Targets[SKR_GRAPH_SLOTS];
+	unsigned int Count;
+
+	union {
+		struct {
+			GLuint FBO;
+		} GL;
+	} Backend;
+} SkrGraphFramebuffer;
+
+/**
+ * @brief Frame graph: passes declare the resources they read and write,
+ * and ::skr_graph_compile derives the rest.
+ *
+ * Passes writing nothing that is imported or read by a kept pass are
+ * culled. The others are ordered after the passes they depend on,
+ * preferring to keep passes writing the same targets together so each
+ * framebuffer is bound once. Transient resources are then packed into as
+ * few SkrGraph::Targets as their lifetimes allow.
+ *
+ * Dependencies follow declaration order: a pass reads the contents left
+ * by the last pass declared before it that writes the resource.
+ */
+typedef struct SkrGraph {
+	SkrGraphPass* Passes;
+	unsigned int  PassCount;
+	unsigned int  PassCapacity;
+
+	SkrGraphResource* Resources;
+	unsigned int      ResourceCount;
+	unsigned int      ResourceCapacity;
+
+	unsigned int* Order; /*!< Passes to run, in order. */
+	unsigned int  OrderCount;
+
+	unsigned int* Edges; /*!< Dependency pairs, before then after. */
+	unsigned int  EdgeCount;
+	unsigned int  EdgeCapacity;
+
+	SkrGraphTarget* Targets;
+	unsigned int    TargetCount;
+	unsigned int    TargetCapacity;
+
+	SkrGraphFramebuffer* Framebuffers;
+	unsigned int         FramebufferCount;
+	unsigned int         FramebufferCapacity;
+
+	unsigned int Binds; /*!< Framebuffers bound by the last execution. */
+} SkrGraph;
+
+/**
+ * @brief Timer queries in flight, read back this many frames later.
+ */
+#define SKR_RESOLUTION_QUERIES 4
+
+/**
+ * @brief Dynamic resolution driven by GPU frame time.
+ *
+ * When enabled, the scene is rendered offscreen at `Scale` times the
+ * viewport size and upscaled into it. The GPU time of each frame is
+ * measured with timer queries and fed to ::skr_resolution_update, which
+ * drops the scale at once when a frame goes over `Budget` and raises it
+ * one step at a time once frames have stayed well under it. Scales are
+ * multiples of `Step`, so targets are only reallocated on a change.
+ */
+typedef struct SkrResolution {
+	bool   Enabled;
+	double Budget;   /*!< GPU seconds per frame, 0 for 1/60. */
+	float  MinScale; /*!< Lowest scale per axis, 0 for 0.5. */
+	float  MaxScale; /*!< Highest scale per axis, 0 for 1. */
+	float  Step;     /*!< Scale granularity, 0 for 0.05. */
+
+	float        Scale;   /*!< Scale of the next frames. */
+	double       GpuTime; /*!< Last GPU time measured, in seconds. */
+	unsigned int Calm;    /*!< Frames in a row with room to grow. */
+	int          Width;   /*!< Scene size of the last frame. */
+	int          Height;
+
+	union {
+		struct {
+			GLuint       Queries[SKR_RESOLUTION_QUERIES];
+			bool         Pending[SKR_RESOLUTION_QUERIES];
+			unsigned int Next; /*!< Query of the next frame. */
+			GLuint       Program; /*!< Bilinear upscale. */
+			GLuint       VAO;     /*!< Empty, for the upscale. */
+		} GL;
+	} Backend;
+} SkrResolution;
+
+/**
+ * @brief Temporal anti-aliasing and upsampling.
+ *
+ * When enabled, the projection is offset by a different sub-pixel jitter
+ * each frame and a velocity buffer records the screen motion of every
+ * pixel. The scene is then resolved into a history at viewport size by
+ * reprojecting last frame's history, clamping it to the colors around the
+ * pixel and blending it with the new sample, which also reconstructs the
+ * full size image when SkrResolution renders the scene smaller.
+ */
+typedef struct SkrTemporal {
+	bool         Enabled;
+	float        Feedback; /*!< History weight, 0 for 0.9. */
+	unsigned int Samples;  /*!< Jitter sequence length, 0 for 8. */
+
+	unsigned int Index;  /*!< Frames jittered so far. */
+	vec2         Jitter; /*!< Offset of this frame, in scene pixels. */
+	bool         Valid;  /*!< Previous matrices and history usable. */
+	mat4         PreviousViewProjection; /*!< Unjittered, last frame. */
+	int          Targets[4]; /*!< Color, velocity, depth, history. */
+
+	union {
+		struct {
+			GLuint       History[2]; /*!< Resolved frames. */
+			GLuint       FBO[2];
+			unsigned int Current; /*!< History written last. */
+			int          Width;   /*!< Size of the history. */
+			int          Height;
+
+			GLuint Velocity; /*!< Per-object motion program. */
+			GLint  Matrix;   /*!< Jittered view-projection. */
+			GLint  Model;
+			GLint  Unjittered;
+			GLint  Previous; /*!< PreviousViewProjection. */
+			GLint  PreviousModel;
+
+			GLuint Resolve; /*!< History resolve program. */
+			GLint  Reproject;
+			GLint  Offset;
+			GLint  DepthScale;
+			GLint  Weight;
+		} GL;
+	} Backend;
+} SkrTemporal;
+
+/**
+ * @brief Effects of SkrPost, applied in this order.
+ */
+typedef enum SkrPostFlags {
+	SKR_POST_BLOOM = 1 << 0,    /*!< Glow over SkrPost::Threshold. */
+	SKR_POST_TONEMAP = 1 << 1,  /*!< ACES filmic curve after exposure. */
+	SKR_POST_GRADE = 1 << 2,    /*!< Color grading through SkrPost::Lut. */
+	SKR_POST_VIGNETTE = 1 << 3, /*!< Darkened corners. */
+	SKR_POST_FXAA = 1 << 4,     /*!< Edge anti-aliasing. */
+} SkrPostFlags;
+
+/**
+ * @brief Most bloom mip levels.
+ */
+#ifndef SKR_BLOOM_LEVELS
+#define SKR_BLOOM_LEVELS 8
+#endif
+
+/**
+ * @internal
+ * @brief Fused post programs: every combination of SkrPostFlags, and a
+ * bit for writing luma for FXAA.
+ */
+#define M_SKR_POST_LUMA (1u << 5)
+#define M_SKR_POST_VARIANTS 64
+
+/**
+ * @brief Post-processing of the frame.
+ *
+ * With any flag set, the scene is shaded into a half-float target and
+ * presented through one full-screen pass that adds bloom, tonemaps,
+ * grades and vignettes in a program generated for the enabled flags.
+ * FXAA needs its neighbors final, so it runs in a second pass that also
+ * takes the vignette. Bloom is a mip chain: each level halves the one
+ * above it, then levels are upsampled with a tent filter and added back
+ * from the smallest, which spreads glow widely with a few small taps.
+ */
+typedef struct SkrPost {
+	unsigned int Flags;     /*!< ::SkrPostFlags. */
+	float        Exposure;  /*!< Scene color multiplier, 0 for 1. */
+	float        Threshold; /*!< Bloom brightness threshold, 0 for 1. */
+	float        Intensity; /*!< Bloom added to the scene, 0 for 0.05. */
+	unsigned int Levels;    /*!< Bloom mips, 0 for 5. */
+	float        Vignette;  /*!< Darkening at the corners, 0 for 0.3. */
+
+	/**
+	 * @brief Grading LUT: `LutSize` slices of `LutSize` squared texels
+	 * side by side, blue picking the slice, red and green within it. See
+	 * ::skr_lut_identity.
+	 */
+	SkrTexture   Lut;
+	unsigned int LutSize; /*!< 0 for 16. */
+
+	int Source; /*!< Graph resource presented. */
+	int Bloom;  /*!< Largest bloom level, -1 if none. */
+	int Color;  /*!< Graph resource FXAA reads. */
+
+	union {
+		struct {
+			GLuint Programs[M_SKR_POST_VARIANTS]; /*!< By key. */
+			GLint  Params[M_SKR_POST_VARIANTS];
+			GLuint Downsample; /*!< Bloom prefilter, downsample. */
+			GLint  Threshold;
+			GLuint Upsample; /*!< Bloom tent upsample. */
+			GLuint VAO;      /*!< Empty, for full-screen passes. */
+		} GL;
+	} Backend;
+} SkrPost;
+
+/**
+ * @brief GLSL clustered lighting helper, pasted into a fragment shader
+ * after its `#version`.
+ *
+ * Defines `vec3 skr_lighting(vec3 position, vec3 normal, vec3 albedo)`,
+ * the diffuse light reaching a world-space surface from the lights of the
+ * fragment's cluster, with a smooth falloff to zero at each radius.
+ * `skr_lighting_at` takes the window position and view depth explicitly,
+ * for passes that light a surface other than the one being rasterized.
+ * Requires GLSL 1.40 and a perspective projection.
+ */
+#define SKR_LIGHTING_GLSL                                                      \
+	"uniform samplerBuffer skr_lights;\n"                                 \
+	"uniform usamplerBuffer skr_light_grid;\n"                            \
+	"uniform usamplerBuffer skr_light_indices;\n"                         \
+	"layout(std140) uniform SkrClusters {\n"                              \
+	"  vec4 skr_cluster;\n" /* viewport size, near, scale */              \
+	"};\n"                                                                \
+	"vec3 skr_lighting_at(vec3 position, vec3 normal, vec3 albedo,\n"     \
+	"                     vec2 frag, float depth) {\n"                    \
+	"  const ivec3 dim = ivec3(" M_SKR_STR(SKR_CLUSTER_X) ", "            \
+	M_SKR_STR(SKR_CLUSTER_Y) ", " M_SKR_STR(SKR_CLUSTER_Z) ");\n"         \
+	"  ivec2 tile = ivec2(frag / skr_cluster.xy * "                       \
+	"vec2(dim.xy));\n"                                                    \
+	"  int slice = int(log(max(depth / skr_cluster.z, 1.0)) * "           \
+	"skr_cluster.w);\n"                                                   \
+	"  tile = clamp(tile, ivec2(0), dim.xy - 1);\n"                       \
+	"  slice = clamp(slice, 0, dim.z - 1);\n"                             \
+	"  int c = (slice * dim.y + tile.y) * dim.x + tile.x;\n"              \
+	"  uvec2 cell = texelFetch(skr_light_grid, c).xy;\n"                  \
+	"  vec3 n = normalize(normal), sum = vec3(0.0);\n"                    \
+	"  for (uint i = cell.x; i < cell.x + cell.y; ++i) {\n"               \
+	"    int l = int(texelFetch(skr_light_indices, int(i)).x) * 2;\n"     \
+	"    vec4 p = texelFetch(skr_lights, l);\n"                           \
+	"    vec4 color = texelFetch(skr_lights, l + 1);\n"                   \
+	"    vec3 to = p.xyz - position;\n"                                   \
+	"    float d2 = dot(to, to);\n"                                       \
+	"    float f = clamp(1.0 - d2 * d2 / (p.w * p.w * p.w * p.w), 0.0, "  \
+	"1.0);\n"                                                             \
+	"    vec3 dir = to * inversesqrt(max(d2, 1e-8));\n"                   \
+	"    float ndl = max(dot(n, dir), 0.0);\n"                            \
+	"    sum += color.rgb * (color.w * ndl * f * f / (d2 + 1.0));\n"      \
+	"  }\n"                                                               \
+	"  return sum * albedo;\n"                                            \
+	"}\n"                                                                 \
+	"vec3 skr_lighting(vec3 position, vec3 normal, vec3 albedo) {\n"      \
+	"  return skr_lighting_at(position, normal, albedo,\n"                \
+	"                         gl_FragCoord.xy, 1.0 / gl_FragCoord.w);\n"  \
+	"}\n"
+
+/**
+ * @brief GLSL sun light and cascaded shadow lookup, pasted into a
+ * fragment shader after its `#version`.
+ *
+ * Defines `float skr_shadow(vec3 position, vec3 normal, float depth)`,
+ * the fraction of SkrState::Shadows light reaching a world-space surface
+ * at view depth `depth` (1 past the last cascade), and
+ * `vec3 skr_sun(vec3 position, vec3 normal, vec3 albedo, float depth)`,
+ * its shadowed diffuse light. Lookups are offset along the normal by a
+ * texel and filtered 2x2 by the depth comparison.
+ */
+#define SKR_SHADOW_GLSL                                                        \
+	"uniform sampler2DArrayShadow skr_shadow_map;\n"                      \
+	"layout(std140) uniform SkrShadows {\n"                               \
+	"  mat4 skr_shadow_matrices[4];\n"                                    \
+	"  vec4 skr_shadow_splits;\n"                                         \
+	"  vec4 skr_shadow_texels;\n"                                         \
+	"  vec4 skr_sun_direction;\n" /* w: cascade count */                  \
+	"  vec4 skr_sun_color;\n"                                             \
+	"};\n"                                                                \
+	"float skr_shadow(vec3 position, vec3 normal, float depth) {\n"       \
+	"  int count = int(skr_sun_direction.w);\n"                           \
+	"  int c = 0;\n"                                                      \
+	"  while (c < count && depth > skr_shadow_splits[c]) ++c;\n"          \
+	"  if (c == count) return 1.0;\n"                                     \
+	"  vec3 p = position + normalize(normal) * skr_shadow_texels[c];\n"   \
+	"  vec4 s = skr_shadow_matrices[c] * vec4(p, 1.0);\n"                 \
+	"  return texture(skr_shadow_map, vec4(s.xy, float(c), s.z));\n"      \
+	"}\n"                                                                 \
+	"vec3 skr_sun(vec3 position, vec3 normal, vec3 albedo,\n"             \
+	"             float depth) {\n"                                       \
+	"  float ndl = max(dot(normalize(normal), -skr_sun_direction.xyz), "  \
+	"0.0);\n"                                                             \
+	"  if (ndl == 0.0 || skr_sun_color.rgb == vec3(0.0))\n"               \
+	"    return vec3(0.0);\n"                                             \
+	"  return skr_sun_color.rgb * albedo * ndl *\n"                       \
+	"         skr_shadow(position, normal, depth);\n"                     \
+	"}\n"
+
+static const char* const skr_camera_3d_vert =
+        "#version 330 core\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "layout (location = 1) in vec2 aTexCoord;\n"
+        "out vec2 TexCoord;\n"
+        "uniform mat4 model;\n"
+        "uniform mat4 view;\n"
+        "uniform mat4 projection;\n"
+        "void main() {\n"
+        "gl_Position = projection * view * model * vec4(aPos, "
+        "1.0f);\n"
+        "TexCoord = vec2(aTexCoord.x, aTexCoord.y);\n"
+        "}\n";
+
+/**
+ * @brief Vertex shader for ::skr_lit_frag, reading SkrVertex attributes
+ * and the `SkrFrame` block.
+ */
+static const char* const skr_lit_3d_vert =
+        "#version 330 core\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "layout (location = 1) in vec3 aNormal;\n"
+        "layout (location = 2) in vec2 aTexCoord;\n"
+        "layout(std140) uniform SkrFrame {\n"
+        "  mat4 View;\n"
+        "  mat4 Projection;\n"
+        "  mat4 ViewProjection;\n"
+        "  vec4 CameraPosition;\n"
+        "};\n"
+        "uniform mat4 model;\n"
+        "invariant gl_Position;\n"
+        "out vec3 WorldPos;\n"
+        "out vec3 Normal;\n"
+        "out vec2 TexCoord;\n"
+        "void main() {\n"
+        "  vec4 world = model * vec4(aPos, 1.0);\n"
+        "  WorldPos = world.xyz;\n"
+        "  Normal = mat3(model) * aNormal;\n"
+        "  TexCoord = aTexCoord;\n"
+        "  gl_Position = ViewProjection * world;\n"
+        "}\n";
+
+/**
+ * @brief Diffuse fragment shader lit by SkrState::Lights and the shadowed
+ * sun of SkrState::Shadows, albedo from the texture on unit 0.
+ */
+static const char* const skr_lit_frag =
+        "#version 330 core\n" SKR_LIGHTING_GLSL SKR_SHADOW_GLSL
+        "in vec3 WorldPos;\n"
+        "in vec3 Normal;\n"
+        "in vec2 TexCoord;\n"
+        "out vec4 FragColor;\n"
+        "uniform sampler2D skr_albedo;\n"
+        "void main() {\n"
+        "  vec4 albedo = texture(skr_albedo, TexCoord);\n"
+        "  vec3 light = skr_lighting(WorldPos, Normal, albedo.rgb) +\n"
+        "               skr_sun(WorldPos, Normal, albedo.rgb, "
+        "1.0 / gl_FragCoord.w);\n"
+        "  FragColor = vec4(albedo.rgb * 0.03 + light, albedo.a);\n"
+        "}\n";
+
+/**
+ * @brief GLSL G-buffer outputs, pasted into a fragment shader after its
+ * `#version` for SKR_RENDER_DEFERRED.
+ *
+ * Defines `void skr_gbuffer_write(vec3 albedo, vec3 normal,
+ * float roughness, float metallic)` with a world-space normal, replacing
+ * the shader's color output.
+ */
+#define SKR_GBUFFER_GLSL                                                       \
+	"layout(location = 0) out vec4 skr_gbuffer0;\n"                       \
+	"layout(location = 1) out vec4 skr_gbuffer1;\n"                       \
+	"vec2 skr_oct_encode(vec3 n) {\n"                                     \
+	"  n /= abs(n.x) + abs(n.y) + abs(n.z);\n"                            \
+	"  vec2 s = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);\n"\
+	"  vec2 e = n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * s;\n"             \
+	"  return e * 0.5 + 0.5;\n"                                           \
+	"}\n"                                                                 \
+	"void skr_gbuffer_write(vec3 albedo, vec3 normal, float roughness,\n" \
+	"                       float metallic) {\n"                          \
+	"  skr_gbuffer0 = vec4(albedo, metallic);\n"                          \
+	"  skr_gbuffer1 = vec4(skr_oct_encode(normalize(normal)), "           \
+	"roughness, 1.0);\n"                                                  \
+	"}\n"
+
+/**
+ * @brief GLSL weighted blended outputs, pasted into a fragment shader
+ * after its `#version` for SKR_TRANSPARENCY_WEIGHTED.
+ *
+ * Defines `void skr_oit_write(vec4 color)` with straight alpha, replacing
+ * the shader's color output. Nearer fragments weigh more, so the front
+ * layers dominate the average.
+ */
+#define SKR_OIT_GLSL                                                           \
+	"layout(location = 0) out vec4 skr_oit_accum;\n"                      \
+	"layout(location = 1) out vec4 skr_oit_weight;\n"                     \
+	"void skr_oit_write(vec4 color) {\n"                                  \
+	"  float d = 1.0 / gl_FragCoord.w;\n"                                 \
+	"  float w = color.a * clamp(10.0 / (1e-5 + pow(d / 5.0, 2.0) +\n"    \
+	"                            pow(d / 200.0, 6.0)), 1e-2, 3e3);\n"     \
+	"  skr_oit_accum = vec4(color.rgb * w, color.a);\n"                   \
+	"  skr_oit_weight = vec4(w, 0.0, 0.0, color.a);\n"                    \
+	"}\n"
+
+/**
+ * @brief G-buffer fragment shader for ::skr_lit_3d_vert, albedo from the
+ * texture on unit 0 and constant `skr_roughness` and `skr_metallic`.
+ */
+static const char* const skr_gbuffer_frag =
+        "#version 330 core\n" SKR_GBUFFER_GLSL
+        "in vec3 WorldPos;\n"
+        "in vec3 Normal;\n"
+        "in vec2 TexCoord;\n"
+        "uniform sampler2D skr_albedo;\n"
+        "uniform float skr_roughness = 0.5;\n"
+        "uniform float skr_metallic = 0.0;\n"
+        "void main() {\n"
+        "  vec3 albedo = texture(skr_albedo, TexCoord).rgb;\n"
+        "  skr_gbuffer_write(albedo, Normal, skr_roughness, skr_metallic);\n"
+        "}\n";
+
+#define SkrDefaultFPSCamera                                                    \
+	(&(SkrCamera){                                                         \
+	        .Position = {0.0f, 0.0f, 3.0f},                                \
+	        .Front = {0.0f, 0.0f, -1.0f},                                  \
+	        .Up = {0.0f, 1.0f, 0.0f},                                      \
+                                                                               \
+	        .Yaw = -90.0f,                                                 \
+	        .Pitch = 0.0f,                                                 \
+	        .FOV = 70.0f,                                                  \
+	        .Zoom = 1.0f,                                                  \
+                                                                               \
+	        .Sensitivity = 0.1f,                                           \
+	        .Speed = 0.1f,                                                 \
+	})
+
+/**
+ * @brief Classes of graphics driver debug messages.
+ */
+typedef enum SkrDebugCategory {
+	SKR_DEBUG_ERROR,       /*!< API errors. */
+	SKR_DEBUG_PERFORMANCE, /*!< Stalls, recompiles, redundant state. */
+	SKR_DEBUG_UNDEFINED,   /*!< Undefined or deprecated behavior. */
+	SKR_DEBUG_PORTABILITY, /*!< Vendor-specific behavior. */
+	SKR_DEBUG_OTHER,       /*!< Everything else, including notifications. */
+} SkrDebugCategory;
+
+/**
+ * @brief Function type for driver debug message sinks.
+ */
+typedef void SkrDebugHandler(SkrDebugCategory category, unsigned int id,
+                             const char* message);
+
+/**
+ * @brief Distinct message IDs tracked by the debug rate limiter.
+ */
+#ifndef SKR_DEBUG_SLOTS
+#define SKR_DEBUG_SLOTS 64
+#endif
+
+/**
+ * @brief Times the same message ID is logged per ::SKR_DEBUG_REPEAT_FRAMES
+ * before it is suppressed.
+ */
+#ifndef SKR_DEBUG_MAX_REPEATS
+#define SKR_DEBUG_MAX_REPEATS 4
+#endif
+
+/**
+ * @brief Frames after which the per-ID counts are cleared, so a recurring
+ * message is logged again.
+ */
+#ifndef SKR_DEBUG_REPEAT_FRAMES
+#define SKR_DEBUG_REPEAT_FRAMES 600
+#endif
+
+/**
+ * @brief Messages logged per frame before the rest of the frame is
+ * suppressed.
+ */
+#ifndef SKR_DEBUG_MAX_PER_FRAME
+#define SKR_DEBUG_MAX_PER_FRAME 16
+#endif
+
+/**
+ * @brief Driver debug output state.
+ *
+ * Enabled by ::SkrRendererInit when SkrWindow::Debug is set. Messages are
+ * filtered by category, rate limited per ID and per frame, and handed to
+ * `Handler` (stderr if NULL).
+ */
+typedef struct SkrDebug {
+	bool Enabled; /*!< Debug output or glGetError polling is active. */
+	bool Output;  /*!< KHR_debug message callback is installed. */
+
+	/**
+	 * @brief Annotate passes with debug groups for capture tools.
+	 *
+	 * Set before ::SkrRendererInit to annotate without a debug context.
+	 * Cleared if the driver lacks KHR_debug.
+	 */
+	bool Groups;
+
+	/**
+	 * @brief Bitmask of (1 << ::SkrDebugCategory) to log.
+	 *
+	 * 0 selects everything but ::SKR_DEBUG_OTHER.
+	 */
+	unsigned int Mask;
+
+	SkrDebugHandler* Handler; /*!< Message sink, NULL for stderr. */
+
+	unsigned int FrameLogged; /*!< Messages logged this frame. */
+
+	struct {
+		unsigned int ID;
+		unsigned int Count;
+	} Seen[SKR_DEBUG_SLOTS]; /*!< Per-ID counts, cleared periodically. */
+} SkrDebug;
+
+/**
+ * @brief Per-frame renderer statistics.
+ *
+ * Counters describe the last rendered frame and are reset when the next one
+ * starts.
+ */
+typedef struct SkrRenderStats {
+	unsigned long Frame; /*!< Frames rendered so far. */
+
+	unsigned int DrawCalls;           /*!< Draw calls issued. */
+	unsigned int DebugMessages;       /*!< Driver messages received. */
+	unsigned int PerformanceWarnings; /*!< Performance messages. */
+	unsigned int Errors;              /*!< API errors. */
+	unsigned int Suppressed;          /*!< Messages dropped by limits. */
+} SkrRenderStats;
+
+/**
+ * @brief Swap interval policy.
+ */
+typedef enum SkrVsync {
+	SKR_VSYNC_DEFAULT = 0, /*!< Leave the driver setting untouched. */
+	SKR_VSYNC_OFF,         /*!< Swap immediately, may tear. */
+	SKR_VSYNC_ON,          /*!< Wait for vertical blank. */
+
+	/**
+	 * @brief Wait for vertical blank unless the frame is late.
+	 *
+	 * Needs *_EXT_swap_control_tear, falls back to ::SKR_VSYNC_ON.
+	 */
+	SKR_VSYNC_ADAPTIVE,
+} SkrVsync;
+
+/**
+ * @brief Frame pacing and latency control.
+ *
+ * Changes take effect at the start of the next frame.
+ */
+typedef struct SkrPacing {
+	SkrVsync Vsync; /*!< Swap interval policy. */
+
+	/**
+	 * @brief Frame rate cap in Hz, 0 for none.
+	 *
+	 * The limiter sleeps until `SpinMargin` before the deadline and
+	 * busy-waits the rest, since OS sleeps overshoot by up to a
+	 * scheduler tick.
+	 */
+	double TargetFPS;
+	double SpinMargin; /*!< Seconds to busy-wait, default 0.002. */
+
+	/**
+	 * @brief Bound the frames queued by the driver to one.
+	 *
+	 * Before sampling input, wait until the GPU has finished the previous
+	 * frame, so input is at most one frame old when it is displayed.
+	 * Trades some throughput for latency.
+	 */
+	bool LowLatency;
+
+	double Waited;      /*!< Seconds the limiter waited this frame. */
+	double FenceWaited; /*!< Seconds spent waiting on the GPU. */
+
+	/**
+	 * @brief The platform cannot sleep, so the limiter busy-waits the
+	 * whole wait instead of only `SpinMargin`.
+	 */
+	bool Spinning;
+
+	int    Applied;  /*!< Swap interval set, -2 if never set. */
+	double Deadline; /*!< Clock at which the next frame may start. */
+	void*  Fence;    /*!< Sync object of the previous frame. */
+} SkrPacing;
+
+/**
+ * @brief Frame timing and fixed-step simulation clock.
+ *
+ * Each frame ::SkrRendererRender measures the elapsed time, runs
+ * SkrState::Update zero or more times with a fixed `Step`, and leaves the
+ * remainder as `Alpha` to interpolate transforms and the camera between the
+ * last two simulation states. Zeroed fields take their defaults on the first
+ * frame.
+ */
+typedef struct SkrTime {
+	double Step;      /*!< Simulation step in seconds, default 1/60. */
+	double MaxFrame;  /*!< Longest frame simulated, default 0.25 s. */
+	double Smoothing; /*!< Weight of the newest delta, default 0.1. */
+	unsigned int MaxSteps; /*!< Steps per frame before dropping time. */
+
+	double Start;       /*!< Clock at the first frame. */
+	double Now;         /*!< Clock at the start of this frame. */
+	double Delta;       /*!< Seconds since the previous frame. */
+	double Smoothed;    /*!< Exponentially smoothed `Delta`. */
+	double Accumulator; /*!< Unsimulated time, less than `Step`. */
+	float  Alpha;       /*!< `Accumulator / Step`, in [0, 1). */
+
+	unsigned long Steps;  /*!< Simulation steps run so far. */
+	unsigned int  Frames; /*!< Steps run this frame. */
+} SkrTime;
+
+/**
+ * @brief Function type for a slice of a parallel loop.
+ *
+ * @param user  Pointer given to ::skr_jobs_for.
+ * @param begin First index of the slice.
+ * @param end   One past the last index of the slice.
+ */
+typedef void SkrJobFunc(void* user, unsigned int begin, unsigned int end);
+
+/**
+ * @brief Most worker threads a job pool can have.
+ */
+#ifndef SKR_JOBS_MAX_THREADS
+#define SKR_JOBS_MAX_THREADS 64
+#endif
+
+/**
+ * @brief Fixed pool of worker threads running parallel loops.
+ *
+ * Workers sleep between loops. Within a loop, slices are claimed with one
+ * atomic increment each, so uneven slices balance themselves.
+ */
+typedef struct SkrJobs {
+	unsigned int ThreadCount; /*!< Workers, the caller also takes part. */
+
+#if defined(_WIN32)
+	HANDLE             Threads[SKR_JOBS_MAX_THREADS];
+	SRWLOCK            Lock;
+	CONDITION_VARIABLE Wake;
+	CONDITION_VARIABLE Done;
+#else
+	pthread_t       Threads[SKR_JOBS_MAX_THREADS];
+	pthread_mutex_t Lock;
+	pthread_cond_t  Wake;
+	pthread_cond_t  Done;
+#endif
+
+	SkrJobFunc*   Func;
+	void*         User;
+	unsigned int  Count;
+	unsigned int  Grain;
+	SkrAtomicUint Next; /*!< First index not claimed yet. */
+
+	unsigned int  Busy;       /*!< Workers still in the current loop. */
+	unsigned long Generation; /*!< Incremented for each loop. */
+	bool          Quit;
+} SkrJobs;
+
+/**
+ * @brief Most slices one pass of a parallel radix sort is split into.
+ */
+#ifndef SKR_RADIX_SLICES
+#define SKR_RADIX_SLICES 64
+#endif
+
+/**
+ * @brief Stable radix sort of 32-bit keys carrying 32-bit values.
+ *
+ * Fill `Keys` and `Values` after ::skr_radix_reserve, then call
+ * ::skr_radix_sort. Each of the four 8-bit digit passes counts digits per
+ * slice in parallel, turns the counts into per-slice offsets, then lets
+ * each slice scatter its own entries, so equal keys keep their order.
+ * Passes where every key has the same digit are skipped. Float keys sort
+ * through ::skr_radix_float_key.
+ */
+typedef struct SkrRadixSort {
+	unsigned int* Keys;     /*!< Sorted in place. */
+	unsigned int* Values;   /*!< Moved along with their keys. */
+	unsigned int  Capacity; /*!< Entries `Keys` and `Values` hold. */
+
+	unsigned int* Scratch; /*!< Keys then values, `2 * Capacity`. */
+	unsigned int* Counts;  /*!< 256 digit counts per slice. */
+	unsigned int  Passes;  /*!< Digit passes the last sort ran. */
+} SkrRadixSort;
+
+/**
+ * @brief How SkrRendererRender blends transparent renderables.
+ */
+typedef enum SkrTransparencyMode {
+	SKR_TRANSPARENCY_SORTED,   /*!< Back to front, alpha blended. */
+	SKR_TRANSPARENCY_WEIGHTED, /*!< Weighted blended, order-independent. */
+} SkrTransparencyMode;
+
+/**
+ * @brief Transparent renderables of the frame.
+ *
+ * ::SKR_RENDERABLE_TRANSPARENT rows are culled into
+ * SkrRenderables::Transparent and drawn after the opaque scene, tested
+ * against its depth without writing it. SKR_TRANSPARENCY_SORTED radix
+ * sorts them back to front by the view depth of their bounds and alpha
+ * blends them in that order. SKR_TRANSPARENCY_WEIGHTED skips the sort:
+ * materials write through ::SKR_OIT_GLSL into two targets summed with
+ * depth-based weights, and one full-screen pass blends the weighted
+ * average over the scene. It only approximates layers of very different
+ * colors, but its cost does not depend on order, for particle and foliage
+ * counts too large to sort each frame.
+ */
+typedef struct SkrTransparency {
+	SkrTransparencyMode Mode; /*!< SKR_TRANSPARENCY_SORTED by default. */
+	SkrRadixSort        Sort; /*!< Back to front order, when sorted. */
+	int Targets[2]; /*!< Accumulation and weight in SkrState::Graph. */
+
+	union {
+		struct {
+			GLuint Composite; /*!< Weighted average over scene. */
+			GLuint VAO;       /*!< Empty, for full-screen passes. */
+		} GL;
+	} Backend;
+} SkrTransparency;
+
+struct SkrState;
+
+/**
+ * @brief Function type for fixed-step simulation callbacks.
+ *
+ * @param s    Engine state.
+ * @param step Simulated time in seconds (SkrTime::Step).
+ */
+typedef void SkrUpdateHandler(struct SkrState* s, double step);
+
+/**
+ * @brief Function type for input events drained by the simulation.
+ */
+typedef void SkrEventHandler(struct SkrState* s, const SkrInputEvent* e);
+
+/**
+ * @brief Function type for late mouse-look sampling.
+ *
+ * @param dx Cursor motion since the previous sample, in pixels.
+ * @param dy Cursor motion since the previous sample, in pixels.
+ */
+typedef void SkrLookHandler(struct SkrState* s, double dx, double dy);
+
+/**
+ * @brief Backend entry points.
+ *
+ * One table per API/window backend pair. Only used when SKR_BACKEND_MULTI is
+ * defined, in which case the table is chosen once by ::SkrInit and every
+ * frame dispatches through it. Otherwise the pair fixed by SKR_BACKEND_API and
+ * SKR_BACKEND_WINDOW is called directly.
+ */
+typedef struct SkrBackend {
+	int (*WindowInit)(SkrWindow* w);               /*!< Create the window. */
+	SkrResult (*RendererInit)(struct SkrState* s); /*!< Upload scene data. */
+	void (*FrameBegin)(struct SkrState* s);        /*!< Pace, poll input. */
+	void (*SampleCursor)(struct SkrState* s);      /*!< Read cursor now. */
+	void (*Render)(struct SkrState* s);            /*!< Render one frame. */
+	int (*ShouldClose)(struct SkrState* s);        /*!< Poll close request. */
+	void (*Finalize)(struct SkrState* s);          /*!< Release everything. */
+} SkrBackend;
+
+typedef struct SkrState {
+	SkrWindow* Window;
+
+	SkrModel*    Models;
+	unsigned int ModelCount;
+
+	SkrCamera* Camera;
+
+	/**
+	 * @brief `*Camera` at the start of the last simulation step.
+	 *
+	 * Taken from `*Camera` as is before the first step and whenever
+	 * `Camera` points somewhere else.
+	 */
+	SkrCamera CameraPrevious;
+
+	const SkrCamera* CameraSource; /*!< Camera `CameraPrevious` is of. */
+
+	/**
+	 * @brief Camera to render with, interpolated by SkrTime::Alpha.
+	 */
+	SkrCamera CameraView;
+
+	SkrView View; /*!< Matrices of `CameraView`, updated each frame. */
+
+	SkrUpdateHandler* Update; /*!< Fixed-step simulation, may be NULL. */
+
+	/**
+	 * @brief Receives queued input, may be NULL.
+	 *
+	 * Called before each simulation step with the events received up to
+	 * the end of that step, or once per frame with every event if there is
+	 * no `Update` handler. Without a handler events are discarded.
+	 */
+	SkrEventHandler* Event;
+
+	/**
+	 * @brief Receives cursor motion right before the camera is resolved.
+	 *
+	 * Meant to rotate `*Camera`; the rendered orientation is then taken
+	 * from `*Camera` as is rather than interpolated, so mouse look is not
+	 * delayed by the simulation step.
+	 */
+	SkrLookHandler* Look;
+
+	SkrTime           Time;   /*!< Frame and simulation timing. */
+	SkrPacing         Pacing; /*!< Vsync, frame cap and latency. */
+	SkrJobs*          Jobs;   /*!< Pool for per-frame loops, may be NULL. */
+
+	SkrScene       Scene;       /*!< Transform hierarchy. */
+	SkrRenderables Renderables; /*!< Packed renderable tables. */
+	SkrSkinning    Skinning;    /*!< Bone palettes of skinned renderables. */
+	SkrMorphs      Morphs;      /*!< Blended morph targets. */
+	SkrLights      Lights;      /*!< Point lights, binned per frame. */
+	SkrShadows     Shadows;     /*!< Sun and its shadow cascades. */
+	SkrDepthPass   Depth;       /*!< Depth pre-pass and program. */
+	SkrAnimations  Animations;  /*!< Skeletons animated with LOD. */
+
+	/**
+	 * @brief Shading path, SKR_RENDER_FORWARD by default.
+	 *
+	 * SKR_RENDER_DEFERRED needs a camera and materials that write
+	 * ::SKR_GBUFFER_GLSL, and falls back to forward if the G-buffer cannot
+	 * be created.
+	 */
+	SkrRenderPath Path;
+	SkrGBuffer    GBuffer; /*!< Targets of SKR_RENDER_DEFERRED. */
+	SkrGraph      Graph;   /*!< Passes of the frame, rebuilt each frame. */
+	SkrResolution Resolution; /*!< Dynamic scene resolution. */
+	SkrTemporal   Temporal;   /*!< Temporal anti-aliasing. */
+	SkrPost       Post;       /*!< Post-processing. */
+
+	SkrTransparency Transparency; /*!< Blending of transparent draws. */
+
+	union {
+		bool GL;
+	} Backend;
+
+	/**
+	 * @brief Backend chosen at init (SKR_BACKEND_MULTI only).
+	 */
+	const SkrBackend* Dispatch;
+
+	SkrDebug       Debug; /*!< Driver debug output. */
+	SkrRenderStats Stats; /*!< Statistics of the last frame. */
+} SkrState;
+
+/*
+ * Public API. In SKR_LIBRARY mode these declarations are all a translation
+ * unit sees; their definitions live in the SKR_IMPLEMENTATION unit.
+ */
+
+SKR_API SkrResult   SkrLastError(void);
+SKR_API const char* SkrLastErrorMessage(void);
+SKR_API void        SkrClearError(void);
+
+SKR_API void skr_debug_report(SkrState* s, SkrDebugCategory category,
+                              unsigned int id, const char* message);
+SKR_API void skr_debug_frame_begin(SkrState* s);
+
+SKR_API double skr_clock_now(void);
+SKR_API void   skr_pacing_limit(SkrPacing* p);
+SKR_API int    skr_input_push(SkrInput* in, const SkrInputEvent* e);
+SKR_API int    skr_input_pop(SkrInput* in, double until, SkrInputEvent* e);
+
+SKR_API void skr_camera_rotate(SkrCamera* c, float dx, float dy);
+SKR_API int  skr_view_update(SkrView* v, const SkrCamera* c, float aspect);
+
+SKR_API int  skr_lights_add(SkrLights* l, const vec3 position, float radius,
+                            const vec3 color, float intensity);
+SKR_API void skr_lights_remove(SkrLights* l, unsigned int index);
+SKR_API int  skr_lights_bin(SkrLights* l, const SkrView* view);
+SKR_API void skr_lights_free(SkrLights* l);
+
+SKR_API int  skr_shadows_update(SkrShadows* sh, const SkrView* view,
+                                const SkrRenderables* r);
+SKR_API void skr_shadows_invalidate(SkrShadows* sh);
+SKR_API void skr_shadows_free(SkrShadows* sh);
+
+SKR_API void skr_graph_reset(SkrGraph* g);
+SKR_API int  skr_graph_create(SkrGraph* g, const char* name, SkrFormat format,
+                              int width, int height);
+SKR_API int  skr_graph_import(SkrGraph* g, const char* name);
+SKR_API int  skr_graph_pass(SkrGraph* g, const char* name,
+                            SkrGraphFunc* execute, void* user);
+SKR_API int  skr_graph_read(SkrGraph* g, unsigned int pass,
+                            unsigned int resource);
+SKR_API int  skr_graph_write(SkrGraph* g, unsigned int pass,
+                             unsigned int resource);
+SKR_API int  skr_graph_compile(SkrGraph* g);
+SKR_API void skr_graph_free(SkrGraph* g);
+
+SKR_API void skr_resolution_update(SkrResolution* r, double gpu_time);
+
+SKR_API void skr_temporal_jitter(SkrTemporal* t, SkrView* v, int width,
+                                 int height);
+SKR_API void skr_temporal_store(SkrTemporal* t, const SkrView* v,
+                                SkrRenderables* r, const SkrScene* scene);
+SKR_API void skr_temporal_reset(SkrTemporal* t);
+SKR_API void skr_lut_identity(unsigned int size, unsigned char* rgba);
+
+SKR_API SkrState SkrInit(SkrWindow* w, int backend);
+SKR_API int      SkrRendererInit(SkrState* s);
+SKR_API int      SkrShouldClose(SkrState* s);
+SKR_API void     SkrRendererRender(SkrState* s);
+SKR_API void     SkrTriangle(SkrState* s);
+SKR_API void     SkrCaptureCursor(SkrState* s);
+SKR_API int      m_skr_mesh_append_vertices(SkrMesh*         mesh,
+                                            const SkrVertex* vertices,
+                                            const int        count);
+SKR_API int      skr_model_append_mesh(SkrModel* model, const SkrMesh* mesh);
+SKR_API int      skr_state_append_model(SkrState*       state,
+                                        const SkrModel* model);
+SKR_API void     skr_mesh_normalize_weights(SkrMesh* mesh);
+
+SKR_API SkrNode skr_scene_node_create(SkrScene* scene, SkrNode parent);
+SKR_API int     skr_scene_node_set_parent(SkrScene* scene, SkrNode node,
+                                          SkrNode parent);
+SKR_API int     skr_scene_node_set_position(SkrScene* scene, SkrNode node,
+                                            const vec3 position);
+SKR_API int     skr_scene_node_set_rotation(SkrScene* scene, SkrNode node,
+                                            const versor rotation);
+SKR_API int     skr_scene_node_set_scale(SkrScene* scene, SkrNode node,
+                                         const vec3 scale);
+SKR_API void    skr_scene_update(SkrScene* scene);
+SKR_API void    skr_scene_step_begin(SkrScene* scene);
+SKR_API void    skr_scene_interpolate(SkrScene* scene, float alpha);
+SKR_API void    skr_scene_free(SkrScene* scene);
+
+SKR_API int  skr_renderables_add(SkrRenderables* r, SkrNode node,
+                                 SkrMesh* mesh, SkrMaterial* material,
+                                 const vec4 bounds, unsigned int flags);
+SKR_API void skr_renderables_remove(SkrRenderables* r, unsigned int index);
+SKR_API SkrRenderable skr_renderables_handle(const SkrRenderables* r,
+                                             unsigned int          index);
+SKR_API int           skr_renderables_row(const SkrRenderables* r,
+                                          SkrRenderable         handle);
+SKR_API void skr_renderables_update_bounds(SkrRenderables* r,
+                                           const SkrScene* scene);
+SKR_API unsigned int skr_renderables_cull(SkrRenderables* r,
+                                          const vec4      planes[6]);
+SKR_API unsigned int skr_renderables_cull_clusters(SkrRenderables* r,
+                                                   const SkrScene* scene,
+                                                   const SkrView*  v);
+SKR_API void         skr_renderables_sort(SkrRenderables* r);
+SKR_API int          skr_renderables_sort_transparent(SkrRenderables* r,
+                                                      const SkrView*  v,
+                                                      SkrRadixSort* sort,
+                                                      SkrJobs*      jobs);
+SKR_API void         skr_renderables_free(SkrRenderables* r);
+SKR_API void         skr_renderables_set_skin(SkrRenderables* r,
+                                              unsigned int index, int base);
+SKR_API void         skr_renderables_set_morph(SkrRenderables* r,
+                                               unsigned int    index,
+                                               int             instance);
+
+SKR_API int  skr_skinning_alloc(SkrSkinning* s, unsigned int bones);
+SKR_API void skr_skinning_set(SkrSkinning* s, int base, unsigned int bone,
+                              const mat4 m);
+SKR_API void skr_skinning_set_dq(SkrSkinning* s, int base, unsigned int bone,
+                                 const versor rotation,
+                                 const vec3   translation);
+SKR_API void skr_skinning_mark(SkrSkinning* s, int base, unsigned int bones);
+SKR_API void skr_skin_vertices(const SkrSkinning* s, int base,
+                               const SkrVertex* src, unsigned int count,
+                               vec4* out);
+SKR_API void skr_skinning_free(SkrSkinning* s);
+
+SKR_API int  skr_mesh_add_morph_target(SkrMesh* mesh, const vec3* positions,
+                                       const vec3* normals, float epsilon);
+SKR_API void skr_mesh_free_morph_targets(SkrMesh* mesh);
+SKR_API int  skr_morphs_alloc(SkrMorphs* m, SkrMesh* mesh);
+SKR_API void skr_morphs_set_weight(SkrMorphs* m, unsigned int instance,
+                                   unsigned int target, float weight);
+SKR_API void skr_morphs_update(SkrMorphs* m);
+SKR_API void skr_morphs_free(SkrMorphs* m);
+
+SKR_API int  skr_mesh_build_clusters(SkrMesh* mesh, unsigned int triangles);
+SKR_API void skr_mesh_free_clusters(SkrMesh* mesh);
+
+SKR_API int  skr_jobs_init(SkrJobs* j, unsigned int threads);
+SKR_API void skr_jobs_for(SkrJobs* j, unsigned int count, unsigned int grain,
+                          SkrJobFunc* func, void* user);
+SKR_API void skr_jobs_free(SkrJobs* j);
+
+SKR_API unsigned int skr_radix_float_key(float f);
+SKR_API int          skr_radix_reserve(SkrRadixSort* s, unsigned int count);
+SKR_API void         skr_radix_sort(SkrRadixSort* s, unsigned int count,
+                                    SkrJobs* jobs);
+SKR_API void         skr_radix_free(SkrRadixSort* s);
+
+SKR_API int  skr_skeleton_init(SkrSkeleton* skel, unsigned int bones);
+SKR_API void skr_skeleton_model(const SkrSkeleton* skel,
+                                const SkrBonePose* local, mat4* model);
+SKR_API void skr_skeleton_palette(const SkrSkeleton* skel, const mat4* model,
+                                  SkrSkinning* skin, int base);
+SKR_API void skr_skeleton_free(SkrSkeleton* skel);
+
+SKR_API int  skr_clip_build(SkrClip* clip, float duration,
+                            unsigned int          bones,
+                            const SkrTrackSource* tracks);
+SKR_API void skr_clip_free(SkrClip* clip);
+SKR_API int  skr_clip_cursor_init(SkrClipCursor* cursor, const SkrClip* clip);
+SKR_API void skr_clip_cursor_free(SkrClipCursor* cursor);
+SKR_API void skr_clip_sample(const SkrClip* clip, SkrClipCursor* cursor,
+                             float time, SkrBonePose* out);
+SKR_API void skr_pose_blend(SkrBonePose* out, const SkrBonePose* a,
+                            const SkrBonePose* b, float weight,
+                            const float* mask, unsigned int bones);
+
+SKR_API int  skr_animations_add(SkrAnimations* a, SkrSkinning* skin,
+                                SkrSkeleton* skel, SkrClip* clip,
+                                SkrRenderable renderable);
+SKR_API void skr_animations_update(SkrAnimations* a, SkrSkinning* skin,
+                                   const SkrView*        view,
+                                   const SkrRenderables* r, float dt);
+SKR_API void skr_animations_free(SkrAnimations* a);
+
+#ifdef M_SKR_DEFINE_IMPL
+
+/**
+ * @internal
+ * @brief Per-thread error state.
+ *
+ * Failures record their code, origin and a short detail string. The full
+ * message is only formatted when it is read through ::SkrLastErrorMessage,
+ * so neither success nor failure paths pay for it unless someone asks.
+ */
+typedef struct SkrError {
+	SkrResult   Code;
+	const char* File;
+	int         Line;
+	const char* Func;
+	bool        Formatted; /*!< Message is up to date. */
+
+	char Detail[SKR_LAST_ERROR_SIZE];
+	char Message[SKR_LAST_ERROR_SIZE];
+} SkrError;
+
+static M_SKR_THREAD_LOCAL SkrError m_skr_error;
+
+/**
+ * @internal
+ * @brief Set the last error with source metadata.
+ *
+ * Stores `code` and the printf-style detail into the calling thread's error
+ * state. The error will typically be set through the @ref m_skr_last_error_set
+ * macro, which automatically includes the file, line, and function name where
+ * the error occurred.
+ *
+ * @param code  Status code of the failure.
+ * @param file  Source file where the error occurred (use __FILE__).
+ * @param line  Line number where the error occurred (use __LINE__).
+ * @param func  Function name where the error occurred (use __func__).
+ * @param fmt   Format string (printf-style).
+ * @param ...   Arguments corresponding to the format specifiers in `fmt`.
+ */
+static inline void m_skr_last_error_set_with_meta(const SkrResult code,
+                                                  const char*     file,
+                                                  const int       line,
+                                                  const char*     func,
+                                                  const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+
+	m_skr_error.Code = code;
+	m_skr_error.File = file;
+	m_skr_error.Line = line;
+	m_skr_error.Func = func;
+	m_skr_error.Formatted = false;
+
+	vsnprintf(m_skr_error.Detail, SKR_LAST_ERROR_SIZE, fmt, args);
+
+	va_end(args);
+}
+
+/**
+ * @brief Set the last error with automatic source metadata.
+ *
+ * Use this macro instead of calling 'm_skr_last_error_set_with_meta()'
+ * directly. It automatically records the source file, line number, and
+ * function name of the failure.
+ *
+ * @usage
+ * m_skr_last_error_set(SKR_ERROR_TEXTURE, "failed to load: %s", path);
+ */
+#define m_skr_last_error_set(code, ...)                                        \
+	m_skr_last_error_set_with_meta(code, __FILE__, __LINE__, __func__,     \
+	                               __VA_ARGS__)
+
+/**
+ * @internal
+ * @brief Clears the calling thread's error on success paths.
+ *
+ * Compiled out in release builds (NDEBUG), so success paths never touch the
+ * error state there.
+ *
+ * @usage
+ * m_skr_last_error_clear();
+ */
+#ifndef NDEBUG
+#define m_skr_last_error_clear() (m_skr_error.Code = SKR_SUCCESS)
+#else
+#define m_skr_last_error_clear() ((void)0)
+#endif
+
+/**
+ * @internal
+ * @brief Readable name of a status code.
+ */
+static inline const char* m_skr_result_string(const SkrResult code) {
+	switch (code) {
+	case SKR_SUCCESS:
+		return "success";
+	case SKR_ERROR_INVALID_ARGUMENT:
+		return "invalid argument";
+	case SKR_ERROR_OUT_OF_MEMORY:
+		return "out of memory";
+	case SKR_ERROR_IO:
+		return "i/o error";
+	case SKR_ERROR_WINDOW:
+		return "window error";
+	case SKR_ERROR_BACKEND:
+		return "backend error";
+	case SKR_ERROR_SHADER:
+		return "shader error";
+	case SKR_ERROR_TEXTURE:
+		return "texture error";
+	}
+
+	return "unknown error";
+}
+
+/**
+ * @brief Status code of the calling thread's last failure.
+ *
+ * @return ::SKR_SUCCESS if no error is set.
+ */
+SKR_API SkrResult SkrLastError(void) { return m_skr_error.Code; }
+
+/**
+ * @brief Message of the calling thread's last failure.
+ *
+ * @return "[SKR] ERROR file:line:func: kind: detail", or "" if no error is
+ *         set.
+ */
+SKR_API const char* SkrLastErrorMessage(void) {
+	if (m_skr_error.Code == SKR_SUCCESS)
+		return "";
+
+	if (!m_skr_error.Formatted) {
+		int written = snprintf(m_skr_error.Message, SKR_LAST_ERROR_SIZE,
+		                       "[SKR] ERROR %s:%d:%s: %s: ",
+		                       m_skr_error.File, m_skr_error.Line,
+		                       m_skr_error.Func,
+		                       m_skr_result_string(m_skr_error.Code));
+
+		if (written >= 0 && written < SKR_LAST_ERROR_SIZE)
+			snprintf(m_skr_error.Message + written,
+			         SKR_LAST_ERROR_SIZE - (size_t)written, "%s",
+			         m_skr_error.Detail);
+		m_skr_error.Formatted = true;
+	}
+
+	return m_skr_error.Message;
+}
+
+/**
+ * @brief Clear the calling thread's error.
+ */
+SKR_API void SkrClearError(void) { m_skr_error.Code = SKR_SUCCESS; }
+
+/**
+ * @internal
+ * @brief Load an image from a file into raw pixel memory.
+ *
+ * This function **must be implemented by the user** of the engine. The engine
+ * will call it when loading textures, but does not provide its own image
+ * loading backend.
+ *
+ * @param path     Filesystem path to the image file.
+ * @param width    Output pointer to receive image width in pixels.
+ * @param height   Output pointer to receive image height in pixels.
+ * @param channels Output pointer to receive the number of color channels.
+ *
+ * @return Pointer to raw pixel data (heap-allocated). The exact format (e.g.
+ *         RGB vs. RGBA) is determined by the user's implementation. Returns
+ *         NULL if the image could not be loaded.
+ *
+ * @note The returned memory must be freed with ::skr_free_image.
+ */
+extern unsigned char* m_skr_load_image_from_file(const char* path, int* width,
+                                                 int* height, int* channels);
+
+/**
+ * @internal
+ * @brief Free pixel memory previously allocated by
+ * ::m_skr_load_image_from_file.
+ *
+ * This function **must be implemented by the user** of the engine to match the
+ * allocation strategy used in their m_skr_load_image_from_file.
+ *
+ * @param image_data Pointer to the pixel data to free. Safe to pass NULL.
+ */
+extern void m_skr_free_image(unsigned char* image_data);
+
+/**
+ * @internal
+ * @brief Read a whole file into memory.
+ *
+ * Opens the file in binary mode, reads its contents into a null-terminated
  * buffer, and returns it. Caller must free the buffer with `free()`.
  *
- * @param path File path to read.
- * @return Newly allocated buffer containing file contents, or NULL on error.
+ * @param path File path to read.
+ * @return Newly allocated buffer containing file contents, or NULL on error.
+ */
+static inline char* m_skr_read_file(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		m_skr_last_error_set(SKR_ERROR_IO, "failed to open %s", path);
+		return NULL;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long len = ftell(file);
+	rewind(file);
+
+	char* buffer = (char*)malloc((unsigned long)len + 1);
+	if (!buffer) {
+		fclose(file);
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to allocate %ld bytes", len + 1);
+		return NULL;
+	}
+
+	fread(buffer, 1, (unsigned long)len, file);
+	buffer[len] = '\0';
+	fclose(file);
+
+	return buffer;
+}
+
+/**
+ * @brief Monotonic high-resolution clock.
+ *
+ * Where the platform hides a monotonic clock (e.g. strict ISO C builds without
+ * CLOCK_MONOTONIC) this falls back to wall time, which can jump; the frame
+ * clock and the limiter clamp such jumps.
+ *
+ * @return Seconds since an unspecified fixed point.
+ */
+SKR_API double skr_clock_now(void) {
+#if defined(_WIN32)
+	LARGE_INTEGER freq, now;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	return (double)now.QuadPart / (double)freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#else
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * @brief Queue an input event (producer side).
+ *
+ * @return 1 on success, 0 if the ring is full and the event was dropped.
+ */
+SKR_API int skr_input_push(SkrInput* in, const SkrInputEvent* e) {
+	const unsigned int head =
+	        atomic_load_explicit(&in->Head, memory_order_relaxed);
+	const unsigned int tail =
+	        atomic_load_explicit(&in->Tail, memory_order_acquire);
+
+	if (head - tail == SKR_INPUT_CAPACITY) {
+		atomic_fetch_add_explicit(&in->Dropped, 1, memory_order_relaxed);
+		return 0;
+	}
+
+	in->Events[head & (SKR_INPUT_CAPACITY - 1)] = *e;
+	atomic_store_explicit(&in->Head, head + 1, memory_order_release);
+	return 1;
+}
+
+/**
+ * @brief Dequeue the oldest input event (consumer side).
+ *
+ * @param until Only dequeue an event received at or before this time.
+ * @return 1 if `*e` was filled, 0 otherwise.
+ */
+SKR_API int skr_input_pop(SkrInput* in, const double until, SkrInputEvent* e) {
+	const unsigned int tail =
+	        atomic_load_explicit(&in->Tail, memory_order_relaxed);
+	const unsigned int head =
+	        atomic_load_explicit(&in->Head, memory_order_acquire);
+
+	if (tail == head)
+		return 0;
+
+	const SkrInputEvent* next = &in->Events[tail & (SKR_INPUT_CAPACITY - 1)];
+	if (next->Time > until)
+		return 0;
+
+	*e = *next;
+	atomic_store_explicit(&in->Tail, tail + 1, memory_order_release);
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Sleep for about `seconds`, usually a little longer.
+ *
+ * @return 1, or 0 if the platform has no way to sleep and nothing was done.
+ */
+static inline int m_skr_sleep(const double seconds) {
+	if (seconds <= 0.0)
+		return 1;
+#if defined(_WIN32)
+	Sleep((DWORD)(seconds * 1000.0));
+	return 1;
+#elif defined(CLOCK_MONOTONIC) ||                                             \
+        (!defined(__cplusplus) && !defined(__STDC_NO_THREADS__))
+	struct timespec ts;
+	ts.tv_sec = (time_t)seconds;
+	ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+#if defined(CLOCK_MONOTONIC)
+	nanosleep(&ts, NULL);
+#else
+	thrd_sleep(&ts, NULL);
+#endif
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+#if defined(_WIN32)
+#define M_SKR_JOBS_LOCK(j)      AcquireSRWLockExclusive(&(j)->Lock)
+#define M_SKR_JOBS_UNLOCK(j)    ReleaseSRWLockExclusive(&(j)->Lock)
+#define M_SKR_JOBS_WAIT(j, cv)  SleepConditionVariableSRW(&(j)->cv, &(j)->Lock, INFINITE, 0)
+#define M_SKR_JOBS_SIGNAL(j, cv) WakeAllConditionVariable(&(j)->cv)
+#else
+#define M_SKR_JOBS_LOCK(j)      pthread_mutex_lock(&(j)->Lock)
+#define M_SKR_JOBS_UNLOCK(j)    pthread_mutex_unlock(&(j)->Lock)
+#define M_SKR_JOBS_WAIT(j, cv)  pthread_cond_wait(&(j)->cv, &(j)->Lock)
+#define M_SKR_JOBS_SIGNAL(j, cv) pthread_cond_broadcast(&(j)->cv)
+#endif
+
+/**
+ * @internal
+ * @brief Claim and run slices of the current loop until none are left.
+ */
+static inline void m_skr_jobs_work(SkrJobs* j) {
+	for (;;) {
+		const unsigned int begin = atomic_fetch_add_explicit(
+		        &j->Next, j->Grain, memory_order_relaxed);
+		if (begin >= j->Count)
+			return;
+
+		const unsigned int left = j->Count - begin;
+		j->Func(j->User, begin,
+		        begin + (left < j->Grain ? left : j->Grain));
+	}
+}
+
+/**
+ * @internal
+ * @brief Worker thread body: wait for a loop, help run it, repeat.
+ */
+static inline void m_skr_jobs_worker(SkrJobs* j) {
+	unsigned long seen = 0;
+
+	M_SKR_JOBS_LOCK(j);
+	for (;;) {
+		while (seen == j->Generation && !j->Quit)
+			M_SKR_JOBS_WAIT(j, Wake);
+		if (j->Quit)
+			break;
+
+		seen = j->Generation;
+		M_SKR_JOBS_UNLOCK(j);
+		m_skr_jobs_work(j);
+		M_SKR_JOBS_LOCK(j);
+
+		if (--j->Busy == 0)
+			M_SKR_JOBS_SIGNAL(j, Done);
+	}
+	M_SKR_JOBS_UNLOCK(j);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI m_skr_jobs_main(LPVOID arg) {
+	m_skr_jobs_worker((SkrJobs*)arg);
+	return 0;
+}
+#else
+static void* m_skr_jobs_main(void* arg) {
+	m_skr_jobs_worker((SkrJobs*)arg);
+	return NULL;
+}
+#endif
+
+/**
+ * @brief Start a job pool.
+ *
+ * @param threads Worker threads, 0 for one less than the number of CPUs.
+ *                The pool may run with fewer if creation fails.
+ * @return 1 on success, 0 on failure.
+ */
+SKR_API int skr_jobs_init(SkrJobs* j, unsigned int threads) {
+	if (!j) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT, "no job pool");
+		return 0;
+	}
+
+	*j = (SkrJobs){0};
+
+	if (threads == 0) {
+#if defined(_WIN32)
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		const long cpus = (long)info.dwNumberOfProcessors;
+#else
+		const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		threads = cpus > 1 ? (unsigned int)cpus - 1 : 0;
+	}
+	if (threads > SKR_JOBS_MAX_THREADS)
+		threads = SKR_JOBS_MAX_THREADS;
+
+#if defined(_WIN32)
+	InitializeSRWLock(&j->Lock);
+	InitializeConditionVariable(&j->Wake);
+	InitializeConditionVariable(&j->Done);
+
+	for (unsigned int i = 0; i < threads; ++i) {
+		j->Threads[i] = CreateThread(NULL, 0, m_skr_jobs_main, j, 0, NULL);
+		if (!j->Threads[i])
+			break;
+		j->ThreadCount++;
+	}
+#else
+	pthread_mutex_init(&j->Lock, NULL);
+	pthread_cond_init(&j->Wake, NULL);
+	pthread_cond_init(&j->Done, NULL);
+
+	for (unsigned int i = 0; i < threads; ++i) {
+		if (pthread_create(&j->Threads[i], NULL, m_skr_jobs_main, j) != 0)
+			break;
+		j->ThreadCount++;
+	}
+#endif
+
+	return 1;
+}
+
+/**
+ * @brief Run `func` over [0, `count`) in slices of `grain`, in parallel.
+ *
+ * The calling thread works too and returns once every slice is done. Not
+ * reentrant: `func` must not start another loop on the same pool.
+ */
+SKR_API void skr_jobs_for(SkrJobs* j, const unsigned int count,
+                          unsigned int grain, SkrJobFunc* func, void* user) {
+	if (grain == 0)
+		grain = 1;
+
+	if (!j || j->ThreadCount == 0 || count <= grain) {
+		func(user, 0, count);
+		return;
+	}
+
+	M_SKR_JOBS_LOCK(j);
+	j->Func = func;
+	j->User = user;
+	j->Count = count;
+	j->Grain = grain;
+	atomic_store_explicit(&j->Next, 0, memory_order_relaxed);
+	j->Busy = j->ThreadCount;
+	j->Generation++;
+	M_SKR_JOBS_SIGNAL(j, Wake);
+	M_SKR_JOBS_UNLOCK(j);
+
+	m_skr_jobs_work(j);
+
+	M_SKR_JOBS_LOCK(j);
+	while (j->Busy)
+		M_SKR_JOBS_WAIT(j, Done);
+	M_SKR_JOBS_UNLOCK(j);
+}
+
+/**
+ * @brief Stop and join every worker of `j`.
+ */
+SKR_API void skr_jobs_free(SkrJobs* j) {
+	if (!j)
+		return;
+
+	M_SKR_JOBS_LOCK(j);
+	j->Quit = true;
+	M_SKR_JOBS_SIGNAL(j, Wake);
+	M_SKR_JOBS_UNLOCK(j);
+
+#if defined(_WIN32)
+	WaitForMultipleObjects(j->ThreadCount, j->Threads, TRUE, INFINITE);
+	for (unsigned int i = 0; i < j->ThreadCount; ++i)
+		CloseHandle(j->Threads[i]);
+#else
+	for (unsigned int i = 0; i < j->ThreadCount; ++i)
+		pthread_join(j->Threads[i], NULL);
+	pthread_cond_destroy(&j->Done);
+	pthread_cond_destroy(&j->Wake);
+	pthread_mutex_destroy(&j->Lock);
+#endif
+
+	j->ThreadCount = 0;
+}
+
+/**
+ * @brief Map `f` to a key whose unsigned order is the float order.
+ *
+ * Positive floats get the sign bit set and negative ones every bit
+ * flipped, so -inf < negatives < -0 < +0 < positives < +inf.
+ */
+SKR_API unsigned int skr_radix_float_key(const float f) {
+	uint32_t u;
+	memcpy(&u, &f, sizeof(u));
+	return u & 0x80000000u ? ~u : u | 0x80000000u;
+}
+
+/**
+ * @brief Grow `s` to sort up to `count` entries.
+ *
+ * Existing keys and values are kept.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+SKR_API int skr_radix_reserve(SkrRadixSort* s, const unsigned int count) {
+	if (!s) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "no radix sort");
+		return 0;
+	}
+	if (count <= s->Capacity && s->Counts)
+		return 1;
+
+	const size_t n = count ? count : 1;
+	unsigned int* keys =
+	        (unsigned int*)realloc(s->Keys, n * sizeof(unsigned int));
+	if (keys)
+		s->Keys = keys;
+	unsigned int* values =
+	        keys ? (unsigned int*)realloc(s->Values,
+	                                      n * sizeof(unsigned int))
+	             : NULL;
+	if (values)
+		s->Values = values;
+	unsigned int* scratch =
+	        values ? (unsigned int*)realloc(s->Scratch,
+	                                        2 * n * sizeof(unsigned int))
+	               : NULL;
+	if (scratch)
+		s->Scratch = scratch;
+	if (!s->Counts)
+		s->Counts = (unsigned int*)malloc(SKR_RADIX_SLICES * 256 *
+		                                  sizeof(unsigned int));
+
+	if (!scratch || !s->Counts) {
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to grow radix sort");
+		return 0;
+	}
+	s->Capacity = (unsigned int)n;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief One digit pass of ::skr_radix_sort, shared by its slices.
+ */
+typedef struct SkrRadixPass {
+	SkrRadixSort*       Sort;
+	const unsigned int* Keys; /*!< Input. */
+	const unsigned int* Values;
+	unsigned int*       OutKeys; /*!< Output. */
+	unsigned int*       OutValues;
+	unsigned int        Count; /*!< Entries sorted. */
+	unsigned int        Shift; /*!< First bit of the digit. */
+	unsigned int        Grain; /*!< Entries per slice. */
+} SkrRadixPass;
+
+/**
+ * @internal
+ * @brief Count the digits of slices [`begin`, `end`) into their rows of
+ * SkrRadixSort::Counts.
+ */
+static inline void m_skr_radix_count(void* user, const unsigned int begin,
+                                     const unsigned int end) {
+	const SkrRadixPass* p = (const SkrRadixPass*)user;
+
+	for (unsigned int c = begin; c < end; ++c) {
+		unsigned int*      counts = &p->Sort->Counts[c * 256];
+		const unsigned int first = c * p->Grain;
+		const unsigned int left = p->Count - first;
+		const unsigned int last =
+		        first + (left < p->Grain ? left : p->Grain);
+
+		memset(counts, 0, 256 * sizeof(unsigned int));
+		for (unsigned int i = first; i < last; ++i)
+			++counts[p->Keys[i] >> p->Shift & 0xffu];
+	}
+}
+
+/**
+ * @internal
+ * @brief Move the entries of slices [`begin`, `end`) to the offsets in
+ * their rows of SkrRadixSort::Counts.
+ */
+static inline void m_skr_radix_scatter(void* user, const unsigned int begin,
+                                       const unsigned int end) {
+	const SkrRadixPass* p = (const SkrRadixPass*)user;
+
+	for (unsigned int c = begin; c < end; ++c) {
+		unsigned int*      offsets = &p->Sort->Counts[c * 256];
+		const unsigned int first = c * p->Grain;
+		const unsigned int left = p->Count - first;
+		const unsigned int last =
+		        first + (left < p->Grain ? left : p->Grain);
+
+		for (unsigned int i = first; i < last; ++i) {
+			const unsigned int key = p->Keys[i];
+			const unsigned int digit = key >> p->Shift & 0xffu;
+			const unsigned int at = offsets[digit]++;
+			p->OutKeys[at] = key;
+			p->OutValues[at] = p->Values[i];
+		}
+	}
+}
+
+/**
+ * @brief Sort the first `count` keys of `s` ascending, with their values.
+ *
+ * @param jobs Pool to run the slices on, NULL for the calling thread.
+ */
+SKR_API void skr_radix_sort(SkrRadixSort* s, const unsigned int count,
+                            SkrJobs* jobs) {
+	if (!s)
+		return;
+
+	s->Passes = 0;
+	if (count > s->Capacity) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "radix sort of %u entries, room for %u",
+		                     count, s->Capacity);
+		return;
+	}
+	if (count < 2)
+		return;
+
+	/* Slices of at least 1024 entries, so small sorts stay serial. */
+	const unsigned int least =
+	        (count + SKR_RADIX_SLICES - 1) / SKR_RADIX_SLICES;
+	const unsigned int grain = least > 1024 ? least : 1024;
+	const unsigned int slices = (count + grain - 1) / grain;
+
+	SkrRadixPass p = {
+	        .Sort = s,
+	        .Keys = s->Keys,
+	        .Values = s->Values,
+	        .OutKeys = s->Scratch,
+	        .OutValues = s->Scratch + s->Capacity,
+	        .Count = count,
+	        .Grain = grain,
+	};
+
+	for (p.Shift = 0; p.Shift < 32; p.Shift += 8) {
+		skr_jobs_for(jobs, slices, 1, m_skr_radix_count, &p);
+
+		/* Offsets by digit, then slice, keep equal keys in order. */
+		unsigned int sum = 0;
+		bool         uniform = false;
+		for (unsigned int d = 0; d < 256; ++d) {
+			const unsigned int start = sum;
+			for (unsigned int c = 0; c < slices; ++c) {
+				unsigned int*      n = &s->Counts[c * 256 + d];
+				const unsigned int digits = *n;
+				*n = sum;
+				sum += digits;
+			}
+			uniform |= sum - start == count;
+		}
+		if (uniform)
+			continue;
+
+		skr_jobs_for(jobs, slices, 1, m_skr_radix_scatter, &p);
+		++s->Passes;
+
+		const unsigned int* keys = p.Keys;
+		const unsigned int* values = p.Values;
+		p.Keys = p.OutKeys;
+		p.Values = p.OutValues;
+		p.OutKeys = (unsigned int*)keys;
+		p.OutValues = (unsigned int*)values;
+	}
+
+	if (p.Keys != s->Keys) {
+		memcpy(s->Keys, p.Keys, count * sizeof(unsigned int));
+		memcpy(s->Values, p.Values, count * sizeof(unsigned int));
+	}
+}
+
+/**
+ * @brief Release the arrays of `s` and reset it.
+ */
+SKR_API void skr_radix_free(SkrRadixSort* s) {
+	if (!s)
+		return;
+
+	free(s->Keys);
+	free(s->Values);
+	free(s->Scratch);
+	free(s->Counts);
+	*s = (SkrRadixSort){0};
+}
+
+/**
+ * @brief Hold the frame until SkrPacing::TargetFPS allows it to start.
+ *
+ * Sleeps for the bulk of the wait and spins the last `SpinMargin` seconds.
+ * Deadlines advance by whole periods so the average rate stays exact; a
+ * frame later than one period resets the schedule instead of bursting.
+ * Called by ::SkrRendererRender at the start of every frame.
+ */
+SKR_API void skr_pacing_limit(SkrPacing* p) {
+	p->Waited = 0.0;
+
+	if (p->TargetFPS <= 0.0) {
+		p->Deadline = 0.0;
+		return;
+	}
+
+	const double period = 1.0 / p->TargetFPS;
+	const double margin = p->SpinMargin > 0.0 ? p->SpinMargin : 0.002;
+	const double start = skr_clock_now();
+	double       now = start;
+
+	/* A clock stepped back would hold the frame: restart the schedule. */
+	if (p->Deadline - now > period)
+		p->Deadline = now;
+
+	if (p->Deadline > now) {
+		p->Spinning = !m_skr_sleep(p->Deadline - now - margin);
+		while ((now = skr_clock_now()) < p->Deadline)
+			;
+	}
+
+	p->Waited = now - start;
+	p->Deadline = now - p->Deadline > period ? now + period
+	                                         : p->Deadline + period;
+}
+
+/**
+ * @internal
+ * @brief Measure the frame and add its time to the simulation accumulator.
+ */
+static inline void m_skr_time_frame_begin(SkrTime* t) {
+	if (t->Step <= 0.0)
+		t->Step = 1.0 / 60.0;
+	if (t->MaxFrame <= 0.0)
+		t->MaxFrame = 0.25;
+	if (t->Smoothing <= 0.0)
+		t->Smoothing = 0.1;
+	if (t->MaxSteps == 0)
+		t->MaxSteps = 8;
+
+	const double now = skr_clock_now();
+	if (t->Now == 0.0) {
+		t->Start = now;
+		t->Now = now;
+		t->Smoothed = t->Step;
+	}
+
+	/* A wall-clock fallback may step back, see ::skr_clock_now. */
+	t->Delta = now > t->Now ? now - t->Now : 0.0;
+	t->Now = now;
+
+	/* Clamp long frames (breakpoints, loading) instead of catching up. */
+	const double frame = t->Delta < t->MaxFrame ? t->Delta : t->MaxFrame;
+	t->Smoothed += (frame - t->Smoothed) * t->Smoothing;
+	t->Accumulator += frame;
+	t->Frames = 0;
+}
+
+/**
+ * @brief Turn a first-person camera by mouse motion.
+ *
+ * Scales by SkrCamera::Sensitivity, clamps the pitch short of the poles and
+ * rebuilds Front, Right and Up from yaw and pitch.
+ *
+ * @param dx Horizontal motion, positive turns right.
+ * @param dy Vertical motion, positive turns down (window coordinates).
+ */
+SKR_API void skr_camera_rotate(SkrCamera* c, const float dx, const float dy) {
+	vec3 world_up = {0.0f, 1.0f, 0.0f};
+	if (glm_vec3_norm2(c->WorldUp) > 0.0f)
+		glm_vec3_copy(c->WorldUp, world_up);
+
+	c->Yaw += dx * c->Sensitivity;
+	c->Pitch = glm_clamp(c->Pitch - dy * c->Sensitivity, -89.0f, 89.0f);
+
+	const float yaw = glm_rad(c->Yaw);
+	const float pitch = glm_rad(c->Pitch);
+
+	c->Front[0] = cosf(yaw) * cosf(pitch);
+	c->Front[1] = sinf(pitch);
+	c->Front[2] = sinf(yaw) * cosf(pitch);
+	glm_vec3_normalize(c->Front);
+
+	glm_vec3_crossn(c->Front, world_up, c->Right);
+	glm_vec3_crossn(c->Right, c->Front, c->Up);
+}
+
+/**
+ * @internal
+ * @brief Infinite perspective projection.
+ *
+ * With `reverse_z` clip depth is `near` (depth 1) at the near plane and
+ * tends to 0 at infinity, for a [0, 1] clip depth range. Otherwise it is the
+ * usual [-1, 1] mapping with the far plane at infinity.
+ */
+static inline void m_skr_perspective_infinite(const float fovy,
+                                              const float aspect,
+                                              const float near,
+                                              const bool  reverse_z,
+                                              mat4        dest) {
+	const float f = 1.0f / tanf(fovy * 0.5f);
+
+	glm_mat4_zero(dest);
+	dest[0][0] = f / aspect;
+	dest[1][1] = f;
+	dest[2][3] = -1.0f;
+
+	if (reverse_z) {
+		dest[3][2] = near;
+	} else {
+		dest[2][2] = -1.0f;
+		dest[3][2] = -2.0f * near;
+	}
+}
+
+/**
+ * @internal
+ * @brief Store row `a` plus `sign` times row `b` of `m` as a unit plane.
+ *
+ * `b` < 0 selects row `a` alone. Degenerate planes (the far plane at
+ * infinity) become an always-passing plane.
+ */
+static inline void m_skr_frustum_plane(mat4 m, const int a, const int b,
+                                       const float sign, vec4 dest) {
+	for (int i = 0; i < 4; ++i)
+		dest[i] = m[i][a] + (b >= 0 ? sign * m[i][b] : 0.0f);
+
+	const float len = glm_vec3_norm(dest);
+	if (len > 1e-6f) {
+		glm_vec4_scale(dest, 1.0f / len, dest);
+	} else {
+		glm_vec4_zero(dest);
+		dest[3] = 1.0f;
+	}
+}
+
+/**
+ * @brief Build the matrices and frustum of `c` if it changed.
+ *
+ * @param aspect Viewport width over height.
+ * @return 1 if `v` was recomputed, 0 if it was up to date.
+ */
+SKR_API int skr_view_update(SkrView* v, const SkrCamera* c,
+                            const float aspect) {
+	if (v->Valid && v->Aspect == aspect &&
+	    memcmp(&v->Source, c, sizeof(*c)) == 0)
+		return 0;
+
+	const float near = c->Near > 0.0f ? c->Near : 0.1f;
+	const float zoom = c->Zoom > 0.0f ? c->Zoom : 1.0f;
+	mat4        vp;
+
+	glm_look((float*)c->Position, (float*)c->Front, (float*)c->Up,
+	         v->View);
+	m_skr_perspective_infinite(glm_rad(c->FOV / zoom), aspect, near,
+	                           v->ReverseZ, v->Projection);
+	glm_mat4_mul(v->Projection, v->View, v->Unjittered);
+
+	/* Offset clip x and y by Jitter * w, so NDC moves by Jitter. */
+	for (int i = 0; i < 4; ++i) {
+		v->Projection[i][0] += v->Jitter[0] * v->Projection[i][3];
+		v->Projection[i][1] += v->Jitter[1] * v->Projection[i][3];
+	}
+	glm_mat4_mul(v->Projection, v->View, v->ViewProjection);
+
+	glm_mat4_copy(v->View, v->InverseView);
+	glm_inv_tr(v->InverseView);
+	glm_mat4_inv(v->ViewProjection, v->InverseViewProjection);
+	glm_vec3_copy((float*)c->Position, v->Position);
+
+	/* Gribb/Hartmann: planes are sums of clip matrix rows. */
+	glm_mat4_copy(v->Unjittered, vp);
+	m_skr_frustum_plane(vp, 3, 0, 1.0f, v->Planes[0]);
+	m_skr_frustum_plane(vp, 3, 0, -1.0f, v->Planes[1]);
+	m_skr_frustum_plane(vp, 3, 1, 1.0f, v->Planes[2]);
+	m_skr_frustum_plane(vp, 3, 1, -1.0f, v->Planes[3]);
+	if (v->ReverseZ) {
+		m_skr_frustum_plane(vp, 3, 2, -1.0f, v->Planes[4]);
+		m_skr_frustum_plane(vp, 2, -1, 0.0f, v->Planes[5]);
+	} else {
+		m_skr_frustum_plane(vp, 3, 2, 1.0f, v->Planes[4]);
+		m_skr_frustum_plane(vp, 3, 2, -1.0f, v->Planes[5]);
+	}
+
+	v->Source = *c;
+	v->Aspect = aspect;
+	v->Valid = true;
+	v->Version++;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Blend two cameras, `alpha` = 0 gives `a`, 1 gives `b`.
+ *
+ * Orientation vectors are linearly blended and renormalized, which is exact
+ * enough for the small rotations between two steps.
+ */
+static inline void m_skr_camera_interpolate(const SkrCamera* a,
+                                            const SkrCamera* b,
+                                            const float alpha, SkrCamera* out) {
+	*out = *b;
+
+	glm_vec3_lerp((float*)a->Position, (float*)b->Position, alpha,
+	              out->Position);
+	glm_vec3_lerp((float*)a->Front, (float*)b->Front, alpha, out->Front);
+	glm_vec3_lerp((float*)a->Up, (float*)b->Up, alpha, out->Up);
+	glm_vec3_normalize(out->Front);
+	glm_vec3_normalize(out->Up);
+	glm_vec3_cross(out->Front, out->Up, out->Right);
+	glm_vec3_normalize(out->Right);
+
+	out->Yaw = glm_lerp(a->Yaw, b->Yaw, alpha);
+	out->Pitch = glm_lerp(a->Pitch, b->Pitch, alpha);
+	out->FOV = glm_lerp(a->FOV, b->FOV, alpha);
+	out->Zoom = glm_lerp(a->Zoom, b->Zoom, alpha);
+}
+
+/**
+ * @internal
+ * @brief Allocate `size` bytes aligned to `align` (a power of two).
+ *
+ * cglm's SIMD paths use aligned loads on mat4/versor, which plain malloc does
+ * not guarantee for AVX. Free with ::m_skr_aligned_free.
+ */
+static inline void* m_skr_aligned_alloc(const size_t size, const size_t align) {
+#if defined(_MSC_VER)
+	return _aligned_malloc(size, align);
+#else
+	/* aligned_alloc requires size to be a multiple of align. */
+	return aligned_alloc(align, (size + align - 1) & ~(align - 1));
+#endif
+}
+
+/**
+ * @internal
+ * @brief Free memory from ::m_skr_aligned_alloc.
+ */
+static inline void m_skr_aligned_free(void* p) {
+#if defined(_MSC_VER)
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+/**
+ * @internal
+ * @brief Grow an aligned array, keeping its first `old_size` bytes.
+ *
+ * @return The new array, or NULL (with `p` untouched) on failure.
+ */
+static inline void* m_skr_aligned_grow(void* p, const size_t old_size,
+                                       const size_t new_size,
+                                       const size_t align) {
+	void* n = m_skr_aligned_alloc(new_size, align);
+	if (!n)
+		return NULL;
+
+	if (p)
+		memcpy(n, p, old_size);
+	m_skr_aligned_free(p);
+	return n;
+}
+
+/**
+ * @internal
+ * @brief Compose a TRS transform into an affine matrix.
+ */
+static inline void m_skr_trs_mat4(const vec3 t, const versor r, const vec3 s,
+                                  mat4 dest) {
+	glm_quat_mat4((float*)r, dest);
+	glm_vec4_scale(dest[0], s[0], dest[0]);
+	glm_vec4_scale(dest[1], s[1], dest[1]);
+	glm_vec4_scale(dest[2], s[2], dest[2]);
+	dest[3][0] = t[0];
+	dest[3][1] = t[1];
+	dest[3][2] = t[2];
+	dest[3][3] = 1.0f;
+}
+
+/**
+ * @internal
+ * @brief Grow every per-slot array of `scene` to hold `capacity` nodes.
+ *
+ * @return 1 on success, 0 on allocation failure.
+ */
+static inline int m_skr_scene_reserve(SkrScene* scene, unsigned int capacity) {
+	if (capacity <= scene->Capacity)
+		return 1;
+
+	const size_t old = scene->Capacity;
+	const size_t cap = capacity;
+
+#define M_SKR_SCENE_GROW(field, type, align)                                   \
+	do {                                                                   \
+		type* grown = (type*)m_skr_aligned_grow(                       \
+		        scene->field, old * sizeof(type), cap * sizeof(type),  \
+		        align);                                                \
+		if (!grown)                                                    \
+			goto fail;                                             \
+		scene->field = grown;                                          \
+	} while (0)
+
+	M_SKR_SCENE_GROW(Parent, unsigned int, 16);
+	M_SKR_SCENE_GROW(FirstChild, unsigned int, 16);
+	M_SKR_SCENE_GROW(NextSibling, unsigned int, 16);
+	M_SKR_SCENE_GROW(Depth, unsigned int, 16);
+	M_SKR_SCENE_GROW(Node, SkrNode, 16);
+	M_SKR_SCENE_GROW(Position, vec3, 16);
+	M_SKR_SCENE_GROW(Rotation, versor, 32);
+	M_SKR_SCENE_GROW(Scale, vec3, 16);
+	M_SKR_SCENE_GROW(World, mat4, 32);
+	M_SKR_SCENE_GROW(Dirty, unsigned char, 16);
+	M_SKR_SCENE_GROW(DirtyList, unsigned int, 16);
+	M_SKR_SCENE_GROW(PrevPosition, vec3, 16);
+	M_SKR_SCENE_GROW(PrevRotation, versor, 32);
+	M_SKR_SCENE_GROW(PrevScale, vec3, 16);
+	M_SKR_SCENE_GROW(Moving, unsigned char, 16);
+	M_SKR_SCENE_GROW(MovingList, unsigned int, 16);
+
+	/* Handles are 1-based, slot 0 of `Slot` is unused. */
+	unsigned int* slots = (unsigned int*)realloc(
+	        scene->Slot, (cap + 1) * sizeof(unsigned int));
+	if (!slots)
+		goto fail;
+	scene->Slot = slots;
+
+#undef M_SKR_SCENE_GROW
+
+	scene->Capacity = capacity;
+	return 1;
+
+fail:
+	m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+	                     "failed to grow scene to %u nodes", capacity);
+	return 0;
+}
+
+/**
+ * @internal
+ * @brief Queue `slot` for a world matrix update of its subtree.
+ */
+static inline void m_skr_scene_mark_dirty(SkrScene* scene, unsigned int slot) {
+	if (scene->Dirty[slot])
+		return;
+
+	scene->Dirty[slot] = 1;
+	scene->DirtyList[scene->DirtyCount++] = slot;
+}
+
+/**
+ * @internal
+ * @brief Make the current local transform of `slot` its Prev* values.
+ */
+static inline void m_skr_scene_settle(SkrScene* scene, unsigned int slot) {
+	glm_vec3_copy(scene->Position[slot], scene->PrevPosition[slot]);
+	glm_vec4_copy(scene->Rotation[slot], scene->PrevRotation[slot]);
+	glm_vec3_copy(scene->Scale[slot], scene->PrevScale[slot]);
+}
+
+/**
+ * @internal
+ * @brief Record that `slot` changed during the current simulation step.
+ *
+ * Its Prev* values still hold the state at the start of the step. Without
+ * interpolation they follow the change, so a later first interpolated
+ * move starts from where the node was placed.
+ */
+static inline void m_skr_scene_mark_moving(SkrScene* scene,
+                                           unsigned int slot) {
+	if (!scene->Interpolate) {
+		m_skr_scene_settle(scene, slot);
+		return;
+	}
+	if (scene->Moving[slot])
+		return;
+
+	scene->Moving[slot] = 1;
+	scene->MovingList[scene->MovingCount++] = slot;
+}
+
+/**
+ * @brief Create a transform node.
+ *
+ * The node starts with an identity local transform.
+ *
+ * @param scene  Scene to add the node to.
+ * @param parent Parent node, 0 for a root.
+ *
+ * @return Handle of the new node, 0 on failure.
+ */
+SKR_API SkrNode skr_scene_node_create(SkrScene* scene, SkrNode parent) {
+	if (!scene || parent > scene->Count) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "invalid scene or parent %u", parent);
+		return 0;
+	}
+
+	if (scene->Count == scene->Capacity &&
+	    !m_skr_scene_reserve(scene,
+	                         scene->Capacity ? scene->Capacity * 2 : 64))
+		return 0;
+
+	const unsigned int slot = scene->Count++;
+	const SkrNode      node = scene->Count;
+
+	const unsigned int parent_slot =
+	        parent ? scene->Slot[parent] : SKR_SCENE_NONE;
+
+	scene->Parent[slot] = parent_slot;
+	scene->FirstChild[slot] = SKR_SCENE_NONE;
+	scene->NextSibling[slot] = SKR_SCENE_NONE;
+	scene->Depth[slot] = parent ? scene->Depth[parent_slot] + 1 : 0;
+	scene->Node[slot] = node;
+	scene->Slot[node] = slot;
+
+	if (parent) {
+		scene->NextSibling[slot] = scene->FirstChild[parent_slot];
+		scene->FirstChild[parent_slot] = slot;
+	}
+
+	glm_vec3_zero(scene->Position[slot]);
+	glm_quat_identity(scene->Rotation[slot]);
+	glm_vec3_one(scene->Scale[slot]);
+	m_skr_scene_settle(scene, slot);
+	scene->Moving[slot] = 0;
+	scene->Dirty[slot] = 0;
+	m_skr_scene_mark_dirty(scene, slot);
+
+	if (slot > 0 && scene->Depth[slot] < scene->Depth[slot - 1])
+		scene->Unsorted = true;
+
+	return node;
+}
+
+/**
+ * @brief Move `node` (and its subtree) under `parent`.
+ *
+ * @param parent New parent, 0 to make `node` a root.
+ *
+ * @return 1 on success, 0 if a handle is invalid or `parent` is inside the
+ *         subtree of `node`.
+ */
+SKR_API int skr_scene_node_set_parent(SkrScene* scene, SkrNode node,
+                                      SkrNode parent) {
+	if (!scene || !node || node > scene->Count || parent > scene->Count) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "invalid scene or node %u", node);
+		return 0;
+	}
+
+	const unsigned int slot = scene->Slot[node];
+	const unsigned int parent_slot =
+	        parent ? scene->Slot[parent] : SKR_SCENE_NONE;
+
+	for (unsigned int p = parent_slot; p != SKR_SCENE_NONE;
+	     p = scene->Parent[p]) {
+		if (p == slot) {
+			m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+			                     "node %u would parent itself",
+			                     node);
+			return 0;
+		}
+	}
+
+	/* Unlink from the old parent's child list. */
+	const unsigned int old = scene->Parent[slot];
+	if (old != SKR_SCENE_NONE) {
+		unsigned int* link = &scene->FirstChild[old];
+		while (*link != slot)
+			link = &scene->NextSibling[*link];
+		*link = scene->NextSibling[slot];
+	}
+
+	scene->Parent[slot] = parent_slot;
+	scene->NextSibling[slot] = SKR_SCENE_NONE;
+	if (parent_slot != SKR_SCENE_NONE) {
+		scene->NextSibling[slot] = scene->FirstChild[parent_slot];
+		scene->FirstChild[parent_slot] = slot;
+	}
+
+	/* Re-depth the subtree, the depth order is restored lazily. */
+	const unsigned int base =
+	        parent_slot == SKR_SCENE_NONE ? 0 : scene->Depth[parent_slot] + 1;
+	const int shift = (int)base - (int)scene->Depth[slot];
+
+	unsigned int cur = slot;
+	while (cur != SKR_SCENE_NONE) {
+		scene->Depth[cur] = (unsigned int)((int)scene->Depth[cur] + shift);
+
+		if (scene->FirstChild[cur] != SKR_SCENE_NONE) {
+			cur = scene->FirstChild[cur];
+			continue;
+		}
+		while (cur != slot && scene->NextSibling[cur] == SKR_SCENE_NONE)
+			cur = scene->Parent[cur];
+		cur = cur == slot ? SKR_SCENE_NONE : scene->NextSibling[cur];
+	}
+
+	/* Blending across parents makes no sense, the node snaps. */
+	m_skr_scene_settle(scene, slot);
+	scene->Unsorted = true;
+	m_skr_scene_mark_dirty(scene, slot);
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Check that `node` is a live handle of `scene`.
+ *
+ * @return 1 if valid, 0 with the last error set otherwise.
+ */
+static inline int m_skr_scene_node_valid(const SkrScene* scene,
+                                         const SkrNode   node) {
+	if (!scene || !node || node > scene->Count) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "invalid scene or node %u", node);
+		return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Set the local translation of `node`.
+ *
+ * @return 1 on success, 0 if the handle is invalid.
+ */
+SKR_API int skr_scene_node_set_position(SkrScene* scene, SkrNode node,
+                                        const vec3 position) {
+	if (!m_skr_scene_node_valid(scene, node))
+		return 0;
+
+	const unsigned int slot = scene->Slot[node];
+	glm_vec3_copy((float*)position, scene->Position[slot]);
+	m_skr_scene_mark_moving(scene, slot);
+	m_skr_scene_mark_dirty(scene, slot);
+	return 1;
+}
+
+/**
+ * @brief Set the local rotation of `node`.
+ *
+ * @return 1 on success, 0 if the handle is invalid.
+ */
+SKR_API int skr_scene_node_set_rotation(SkrScene* scene, SkrNode node,
+                                        const versor rotation) {
+	if (!m_skr_scene_node_valid(scene, node))
+		return 0;
+
+	const unsigned int slot = scene->Slot[node];
+	glm_vec4_copy((float*)rotation, scene->Rotation[slot]);
+	m_skr_scene_mark_moving(scene, slot);
+	m_skr_scene_mark_dirty(scene, slot);
+	return 1;
+}
+
+/**
+ * @brief Set the local scale of `node`.
+ *
+ * @return 1 on success, 0 if the handle is invalid.
+ */
+SKR_API int skr_scene_node_set_scale(SkrScene* scene, SkrNode node,
+                                     const vec3 scale) {
+	if (!m_skr_scene_node_valid(scene, node))
+		return 0;
+
+	const unsigned int slot = scene->Slot[node];
+	glm_vec3_copy((float*)scale, scene->Scale[slot]);
+	m_skr_scene_mark_moving(scene, slot);
+	m_skr_scene_mark_dirty(scene, slot);
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Restore depth order with a stable counting sort.
+ *
+ * Permutes every per-slot array and remaps slot links, handles and the dirty
+ * list. Stability keeps siblings in creation order.
+ *
+ * @return 1 on success, 0 on allocation failure (scene left unsorted).
+ */
+static inline int m_skr_scene_sort(SkrScene* scene) {
+	const unsigned int n = scene->Count;
+
+	unsigned int max_depth = 0;
+	for (unsigned int i = 0; i < n; ++i)
+		if (scene->Depth[i] > max_depth)
+			max_depth = scene->Depth[i];
+
+	unsigned int* offsets =
+	        (unsigned int*)calloc(max_depth + 2, sizeof(unsigned int));
+	unsigned int* to = (unsigned int*)malloc(n * sizeof(unsigned int));
+	SkrScene      tmp = {0};
+	if (!offsets || !to || !m_skr_scene_reserve(&tmp, scene->Capacity)) {
+		free(offsets);
+		free(to);
+		skr_scene_free(&tmp);
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to sort scene");
+		return 0;
+	}
+
+	for (unsigned int i = 0; i < n; ++i)
+		offsets[scene->Depth[i] + 1]++;
+	for (unsigned int d = 1; d <= max_depth + 1; ++d)
+		offsets[d] += offsets[d - 1];
+	for (unsigned int i = 0; i < n; ++i)
+		to[i] = offsets[scene->Depth[i]]++;
+
+#define M_SKR_REMAP(link)                                                      \
+	((link) == SKR_SCENE_NONE ? SKR_SCENE_NONE : to[(link)])
+
+	for (unsigned int i = 0; i < n; ++i) {
+		const unsigned int j = to[i];
+		tmp.Parent[j] = M_SKR_REMAP(scene->Parent[i]);
+		tmp.FirstChild[j] = M_SKR_REMAP(scene->FirstChild[i]);
+		tmp.NextSibling[j] = M_SKR_REMAP(scene->NextSibling[i]);
+		tmp.Depth[j] = scene->Depth[i];
+		tmp.Node[j] = scene->Node[i];
+		glm_vec3_copy(scene->Position[i], tmp.Position[j]);
+		glm_vec4_copy(scene->Rotation[i], tmp.Rotation[j]);
+		glm_vec3_copy(scene->Scale[i], tmp.Scale[j]);
+		glm_mat4_copy(scene->World[i], tmp.World[j]);
+		tmp.Dirty[j] = scene->Dirty[i];
+		glm_vec3_copy(scene->PrevPosition[i], tmp.PrevPosition[j]);
+		glm_vec4_copy(scene->PrevRotation[i], tmp.PrevRotation[j]);
+		glm_vec3_copy(scene->PrevScale[i], tmp.PrevScale[j]);
+		tmp.Moving[j] = scene->Moving[i];
+		scene->Slot[scene->Node[i]] = j;
+	}
+
+	for (unsigned int i = 0; i < scene->DirtyCount; ++i)
+		tmp.DirtyList[i] = to[scene->DirtyList[i]];
+	for (unsigned int i = 0; i < scene->MovingCount; ++i)
+		tmp.MovingList[i] = to[scene->MovingList[i]];
+
+#undef M_SKR_REMAP
+
+	tmp.Count = n;
+	tmp.DirtyCount = scene->DirtyCount;
+	tmp.MovingCount = scene->MovingCount;
+	tmp.Interpolate = scene->Interpolate;
+	tmp.Alpha = scene->Alpha;
+	/* Handles keep their slot array, only its entries were remapped. */
+	free(tmp.Slot);
+	tmp.Slot = scene->Slot;
+	scene->Slot = NULL;
+
+	skr_scene_free(scene);
+	*scene = tmp;
+
+	free(offsets);
+	free(to);
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Order slots ascending, for qsort.
+ */
+static inline int m_skr_slot_compare(const void* a, const void* b) {
+	const unsigned int x = *(const unsigned int*)a;
+	const unsigned int y = *(const unsigned int*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @internal
+ * @brief Recompute the world matrix of one slot from its parent.
+ */
+static inline void m_skr_scene_compute(SkrScene* scene, unsigned int slot) {
+	mat4 local;
+
+	if (scene->Moving[slot]) {
+		const float a = scene->Alpha;
+		vec3        t, sc;
+		versor      r;
+		glm_vec3_lerp(scene->PrevPosition[slot], scene->Position[slot],
+		              a, t);
+		glm_quat_nlerp(scene->PrevRotation[slot], scene->Rotation[slot],
+		               a, r);
+		glm_vec3_lerp(scene->PrevScale[slot], scene->Scale[slot], a, sc);
+		m_skr_trs_mat4(t, r, sc, local);
+	} else {
+		m_skr_trs_mat4(scene->Position[slot], scene->Rotation[slot],
+		               scene->Scale[slot], local);
+	}
+
+	const unsigned int parent = scene->Parent[slot];
+	if (parent == SKR_SCENE_NONE)
+		glm_mat4_copy(local, scene->World[slot]);
+	else
+		glm_mul(scene->World[parent], local, scene->World[slot]);
+
+	scene->Dirty[slot] = 0;
+}
+
+/**
+ * @brief Recompute world matrices of every changed subtree.
+ *
+ * Cost is proportional to the number of nodes below changed nodes, not to
+ * the size of the scene. Affine 4x4 products go through cglm's glm_mul, which
+ * is SIMD (SSE/AVX/NEON) where available.
+ */
+SKR_API void skr_scene_update(SkrScene* scene) {
+	if (!scene->DirtyCount)
+		return;
+
+	if (scene->Unsorted && m_skr_scene_sort(scene))
+		scene->Unsorted = false;
+
+	/*
+	 * Ascending slots visit ancestors before descendants (parents precede
+	 * children), so a dirty node inside an already updated subtree is
+	 * found clean and skipped.
+	 */
+	if (scene->DirtyCount > 1)
+		qsort(scene->DirtyList, scene->DirtyCount, sizeof(unsigned int),
+		      m_skr_slot_compare);
+
+	for (unsigned int i = 0; i < scene->DirtyCount; ++i) {
+		const unsigned int root = scene->DirtyList[i];
+		if (!scene->Dirty[root])
+			continue;
+
+		m_skr_scene_compute(scene, root);
+
+		/* Pre-order walk of the subtree through the sibling links. */
+		unsigned int cur = scene->FirstChild[root];
+		while (cur != SKR_SCENE_NONE) {
+			m_skr_scene_compute(scene, cur);
+
+			if (scene->FirstChild[cur] != SKR_SCENE_NONE) {
+				cur = scene->FirstChild[cur];
+				continue;
+			}
+			while (cur != root &&
+			       scene->NextSibling[cur] == SKR_SCENE_NONE)
+				cur = scene->Parent[cur];
+			cur = cur == root ? SKR_SCENE_NONE
+			                  : scene->NextSibling[cur];
+		}
+	}
+
+	scene->DirtyCount = 0;
+}
+
+/**
+ * @brief Start a simulation step.
+ *
+ * Nodes that moved during the previous step settle: their current local
+ * transform becomes the step's starting point.
+ */
+SKR_API void skr_scene_step_begin(SkrScene* scene) {
+	for (unsigned int i = 0; i < scene->MovingCount; ++i) {
+		const unsigned int slot = scene->MovingList[i];
+
+		m_skr_scene_settle(scene, slot);
+		scene->Moving[slot] = 0;
+		m_skr_scene_mark_dirty(scene, slot);
+	}
+
+	scene->MovingCount = 0;
+}
+
+/**
+ * @brief Set the blend factor between the last two simulation steps.
+ *
+ * Only subtrees below nodes that moved during the last step are recomputed
+ * by the next ::skr_scene_update.
+ */
+SKR_API void skr_scene_interpolate(SkrScene* scene, float alpha) {
+	scene->Alpha = alpha;
+
+	for (unsigned int i = 0; i < scene->MovingCount; ++i)
+		m_skr_scene_mark_dirty(scene, scene->MovingList[i]);
+}
+
+/**
+ * @brief Release every array of `scene` and reset it.
+ */
+SKR_API void skr_scene_free(SkrScene* scene) {
+	if (!scene)
+		return;
+
+	m_skr_aligned_free(scene->Parent);
+	m_skr_aligned_free(scene->FirstChild);
+	m_skr_aligned_free(scene->NextSibling);
+	m_skr_aligned_free(scene->Depth);
+	m_skr_aligned_free(scene->Node);
+	m_skr_aligned_free(scene->Position);
+	m_skr_aligned_free(scene->Rotation);
+	m_skr_aligned_free(scene->Scale);
+	m_skr_aligned_free(scene->World);
+	m_skr_aligned_free(scene->Dirty);
+	m_skr_aligned_free(scene->DirtyList);
+	m_skr_aligned_free(scene->PrevPosition);
+	m_skr_aligned_free(scene->PrevRotation);
+	m_skr_aligned_free(scene->PrevScale);
+	m_skr_aligned_free(scene->Moving);
+	m_skr_aligned_free(scene->MovingList);
+	free(scene->Slot);
+
+	*scene = (SkrScene){0};
+}
+
+/**
+ * @internal
+ * @brief Grow every column of `r` to hold `capacity` rows.
+ *
+ * @return 1 on success, 0 on allocation failure.
+ */
+static inline int m_skr_renderables_reserve(SkrRenderables* r,
+                                            unsigned int    capacity) {
+	if (capacity <= r->Capacity)
+		return 1;
+
+	const size_t old = r->Capacity;
+	const size_t cap = capacity;
+
+#define M_SKR_RENDERABLES_GROW(field, type, align)                             \
+	do {                                                                   \
+		type* grown = (type*)m_skr_aligned_grow(                       \
+		        r->field, old * sizeof(type), cap * sizeof(type),      \
+		        align);                                                \
+		if (!grown) {                                                  \
+			m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,          \
+			                     "failed to grow renderables");    \
+			return 0;                                              \
+		}                                                              \
+		r->field = grown;                                              \
+	} while (0)
+
+	M_SKR_RENDERABLES_GROW(Node, SkrNode, 16);
+	M_SKR_RENDERABLES_GROW(LocalBounds, vec4, 32);
+	M_SKR_RENDERABLES_GROW(Bounds, vec4, 32);
+	M_SKR_RENDERABLES_GROW(Mesh, SkrMesh*, 16);
+	M_SKR_RENDERABLES_GROW(Material, SkrMaterial*, 16);
+	M_SKR_RENDERABLES_GROW(Flags, unsigned int, 16);
+	M_SKR_RENDERABLES_GROW(Skin, int, 16);
+	M_SKR_RENDERABLES_GROW(Skinned, unsigned int, 16);
+	M_SKR_RENDERABLES_GROW(Morph, int, 16);
+	M_SKR_RENDERABLES_GROW(Previous, mat4, 32);
+	M_SKR_RENDERABLES_GROW(Handle, SkrRenderable, 16);
+	M_SKR_RENDERABLES_GROW(Row, unsigned int, 16);
+	M_SKR_RENDERABLES_GROW(Free, SkrRenderable, 16);
+	M_SKR_RENDERABLES_GROW(Draws, SkrDrawItem, 16);
+	M_SKR_RENDERABLES_GROW(Transparent, SkrDrawItem, 16);
+
+#undef M_SKR_RENDERABLES_GROW
+
+	r->Capacity = capacity;
+	return 1;
+}
+
+/**
+ * @brief Add a renderable row.
+ *
+ * @param node     Transform node, 0 for identity.
+ * @param mesh     Geometry (must not be NULL).
+ * @param material Shading state (must not be NULL).
+ * @param bounds   Object-space bounding sphere (center xyz, radius w).
+ * @param flags    ::SkrRenderableFlags.
+ *
+ * @return Row index, -1 on failure.
+ */
+SKR_API int skr_renderables_add(SkrRenderables* r, SkrNode node,
+                                SkrMesh* mesh, SkrMaterial* material,
+                                const vec4 bounds, unsigned int flags) {
+	if (!r || !mesh || !material) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "renderable needs a mesh and a material");
+		return -1;
+	}
+
+	if (r->Count == r->Capacity &&
+	    !m_skr_renderables_reserve(r, r->Capacity ? r->Capacity * 2 : 64))
+		return -1;
+
+	const unsigned int i = r->Count++;
+	r->Node[i] = node;
+	glm_vec4_copy((float*)bounds, r->LocalBounds[i]);
+	glm_vec4_copy((float*)bounds, r->Bounds[i]);
+	r->Mesh[i] = mesh;
+	r->Material[i] = material;
+	r->Flags[i] = flags;
+	r->Skin[i] = -1;
+	r->Skinned[i] = 0;
+	r->Morph[i] = -1;
+	glm_mat4_zero(r->Previous[i]);
+
+	/* Live and free handles never outnumber the rows allocated. */
+	const SkrRenderable handle =
+	        r->FreeCount ? r->Free[--r->FreeCount] : i + 1;
+	r->Handle[i] = handle;
+	r->Row[handle - 1] = i;
+
+	return (int)i;
+}
+
+/**
+ * @brief Remove row `index`, moving the last row into its place.
+ */
+SKR_API void skr_renderables_remove(SkrRenderables* r, unsigned int index) {
+	if (!r || index >= r->Count)
+		return;
+
+	const unsigned int last = --r->Count;
+	r->Free[r->FreeCount++] = r->Handle[index];
+	if (index == last)
+		return;
+
+	r->Node[index] = r->Node[last];
+	glm_vec4_copy(r->LocalBounds[last], r->LocalBounds[index]);
+	glm_vec4_copy(r->Bounds[last], r->Bounds[index]);
+	r->Mesh[index] = r->Mesh[last];
+	r->Material[index] = r->Material[last];
+	r->Flags[index] = r->Flags[last];
+	r->Skin[index] = r->Skin[last];
+	r->Skinned[index] = r->Skinned[last];
+	r->Morph[index] = r->Morph[last];
+	glm_mat4_copy(r->Previous[last], r->Previous[index]);
+	r->Handle[index] = r->Handle[last];
+	r->Row[r->Handle[index] - 1] = index;
+}
+
+/**
+ * @brief Stable handle of row `index`, 0 if out of range.
+ */
+SKR_API SkrRenderable skr_renderables_handle(const SkrRenderables* r,
+                                             const unsigned int    index) {
+	return r && index < r->Count ? r->Handle[index] : 0;
+}
+
+/**
+ * @brief Current row of `handle`, -1 if it was removed or is 0.
+ */
+SKR_API int skr_renderables_row(const SkrRenderables* r,
+                                const SkrRenderable   handle) {
+	if (!r || handle == 0 || handle > r->Capacity)
+		return -1;
+
+	const unsigned int row = r->Row[handle - 1];
+	return row < r->Count && r->Handle[row] == handle ? (int)row : -1;
+}
+
+/**
+ * @brief Transform every local bounding sphere to world space.
+ *
+ * The radius is scaled by the largest axis scale of the world matrix.
+ */
+SKR_API void skr_renderables_update_bounds(SkrRenderables* r,
+                                           const SkrScene* scene) {
+	for (unsigned int i = 0; i < r->Count; ++i) {
+		const SkrNode node = r->Node[i];
+		if (!node)
+			continue;
+
+		vec4* m = scene->World[scene->Slot[node]];
+		float* local = r->LocalBounds[i];
+
+		vec4 center = {local[0], local[1], local[2], 1.0f};
+		glm_mat4_mulv(m, center, r->Bounds[i]);
+
+		const float sx = glm_vec3_norm2(m[0]);
+		const float sy = glm_vec3_norm2(m[1]);
+		const float sz = glm_vec3_norm2(m[2]);
+		r->Bounds[i][3] = local[3] * sqrtf(glm_max(sx, glm_max(sy, sz)));
+	}
+}
+
+/**
+ * @brief Collect visible renderables into SkrRenderables::Draws, or
+ * SkrRenderables::Transparent for ::SKR_RENDERABLE_TRANSPARENT rows.
+ *
+ * A renderable is drawn when it has ::SKR_RENDERABLE_VISIBLE and its world
+ * bounding sphere is not fully behind any of `planes`.
+ *
+ * @param planes Frustum planes (xyz normal pointing inside, w distance), or
+ *               NULL to skip frustum culling.
+ *
+ * @return Number of draws, opaque and transparent.
+ */
+SKR_API unsigned int skr_renderables_cull(SkrRenderables* r,
+                                          const vec4      planes[6]) {
+	unsigned int n = 0, t = 0;
+
+	for (unsigned int i = 0; i < r->Count; ++i) {
+		if (!(r->Flags[i] & SKR_RENDERABLE_VISIBLE))
+			continue;
+
+		if (planes) {
+			const float* b = r->Bounds[i];
+			int          inside = 1;
+			for (int p = 0; p < 6; ++p) {
+				const float d = planes[p][0] * b[0] +
+				                planes[p][1] * b[1] +
+				                planes[p][2] * b[2] + planes[p][3];
+				inside &= d >= -b[3];
+			}
+			if (!inside)
+				continue;
+		}
+
+		SkrDrawItem* draw = r->Flags[i] & SKR_RENDERABLE_TRANSPARENT
+		                            ? &r->Transparent[t++]
+		                            : &r->Draws[n++];
+		*draw = (SkrDrawItem){r->Material[i], r->Mesh[i], i, 0, 0};
+	}
+
+	r->DrawCount = n;
+	r->TransparentCount = t;
+	return n + t;
+}
+
+/**
+ * @internal
+ * @brief Grow SkrRenderables::Runs to hold `count` runs.
+ *
+ * @return 1 on success, 0 on allocation failure.
+ */
+static inline int m_skr_renderables_reserve_runs(SkrRenderables*    r,
+                                                 const unsigned int count) {
+	if (count <= r->RunCapacity)
+		return 1;
+
+	unsigned int capacity = r->RunCapacity ? r->RunCapacity : 256;
+	while (capacity < count)
+		capacity *= 2;
+
+	unsigned int* grown = (unsigned int*)realloc(
+	        r->Runs, (size_t)capacity * 2 * sizeof(unsigned int));
+	if (!grown) {
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to grow cluster runs");
+		return 0;
+	}
+
+	r->Runs = grown;
+	r->RunCapacity = capacity;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Whether `m` mirrors, flipping the winding of what it draws.
+ */
+static inline bool m_skr_mat4_mirrors(mat4 m) {
+	vec3 c;
+	glm_vec3_cross(m[0], m[1], c);
+	return glm_vec3_dot(c, m[2]) < 0.0f;
+}
+
+/**
+ * @brief Cull the clusters of the draws in SkrRenderables::Draws.
+ *
+ * A cluster is dropped when its sphere is outside the frustum of `v`.
+ * For materials with SkrMaterial::CullBackFaces it is also dropped when
+ * its normal cone shows every triangle in it back-facing from the eye.
+ * The clusters a draw keeps are merged into runs of contiguous indices
+ * in SkrRenderables::Runs, and draws with none left are removed.
+ * Skinned and morphed rows move away from their clusters and stay whole,
+ * and rows scaled unevenly or mirrored skip the cone test.
+ *
+ * @return Number of draws left.
+ */
+SKR_API unsigned int skr_renderables_cull_clusters(SkrRenderables* r,
+                                                   const SkrScene* scene,
+                                                   const SkrView*  v) {
+	unsigned int n = 0;
+
+	r->RunCount = 0;
+	r->ClusterCount = r->ClusterVisible = 0;
+	for (unsigned int d = 0; d < r->DrawCount; ++d) {
+		SkrDrawItem        draw = r->Draws[d];
+		const SkrMesh*     mesh = draw.Mesh;
+		const unsigned int i = draw.Index;
+
+		draw.FirstRun = r->RunCount;
+		draw.RunCount = 0;
+		const bool deformed = r->Skin[i] >= 0 || r->Morph[i] >= 0;
+		if (!mesh->ClusterCount || deformed ||
+		    !m_skr_renderables_reserve_runs(
+		            r, r->RunCount + mesh->ClusterCount)) {
+			r->Draws[n++] = draw;
+			continue;
+		}
+
+		mat4 model = GLM_MAT4_IDENTITY_INIT, inverse;
+		if (r->Node[i])
+			glm_mat4_copy(scene->World[scene->Slot[r->Node[i]]],
+			              model);
+		const float sx = glm_vec3_norm2(model[0]);
+		const float sy = glm_vec3_norm2(model[1]);
+		const float sz = glm_vec3_norm2(model[2]);
+		const float big = glm_max(sx, glm_max(sy, sz));
+		const float scale = sqrtf(big);
+		const bool  even = big - glm_min(sx, glm_min(sy, sz)) <=
+		                  big * 1e-3f;
+		const bool  cone = draw.Material->CullBackFaces && even &&
+		                  !m_skr_mat4_mirrors(model);
+
+		/* Cones are tested in object space, from the eye there. */
+		vec4 eye = {v->Position[0], v->Position[1], v->Position[2],
+		            1.0f};
+		glm_mat4_inv(model, inverse);
+		glm_mat4_mulv(inverse, eye, eye);
+
+		for (unsigned int c = 0; c < mesh->ClusterCount; ++c) {
+			const SkrCluster* k = &mesh->Clusters[c];
+			vec4 center = {k->Bounds[0], k->Bounds[1], k->Bounds[2],
+			               1.0f};
+			glm_mat4_mulv(model, center, center);
+
+			const float radius = k->Bounds[3] * scale;
+			int         inside = 1;
+			for (int p = 0; p < 6; ++p) {
+				float* plane = (float*)v->Planes[p];
+				inside &= glm_vec3_dot(plane, center) + plane[3] >=
+				          -radius;
+			}
+
+			if (inside && cone && k->Cone[3] < 1.0f) {
+				vec3 to;
+				glm_vec3_sub((float*)k->Bounds, eye, to);
+				const float sine = k->Cone[3];
+				inside = glm_vec3_dot(to, (float*)k->Cone) <
+				         sine * glm_vec3_norm(to) +
+				                 k->Bounds[3] * (1.0f + sine);
+			}
+			if (!inside)
+				continue;
+
+			unsigned int* run = &r->Runs[r->RunCount * 2];
+			if (draw.RunCount && run[-2] + run[-1] == k->First) {
+				run[-1] += k->Count;
+			} else {
+				run[0] = k->First;
+				run[1] = k->Count;
+				++r->RunCount;
+				++draw.RunCount;
+			}
+			++r->ClusterVisible;
+		}
+
+		r->ClusterCount += mesh->ClusterCount;
+		if (draw.RunCount)
+			r->Draws[n++] = draw;
+	}
+
+	r->DrawCount = n;
+	return n;
+}
+
+/**
+ * @internal
+ * @brief Order draws by material, then mesh, for qsort.
+ */
+static inline int m_skr_draw_compare(const void* a, const void* b) {
+	const SkrDrawItem* x = (const SkrDrawItem*)a;
+	const SkrDrawItem* y = (const SkrDrawItem*)b;
+
+	if (x->Material != y->Material)
+		return (uintptr_t)x->Material < (uintptr_t)y->Material ? -1 : 1;
+	if (x->Mesh != y->Mesh)
+		return (uintptr_t)x->Mesh < (uintptr_t)y->Mesh ? -1 : 1;
+	return (x->Index > y->Index) - (x->Index < y->Index);
+}
+
+/**
+ * @brief Sort the culled draws so equal materials and meshes are adjacent.
+ */
+SKR_API void skr_renderables_sort(SkrRenderables* r) {
+	if (r->DrawCount > 1)
+		qsort(r->Draws, r->DrawCount, sizeof(SkrDrawItem),
+		      m_skr_draw_compare);
+}
+
+/**
+ * @brief Order SkrRenderables::Transparent back to front.
+ *
+ * Each draw is keyed by the view depth of its bounds center, farthest
+ * first; equal depths keep their culling order.
+ *
+ * @param sort Radix sort scratch, grown as needed.
+ * @param jobs Pool to sort on, NULL for the calling thread.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+SKR_API int skr_renderables_sort_transparent(SkrRenderables* r,
+                                             const SkrView*  v,
+                                             SkrRadixSort*   sort,
+                                             SkrJobs*        jobs) {
+	if (!r || !v || !sort) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "transparent sort needs a view and sort");
+		return 0;
+	}
+
+	const unsigned int n = r->TransparentCount;
+	if (n < 2)
+		return 1;
+	if (!skr_radix_reserve(sort, r->Capacity))
+		return 0;
+
+	for (unsigned int k = 0; k < n; ++k) {
+		const unsigned int i = r->Transparent[k].Index;
+		const float*       b = r->Bounds[i];
+
+		/* The view looks down -z: depth is minus the view-space z. */
+		const float depth =
+		        -(v->View[0][2] * b[0] + v->View[1][2] * b[1] +
+		          v->View[2][2] * b[2] + v->View[3][2]);
+		sort->Keys[k] = ~skr_radix_float_key(depth);
+		sort->Values[k] = i;
+	}
+
+	skr_radix_sort(sort, n, jobs);
+
+	for (unsigned int k = 0; k < n; ++k) {
+		const unsigned int i = sort->Values[k];
+		r->Transparent[k] =
+		        (SkrDrawItem){r->Material[i], r->Mesh[i], i, 0, 0};
+	}
+	return 1;
+}
+
+/**
+ * @brief Release every column of `r` and reset it.
+ */
+SKR_API void skr_renderables_free(SkrRenderables* r) {
+	if (!r)
+		return;
+
+	m_skr_aligned_free(r->Node);
+	m_skr_aligned_free(r->LocalBounds);
+	m_skr_aligned_free(r->Bounds);
+	m_skr_aligned_free(r->Mesh);
+	m_skr_aligned_free(r->Material);
+	m_skr_aligned_free(r->Flags);
+	m_skr_aligned_free(r->Skin);
+	m_skr_aligned_free(r->Skinned);
+	m_skr_aligned_free(r->Morph);
+	m_skr_aligned_free(r->Previous);
+	m_skr_aligned_free(r->Handle);
+	m_skr_aligned_free(r->Row);
+	m_skr_aligned_free(r->Free);
+	m_skr_aligned_free(r->Draws);
+	m_skr_aligned_free(r->Transparent);
+	free(r->Runs);
+
+	*r = (SkrRenderables){0};
+}
+
+/**
+ * @brief Draw row `index` skinned by the palette starting at bone `base`.
+ *
+ * @param base Value returned by ::skr_skinning_alloc, -1 for rigid.
+ */
+SKR_API void skr_renderables_set_skin(SkrRenderables* r,
+                                      const unsigned int index,
+                                      const int base) {
+	if (r && index < r->Count)
+		r->Skin[index] = base;
+}
+
+/**
+ * @brief Draw row `index` with the morph weights of `instance`.
+ *
+ * @param instance Value returned by ::skr_morphs_alloc for the row's
+ *                 mesh, -1 for none.
+ */
+SKR_API void skr_renderables_set_morph(SkrRenderables* r,
+                                       const unsigned int index,
+                                       const int instance) {
+	if (r && index < r->Count)
+		r->Morph[index] = instance;
+}
+
+/**
+ * @brief Add a point light.
+ *
+ * @param radius Distance at which the light fades to nothing.
+ * @return Light index, or -1 on failure.
+ */
+SKR_API int skr_lights_add(SkrLights* l, const vec3 position,
+                           const float radius, const vec3 color,
+                           const float intensity) {
+	if (!l || radius <= 0.0f) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "light needs a positive radius");
+		return -1;
+	}
+
+	if (l->Count == l->Capacity) {
+		const unsigned int cap = l->Capacity ? l->Capacity * 2 : 64;
+
+		unsigned int* ranges = (unsigned int*)realloc(
+		        l->Ranges, cap * 6 * sizeof(unsigned int));
+		if (!ranges)
+			goto fail;
+		l->Ranges = ranges;
+
+		SkrPointLight* points = (SkrPointLight*)m_skr_aligned_grow(
+		        l->Points, l->Capacity * sizeof(SkrPointLight),
+		        cap * sizeof(SkrPointLight), 16);
+		if (!points)
+			goto fail;
+		l->Points = points;
+		l->Capacity = cap;
+	}
+
+	SkrPointLight* p = &l->Points[l->Count];
+	glm_vec4((float*)position, radius, p->Position);
+	glm_vec4((float*)color, intensity, p->Color);
+	return (int)l->Count++;
+
+fail:
+	m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY, "failed to grow lights");
+	return -1;
+}
+
+/**
+ * @brief Remove light `index`, moving the last light into its place.
+ */
+SKR_API void skr_lights_remove(SkrLights* l, const unsigned int index) {
+	if (!l || index >= l->Count)
+		return;
+
+	l->Points[index] = l->Points[--l->Count];
+}
+
+/**
+ * @internal
+ * @brief Depth slice containing view depth `z`.
+ */
+static inline unsigned int m_skr_cluster_slice(const SkrLights* l,
+                                               const float      z) {
+	if (z <= l->Near)
+		return 0;
+
+	const float slice = logf(z / l->Near) * l->Scale;
+	return slice >= SKR_CLUSTER_Z - 1 ? SKR_CLUSTER_Z - 1
+	                                  : (unsigned int)slice;
+}
+
+/**
+ * @internal
+ * @brief Tile containing normalized device coordinate `ndc` on an axis
+ * of `tiles` tiles.
+ */
+static inline unsigned int m_skr_cluster_tile(const float        ndc,
+                                              const unsigned int tiles) {
+	const float t = (ndc * 0.5f + 0.5f) * (float)tiles;
+	if (t <= 0.0f)
+		return 0;
+	return t >= (float)(tiles - 1) ? tiles - 1 : (unsigned int)t;
+}
+
+/**
+ * @brief Assign every light to the clusters of `view` it may reach.
+ *
+ * Each light's sphere is bounded by a view-space box whose corners are
+ * projected to get its tiles, and by its depth range to get its slices,
+ * which errs on the side of a few extra clusters. Lights are counted per
+ * cluster, the counts turned into offsets, then the indices written, so
+ * the result is grouped by cluster without sorting.
+ *
+ * @return 1 on success, 0 on allocation failure.
+ */
+SKR_API int skr_lights_bin(SkrLights* l, const SkrView* view) {
+	const float near = view->Source.Near > 0.0f ? view->Source.Near : 0.1f;
+	const float far = l->Far > near ? l->Far : 500.0f;
+	const float px = view->Projection[0][0];
+	const float py = view->Projection[1][1];
+
+	if (!l->Grid) {
+		l->Grid = (unsigned int*)malloc(SKR_CLUSTERS * 2 *
+		                                sizeof(unsigned int));
+		if (!l->Grid) {
+			m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+			                     "failed to allocate light grid");
+			return 0;
+		}
+	}
+
+	l->Near = near;
+	l->Scale = (float)SKR_CLUSTER_Z / logf(far / near);
+	memset(l->Grid, 0, SKR_CLUSTERS * 2 * sizeof(unsigned int));
+
+	unsigned int total = 0;
+	for (unsigned int i = 0; i < l->Count; ++i) {
+		const float*  p = l->Points[i].Position;
+		unsigned int* range = &l->Ranges[i * 6];
+		vec4          c;
+
+		glm_mat4_mulv((vec4*)view->View, (vec4){p[0], p[1], p[2], 1.0f},
+		              c);
+
+		/* View space looks down -z. */
+		const float r = p[3];
+		const float zmax = -c[2] + r;
+		const float zmin = glm_max(-c[2] - r, near);
+		if (zmax <= near) {
+			range[0] = range[1] = 0; /* Behind the camera. */
+			continue;
+		}
+
+		/* x / z is monotonic in both, so the box's extremes are at
+		 * corners; the near face is the widest. */
+		const float xs[2] = {(c[0] - r) * px, (c[0] + r) * px};
+		const float ys[2] = {(c[1] - r) * py, (c[1] + r) * py};
+		const float x0 = glm_min(xs[0] / zmin, xs[0] / zmax);
+		const float x1 = glm_max(xs[1] / zmin, xs[1] / zmax);
+		const float y0 = glm_min(ys[0] / zmin, ys[0] / zmax);
+		const float y1 = glm_max(ys[1] / zmin, ys[1] / zmax);
+
+		if (x1 < -1.0f || x0 > 1.0f || y1 < -1.0f || y0 > 1.0f) {
+			range[0] = range[1] = 0; /* Beside the frustum. */
+			continue;
+		}
+
+		range[0] = m_skr_cluster_tile(x0, SKR_CLUSTER_X);
+		range[1] = m_skr_cluster_tile(x1, SKR_CLUSTER_X) + 1;
+		range[2] = m_skr_cluster_tile(y0, SKR_CLUSTER_Y);
+		range[3] = m_skr_cluster_tile(y1, SKR_CLUSTER_Y) + 1;
+		range[4] = m_skr_cluster_slice(l, zmin);
+		range[5] = m_skr_cluster_slice(l, zmax) + 1;
+
+		for (unsigned int z = range[4]; z < range[5]; ++z)
+			for (unsigned int y = range[2]; y < range[3]; ++y) {
+				unsigned int* row =
+				        &l->Grid[((z * SKR_CLUSTER_Y + y) *
+				                          SKR_CLUSTER_X +
+				                  range[0]) *
+				                 2];
+				for (unsigned int x = range[0]; x < range[1];
+				     ++x, row += 2)
+					row[1]++;
+			}
+
+		total += (range[1] - range[0]) * (range[3] - range[2]) *
+		         (range[5] - range[4]);
+	}
+
+	if (total > l->IndexCapacity) {
+		unsigned int cap = l->IndexCapacity ? l->IndexCapacity : 4096;
+		while (cap < total)
+			cap *= 2;
+
+		unsigned int* grown = (unsigned int*)realloc(
+		        l->Indices, cap * sizeof(unsigned int));
+		if (!grown) {
+			m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+			                     "failed to grow light indices");
+			return 0;
+		}
+		l->Indices = grown;
+		l->IndexCapacity = cap;
+	}
+
+	/* Counts to offsets; the count is rebuilt as the fill cursor. */
+	unsigned int offset = 0;
+	for (unsigned int c = 0; c < SKR_CLUSTERS; ++c) {
+		l->Grid[c * 2] = offset;
+		offset += l->Grid[c * 2 + 1];
+		l->Grid[c * 2 + 1] = 0;
+	}
+
+	for (unsigned int i = 0; i < l->Count; ++i) {
+		const unsigned int* range = &l->Ranges[i * 6];
+		if (range[0] == range[1])
+			continue;
+
+		for (unsigned int z = range[4]; z < range[5]; ++z)
+			for (unsigned int y = range[2]; y < range[3]; ++y) {
+				unsigned int* row =
+				        &l->Grid[((z * SKR_CLUSTER_Y + y) *
+				                          SKR_CLUSTER_X +
+				                  range[0]) *
+				                 2];
+				for (unsigned int x = range[0]; x < range[1];
+				     ++x, row += 2)
+					l->Indices[row[0] + row[1]++] = i;
+			}
+	}
+
+	l->IndexCount = total;
+	return 1;
+}
+
+/**
+ * @brief Release every light and the cluster grid, keeping settings.
+ */
+SKR_API void skr_lights_free(SkrLights* l) {
+	if (!l)
+		return;
+
+	m_skr_aligned_free(l->Points);
+	free(l->Ranges);
+	free(l->Grid);
+	free(l->Indices);
+
+	const float far = l->Far;
+	*l = (SkrLights){.Far = far};
+}
+
+/**
+ * @internal
+ * @brief Collect the renderables that may cast into cascade `k`, whose
+ * sphere is centered on `center` in the space of `light`.
+ *
+ * Casters between the light and the cascade are kept, the shadow pass
+ * clamps their depth to its near plane.
+ *
+ * @return 1 on success, 0 on allocation failure.
+ */
+static inline int m_skr_cascade_gather(SkrCascade*           k,
+                                       const SkrRenderables* r,
+                                       const mat4 light, const vec3 center) {
+	const unsigned int need =
+	        SKR_RENDERABLE_VISIBLE | SKR_RENDERABLE_CAST_SHADOW |
+	        (k->Cached ? SKR_RENDERABLE_STATIC : 0u);
+
+	k->CasterCount = 0;
+	for (unsigned int i = 0; i < r->Count; ++i) {
+		if ((r->Flags[i] & need) != need)
+			continue;
+
+		const float* b = r->Bounds[i];
+		const float  reach = k->Radius + b[3];
+		vec3         p;
+		glm_mat4_mulv3((vec4*)light, (float*)b, 1.0f, p);
+		if (fabsf(p[0] - center[0]) > reach ||
+		    fabsf(p[1] - center[1]) > reach ||
+		    p[2] + b[3] < center[2] - k->Radius)
+			continue;
+
+		if (k->CasterCount == k->CasterCapacity) {
+			const unsigned int cap =
+			        k->CasterCapacity ? k->CasterCapacity * 2 : 64;
+			unsigned int* grown = (unsigned int*)realloc(
+			        k->Casters, cap * sizeof(unsigned int));
+			if (!grown) {
+				m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+				                     "failed to grow casters");
+				return 0;
+			}
+			k->Casters = grown;
+			k->CasterCapacity = cap;
+		}
+		k->Casters[k->CasterCount++] = i;
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Fit the shadow cascades to `view` and collect the casters of the
+ * ones to render this frame.
+ *
+ * Each slice is bounded by the smallest sphere centered on the view axis
+ * that holds its corners, equidistant from its near and far ones. Cached
+ * cascades are only marked dirty when their snapped matrix changes or
+ * after ::skr_shadows_invalidate.
+ *
+ * @return 1 on success, 0 on allocation failure.
+ */
+SKR_API int skr_shadows_update(SkrShadows* sh, const SkrView* view,
+                               const SkrRenderables* r) {
+	const float length = glm_vec3_norm(sh->Direction);
+
+	sh->Count = 0;
+	if (length == 0.0f)
+		return 1;
+
+	const unsigned int count =
+	        sh->CascadeCount && sh->CascadeCount < SKR_CASCADES
+	                ? sh->CascadeCount
+	                : SKR_CASCADES;
+	const unsigned int cached = sh->Static ? sh->Static : count / 2;
+	const float size = sh->Size ? (float)sh->Size : 2048.0f;
+	const float near = view->Source.Near > 0.0f ? view->Source.Near : 0.1f;
+	const float far = sh->Distance > near ? sh->Distance : 100.0f;
+	const float lambda = sh->Lambda > 0.0f ? sh->Lambda : 0.75f;
+
+	/* Squared half-diagonal of the frustum per unit of depth. */
+	const float tx = 1.0f / view->Projection[0][0];
+	const float ty = 1.0f / view->Projection[1][1];
+	const float diagonal = tx * tx + ty * ty;
+
+	vec3 dir, up = {0.0f, 1.0f, 0.0f}, front;
+	mat4 light;
+	glm_vec3_scale(sh->Direction, 1.0f / length, dir);
+	if (fabsf(dir[1]) > 0.99f)
+		glm_vec3_copy((vec3){0.0f, 0.0f, 1.0f}, up);
+	glm_lookat((vec3){0.0f, 0.0f, 0.0f}, dir, up, light);
+	glm_vec3_scale((float*)view->InverseView[2], -1.0f, front);
+
+	float begin = near;
+	for (unsigned int c = 0; c < count; ++c) {
+		SkrCascade* k = &sh->Cascades[c];
+		const float f = (float)(c + 1) / (float)count;
+		const float end = lambda * near * powf(far / near, f) +
+		                  (1.0f - lambda) * (near + (far - near) * f);
+
+		float z = (begin + end) * (1.0f + diagonal) * 0.5f;
+		z = z < end ? z : end;
+		float radius =
+		        sqrtf((end - z) * (end - z) + end * end * diagonal);
+
+		/* Cached cascades get a margin and only move in steps of it. */
+		float texel = 2.0f * radius / size, step = texel;
+		k->Cached = c >= cached;
+		if (k->Cached) {
+			const float margin = radius * 0.25f;
+			radius += margin;
+			texel = 2.0f * radius / size;
+			step = floorf(margin / texel) * texel;
+			step = step > texel ? step : texel;
+		}
+
+		vec3 center;
+		glm_vec3_copy((float*)view->Position, center);
+		glm_vec3_muladds(front, z, center);
+		glm_mat4_mulv3(light, center, 1.0f, center);
+		for (int a = 0; a < 3; ++a)
+			center[a] = floorf(center[a] / step) * step;
+
+		mat4 ortho;
+		glm_ortho(center[0] - radius, center[0] + radius,
+		          center[1] - radius, center[1] + radius,
+		          -(center[2] + radius), -(center[2] - radius), ortho);
+		glm_mat4_mul(ortho, light, k->Matrix);
+		k->Far = end;
+		k->Radius = radius;
+		k->Texel = texel;
+
+		k->Dirty = !k->Cached || !k->Valid ||
+		           memcmp(k->Rendered, k->Matrix, sizeof(mat4)) != 0;
+		if (k->Dirty) {
+			/* The backend renders every dirty cascade this frame. */
+			glm_mat4_copy(k->Matrix, k->Rendered);
+			k->Valid = true;
+			if (!m_skr_cascade_gather(k, r, light, center))
+				return 0;
+		}
+
+		begin = end;
+	}
+
+	sh->Count = count;
+	return 1;
+}
+
+/**
+ * @brief Redraw the cached cascades next update, after static casters
+ * moved, appeared or went away.
+ */
+SKR_API void skr_shadows_invalidate(SkrShadows* sh) {
+	for (unsigned int c = 0; c < SKR_CASCADES; ++c)
+		sh->Cascades[c].Valid = false;
+}
+
+/**
+ * @brief Release the caster lists, keeping the light and settings.
+ */
+SKR_API void skr_shadows_free(SkrShadows* sh) {
+	if (!sh)
+		return;
+
+	for (unsigned int c = 0; c < SKR_CASCADES; ++c) {
+		free(sh->Cascades[c].Casters);
+		sh->Cascades[c] = (SkrCascade){0};
+	}
+	sh->Count = 0;
+}
+
+/**
+ * @internal
+ * @brief Make room for `count + 1` elements of `size` bytes.
+ *
+ * @return 1 on success, 0 with the error set if allocation failed.
+ */
+static inline int m_skr_graph_reserve(void** array, unsigned int* capacity,
+                                      const unsigned int count,
+                                      const size_t       size) {
+	if (count < *capacity)
+		return 1;
+
+	const unsigned int cap = *capacity ? *capacity * 2 : 16;
+	void*              grown = realloc(*array, cap * size);
+	if (!grown) {
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to grow render graph");
+		return 0;
+	}
+
+	*array = grown;
+	*capacity = cap;
+	return 1;
+}
+
+/**
+ * @brief Drop the passes and resources of the last frame, keeping the
+ * targets and framebuffers for the next one.
+ */
+SKR_API void skr_graph_reset(SkrGraph* g) {
+	if (!g)
+		return;
+
+	g->PassCount = 0;
+	g->ResourceCount = 0;
+	g->OrderCount = 0;
+	g->EdgeCount = 0;
+}
+
+/**
+ * @internal
+ * @brief Append a resource, shared by ::skr_graph_create and
+ * ::skr_graph_import.
+ *
+ * @return Resource index, or -1 if allocation failed.
+ */
+static inline int m_skr_graph_resource(SkrGraph*               g,
+                                       const SkrGraphResource* resource) {
+	if (!m_skr_graph_reserve((void**)&g->Resources, &g->ResourceCapacity,
+	                         g->ResourceCount, sizeof(SkrGraphResource)))
+		return -1;
+
+	g->Resources[g->ResourceCount] = *resource;
+	return (int)g->ResourceCount++;
+}
+
+/**
+ * @brief Declare a transient render target.
+ *
+ * @return Resource index, or -1 on error.
+ */
+SKR_API int skr_graph_create(SkrGraph* g, const char* name,
+                             const SkrFormat format, const int width,
+                             const int height) {
+	if (!g || width <= 0 || height <= 0 ||
+	    (unsigned int)format > SKR_FORMAT_DEPTH32F) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "invalid render graph resource");
+		return -1;
+	}
+
+	const SkrGraphResource resource = {
+	        .Name = name,
+	        .Format = format,
+	        .Width = width,
+	        .Height = height,
+	        .First = -1,
+	        .Last = -1,
+	        .Target = -1,
+	};
+	return m_skr_graph_resource(g, &resource);
+}
+
+/**
+ * @brief Declare a target owned outside of the graph.
+ *
+ * Its texture and framebuffer are set in SkrGraphResource::Backend by the
+ * caller. Passes writing it are never culled. They render to the viewport
+ * bound on entry, or to its full size once the caller sets
+ * SkrGraphResource::Width and Height.
+ *
+ * @return Resource index, or -1 on error.
+ */
+SKR_API int skr_graph_import(SkrGraph* g, const char* name) {
+	if (!g) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "render graph is NULL");
+		return -1;
+	}
+
+	const SkrGraphResource resource = {
+	        .Name = name,
+	        .Imported = true,
+	        .First = -1,
+	        .Last = -1,
+	        .Target = -1,
+	};
+	return m_skr_graph_resource(g, &resource);
+}
+
+/**
+ * @brief Declare a pass, run by the renderer with `execute(s, g, user)`.
+ *
+ * @return Pass index, or -1 on error.
+ */
+SKR_API int skr_graph_pass(SkrGraph* g, const char* name,
+                           SkrGraphFunc* execute, void* user) {
+	if (!g || !execute) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "render graph pass needs a function");
+		return -1;
+	}
+
+	/* Order always holds every pass, so grow it alongside. */
+	const unsigned int capacity = g->PassCapacity;
+	if (!m_skr_graph_reserve((void**)&g->Passes, &g->PassCapacity,
+	                         g->PassCount, sizeof(SkrGraphPass)))
+		return -1;
+	if (g->PassCapacity != capacity || !g->Order) {
+		unsigned int* order = (unsigned int*)realloc(
+		        g->Order, g->PassCapacity * sizeof(unsigned int));
+		if (!order) {
+			m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+			                     "failed to grow render graph");
+			return -1;
+		}
+		g->Order = order;
+	}
+
+	g->Passes[g->PassCount] = (SkrGraphPass){
+	        .Name = name,
+	        .Execute = execute,
+	        .User = user,
+	        .Position = -1,
+	};
+	return (int)g->PassCount++;
+}
+
+/**
+ * @internal
+ * @brief Whether `pass` already reads or writes `resource`.
+ */
+static inline bool m_skr_graph_uses(const SkrGraphPass* pass,
+                                    const unsigned int  resource) {
+	for (unsigned int i = 0; i < pass->ReadCount; ++i)
+		if (pass->Reads[i] == resource)
+			return true;
+	for (unsigned int i = 0; i < pass->WriteCount; ++i)
+		if (pass->Writes[i] == resource)
+			return true;
+	return false;
+}
+
+/**
+ * @brief Declare that `pass` samples `resource`.
+ *
+ * @return 1 on success, 0 on error.
+ */
+SKR_API int skr_graph_read(SkrGraph* g, const unsigned int pass,
+                           const unsigned int resource) {
+	if (!g || pass >= g->PassCount || resource >= g->ResourceCount ||
+	    g->Passes[pass].ReadCount == SKR_GRAPH_SLOTS ||
+	    m_skr_graph_uses(&g->Passes[pass], resource)) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "invalid render graph read");
+		return 0;
+	}
+
+	SkrGraphPass* p = &g->Passes[pass];
+	p->Reads[p->ReadCount++] = resource;
+	return 1;
+}
+
+/**
+ * @brief Declare that `pass` renders to `resource`.
+ *
+ * The writes of a pass form its framebuffer: either one imported target,
+ * or transient color targets of the same size and at most one depth.
+ *
+ * @return 1 on success, 0 on error.
+ */
+SKR_API int skr_graph_write(SkrGraph* g, const unsigned int pass,
+                            const unsigned int resource) {
+	if (!g || pass >= g->PassCount || resource >= g->ResourceCount ||
+	    g->Passes[pass].WriteCount == SKR_GRAPH_SLOTS ||
+	    m_skr_graph_uses(&g->Passes[pass], resource)) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "invalid render graph write");
+		return 0;
+	}
+
+	SkrGraphPass*           p = &g->Passes[pass];
+	const SkrGraphResource* r = &g->Resources[resource];
+	for (unsigned int i = 0; i < p->WriteCount; ++i) {
+		const SkrGraphResource* w = &g->Resources[p->Writes[i]];
+		if (r->Imported || w->Imported || r->Width != w->Width ||
+		    r->Height != w->Height ||
+		    (r->Format == SKR_FORMAT_DEPTH32F &&
+		     w->Format == SKR_FORMAT_DEPTH32F)) {
+			m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+			                     "render graph writes are not a "
+			                     "framebuffer");
+			return 0;
+		}
+	}
+
+	p->Writes[p->WriteCount++] = resource;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Record that pass `after` depends on pass `before`.
+ */
+static inline int m_skr_graph_edge(SkrGraph* g, const unsigned int before,
+                                   const unsigned int after) {
+	if (!m_skr_graph_reserve((void**)&g->Edges, &g->EdgeCapacity,
+	                         g->EdgeCount * 2 + 1, sizeof(unsigned int)))
+		return 0;
+
+	g->Edges[g->EdgeCount * 2] = before;
+	g->Edges[g->EdgeCount * 2 + 1] = after;
+	++g->EdgeCount;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Whether two passes render to the same framebuffer.
+ */
+static inline bool m_skr_graph_same_writes(const SkrGraphPass* a,
+                                           const SkrGraphPass* b) {
+	return a->WriteCount == b->WriteCount &&
+	       memcmp(a->Writes, b->Writes,
+	              a->WriteCount * sizeof(unsigned int)) == 0;
+}
+
+/**
+ * @internal
+ * @brief Cull the passes nothing visible depends on.
+ *
+ * Walks back from passes with side effects or imported writes, marking
+ * in SkrGraphResource::First the resources kept passes need.
+ */
+static inline void m_skr_graph_cull(SkrGraph* g) {
+	for (unsigned int r = 0; r < g->ResourceCount; ++r)
+		g->Resources[r].First = 0;
+
+	for (unsigned int i = g->PassCount; i-- > 0;) {
+		SkrGraphPass* p = &g->Passes[i];
+		bool          kept = p->SideEffects;
+		for (unsigned int w = 0; w < p->WriteCount && !kept; ++w) {
+			const SkrGraphResource* r = &g->Resources[p->Writes[w]];
+			kept = r->Imported || r->First;
+		}
+
+		/* Kept passes start unscheduled, past every position. */
+		p->Position = kept ? (int)g->PassCount : -1;
+		if (!kept)
+			continue;
+
+		for (unsigned int j = 0; j < p->ReadCount; ++j)
+			g->Resources[p->Reads[j]].First = 1;
+		for (unsigned int j = 0; j < p->WriteCount; ++j)
+			g->Resources[p->Writes[j]].First = 1;
+	}
+}
+
+/**
+ * @internal
+ * @brief Link each kept pass to the kept passes it must follow: the last
+ * writer of what it reads or writes, and the readers of what it
+ * overwrites. SkrGraphResource::Last holds the last writer meanwhile.
+ */
+static inline int m_skr_graph_link(SkrGraph* g) {
+	g->EdgeCount = 0;
+	for (unsigned int r = 0; r < g->ResourceCount; ++r)
+		g->Resources[r].Last = -1;
+
+	for (unsigned int i = 0; i < g->PassCount; ++i) {
+		const SkrGraphPass* p = &g->Passes[i];
+		if (p->Position < 0)
+			continue;
+
+		for (unsigned int j = 0; j < p->ReadCount; ++j) {
+			const int writer = g->Resources[p->Reads[j]].Last;
+			if (writer >= 0 &&
+			    !m_skr_graph_edge(g, (unsigned int)writer, i))
+				return 0;
+		}
+
+		for (unsigned int j = 0; j < p->WriteCount; ++j) {
+			const unsigned int resource = p->Writes[j];
+			const int          writer = g->Resources[resource].Last;
+			if (writer >= 0 &&
+			    !m_skr_graph_edge(g, (unsigned int)writer, i))
+				return 0;
+
+			for (unsigned int q = (unsigned int)(writer + 1); q < i;
+			     ++q) {
+				const SkrGraphPass* reader = &g->Passes[q];
+				bool                reads = false;
+				for (unsigned int k = 0; k < reader->ReadCount;
+				     ++k)
+					reads |= reader->Reads[k] == resource;
+				if (reader->Position >= 0 && reads &&
+				    !m_skr_graph_edge(g, q, i))
+					return 0;
+			}
+
+			g->Resources[resource].Last = (int)i;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Order the kept passes after their dependencies, preferring the
+ * one writing the targets bound last.
+ */
+static inline void m_skr_graph_schedule(SkrGraph* g) {
+	for (unsigned int i = 0; i < g->PassCount; ++i)
+		g->Passes[i].Pending = 0;
+	for (unsigned int e = 0; e < g->EdgeCount; ++e)
+		++g->Passes[g->Edges[e * 2 + 1]].Pending;
+
+	const SkrGraphPass* bound = NULL;
+	g->OrderCount = 0;
+	for (;;) {
+		int next = -1;
+		for (unsigned int i = 0; i < g->PassCount; ++i) {
+			const SkrGraphPass* p = &g->Passes[i];
+			if (p->Position != (int)g->PassCount || p->Pending)
+				continue;
+
+			if (next < 0)
+				next = (int)i;
+			if (!bound || !p->WriteCount ||
+			    m_skr_graph_same_writes(p, bound)) {
+				next = (int)i;
+				break;
+			}
+		}
+		if (next < 0)
+			break;
+
+		SkrGraphPass* p = &g->Passes[next];
+		p->Position = (int)g->OrderCount;
+		g->Order[g->OrderCount++] = (unsigned int)next;
+		if (p->WriteCount)
+			bound = p;
+
+		for (unsigned int e = 0; e < g->EdgeCount; ++e)
+			if (g->Edges[e * 2] == (unsigned int)next)
+				--g->Passes[g->Edges[e * 2 + 1]].Pending;
+	}
+}
+
+/**
+ * @internal
+ * @brief Back transient resource `index` with a target free from its
+ * first use, reusing a matching or released target before adding one.
+ */
+static inline int m_skr_graph_alias(SkrGraph* g, const unsigned int index) {
+	SkrGraphResource* r = &g->Resources[index];
+	int               slot = -1, released = -1;
+
+	for (unsigned int t = 0; t < g->TargetCount && slot < 0; ++t) {
+		const SkrGraphTarget* target = &g->Targets[t];
+		if (target->Used && target->Free >= r->First)
+			continue;
+
+		if (target->Format == r->Format && target->Width == r->Width &&
+		    target->Height == r->Height)
+			slot = (int)t;
+		else if (!target->Width && !target->Used && released < 0)
+			released = (int)t;
+	}
+
+	if (slot < 0 && released >= 0)
+		slot = released;
+	if (slot < 0) {
+		if (!m_skr_graph_reserve((void**)&g->Targets,
+		                         &g->TargetCapacity, g->TargetCount,
+		                         sizeof(SkrGraphTarget)))
+			return 0;
+		g->Targets[g->TargetCount] = (SkrGraphTarget){0};
+		slot = (int)g->TargetCount++;
+	}
+
+	SkrGraphTarget* target = &g->Targets[slot];
+	target->Format = r->Format;
+	target->Width = r->Width;
+	target->Height = r->Height;
+	target->Used = true;
+	target->Free = r->Last;
+	r->Target = slot;
+	return 1;
+}
+
+/**
+ * @brief Cull, order, and assign targets to the declared passes.
+ *
+ * Fills SkrGraph::Order, each pass's Position, and each resource's
+ * lifetime and Target. Targets left unused are released by the next
+ * execution.
+ *
+ * @return 1 on success, 0 on error.
+ */
+SKR_API int skr_graph_compile(SkrGraph* g) {
+	if (!g) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "render graph is NULL");
+		return 0;
+	}
+
+	m_skr_graph_cull(g);
+	if (!m_skr_graph_link(g))
+		return 0;
+	m_skr_graph_schedule(g);
+
+	for (unsigned int r = 0; r < g->ResourceCount; ++r) {
+		g->Resources[r].First = g->Resources[r].Last = -1;
+		g->Resources[r].Target = -1;
+	}
+	for (unsigned int o = 0; o < g->OrderCount; ++o) {
+		const SkrGraphPass* p = &g->Passes[g->Order[o]];
+		const unsigned int  uses = p->ReadCount + p->WriteCount;
+		for (unsigned int j = 0; j < uses; ++j) {
+			const unsigned int index =
+			        j < p->ReadCount ? p->Reads[j]
+			                         : p->Writes[j - p->ReadCount];
+			SkrGraphResource* r = &g->Resources[index];
+			if (r->First < 0)
+				r->First = (int)o;
+			r->Last = (int)o;
+		}
+	}
+
+	/* Resources are assigned in order of first use. */
+	for (unsigned int t = 0; t < g->TargetCount; ++t)
+		g->Targets[t].Used = false;
+	for (unsigned int o = 0; o < g->OrderCount; ++o) {
+		const SkrGraphPass* p = &g->Passes[g->Order[o]];
+		const unsigned int  uses = p->ReadCount + p->WriteCount;
+		for (unsigned int j = 0; j < uses; ++j) {
+			const unsigned int index =
+			        j < p->ReadCount ? p->Reads[j]
+			                         : p->Writes[j - p->ReadCount];
+			const SkrGraphResource* r = &g->Resources[index];
+			if (!r->Imported && r->First == (int)o &&
+			    r->Target < 0 && !m_skr_graph_alias(g, index))
+				return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief Release the CPU side of the graph. Backend targets and
+ * framebuffers are released by the renderer first.
+ */
+SKR_API void skr_graph_free(SkrGraph* g) {
+	if (!g)
+		return;
+
+	free(g->Passes);
+	free(g->Resources);
+	free(g->Order);
+	free(g->Edges);
+	free(g->Targets);
+	free(g->Framebuffers);
+	memset(g, 0, sizeof(*g));
+}
+
+/**
+ * @brief Adjust SkrResolution::Scale to a frame that took `gpu_time`
+ * seconds on the GPU.
+ *
+ * The cost of a frame is taken as proportional to its pixel count, so the
+ * ideal scale is `Scale * sqrt(Budget / gpu_time)`. Below the current
+ * scale it is applied immediately, rounded down to a step. Growth waits
+ * for 30 frames in a row with room for at least one more step.
+ */
+SKR_API void skr_resolution_update(SkrResolution* r, const double gpu_time) {
+	if (!r)
+		return;
+
+	const double budget = r->Budget > 0.0 ? r->Budget : 1.0 / 60.0;
+	const float  min = r->MinScale > 0.0f ? r->MinScale : 0.5f;
+	const float  max = r->MaxScale > 0.0f ? r->MaxScale : 1.0f;
+	const float  step = r->Step > 0.0f ? r->Step : 0.05f;
+
+	if (r->Scale <= 0.0f)
+		r->Scale = max;
+	if (gpu_time <= 0.0)
+		return;
+
+	r->GpuTime = gpu_time;
+	const float ideal = r->Scale * sqrtf((float)(budget / gpu_time));
+	if (ideal < r->Scale) {
+		r->Scale = floorf(ideal / step) * step;
+		r->Calm = 0;
+	} else if (ideal >= r->Scale + step) {
+		if (++r->Calm >= 30) {
+			r->Scale += step;
+			r->Calm = 0;
+		}
+	} else {
+		r->Calm = 0;
+	}
+
+	r->Scale = r->Scale < min ? min : r->Scale > max ? max : r->Scale;
+}
+
+/**
+ * @internal
+ * @brief Radical inverse of `index` in `base`, in [0, 1).
+ */
+static inline float m_skr_halton(unsigned int index, const unsigned int base) {
+	float result = 0.0f;
+	float f = 1.0f;
+
+	while (index > 0) {
+		f /= (float)base;
+		result += f * (float)(index % base);
+		index /= base;
+	}
+	return result;
+}
+
+/**
+ * @brief Jitter `v` for the next frame of a `width` x `height` scene.
+ *
+ * Offsets follow the Halton (2, 3) sequence, which covers the pixel evenly
+ * in a few frames, centered on the pixel. The view is
+ * invalidated so that the next ::skr_view_update applies the offset.
+ */
+SKR_API void skr_temporal_jitter(SkrTemporal* t, SkrView* v, const int width,
+                                 const int height) {
+	if (!t || !v || width <= 0 || height <= 0)
+		return;
+
+	const unsigned int samples = t->Samples ? t->Samples : 8;
+	const unsigned int index = t->Index++ % samples + 1;
+
+	t->Jitter[0] = m_skr_halton(index, 2) - 0.5f;
+	t->Jitter[1] = m_skr_halton(index, 3) - 0.5f;
+	v->Jitter[0] = 2.0f * t->Jitter[0] / (float)width;
+	v->Jitter[1] = 2.0f * t->Jitter[1] / (float)height;
+	v->Valid = false;
+}
+
+/**
+ * @brief Keep this frame's camera and renderable transforms, which the
+ * next frame's velocities are measured against.
+ */
+SKR_API void skr_temporal_store(SkrTemporal* t, const SkrView* v,
+                                SkrRenderables* r, const SkrScene* scene) {
+	if (!t || !v || !r)
+		return;
+
+	glm_mat4_copy((vec4*)v->Unjittered, t->PreviousViewProjection);
+	for (unsigned int i = 0; i < r->Count; ++i) {
+		if (r->Node[i])
+			glm_mat4_copy(scene->World[scene->Slot[r->Node[i]]],
+			              r->Previous[i]);
+		else
+			glm_mat4_identity(r->Previous[i]);
+	}
+	t->Valid = true;
+}
+
+/**
+ * @brief Drop the history, e.g. on a camera cut, so the next frame is
+ * resolved from its own samples only.
+ */
+SKR_API void skr_temporal_reset(SkrTemporal* t) {
+	if (t)
+		t->Valid = false;
+}
+
+/**
+ * @brief Fill `rgba` with the identity grading LUT of SkrPost::Lut, a
+ * `size * size` by `size` RGBA8 image, bottom row first. Edit it (or a
+ * screenshot of it) in any image tool to build a grade.
+ */
+SKR_API void skr_lut_identity(const unsigned int size, unsigned char* rgba) {
+	if (!rgba || size < 2)
+		return;
+
+	for (unsigned int g = 0; g < size; ++g)
+		for (unsigned int b = 0; b < size; ++b)
+			for (unsigned int r = 0; r < size; ++r) {
+				unsigned char* p =
+				        &rgba[((g * size + b) * size + r) * 4];
+				p[0] = (unsigned char)(r * 255 / (size - 1));
+				p[1] = (unsigned char)(g * 255 / (size - 1));
+				p[2] = (unsigned char)(b * 255 / (size - 1));
+				p[3] = 255;
+			}
+}
+
+/**
+ * @internal
+ * @brief Extend the range of bones uploaded next frame.
+ */
+static inline void m_skr_skinning_touch(SkrSkinning* s,
+                                        const unsigned int begin,
+                                        const unsigned int end) {
+	if (s->DirtyBegin == s->DirtyEnd) {
+		s->DirtyBegin = begin;
+		s->DirtyEnd = end;
+		return;
+	}
+
+	s->DirtyBegin = begin < s->DirtyBegin ? begin : s->DirtyBegin;
+	s->DirtyEnd = end > s->DirtyEnd ? end : s->DirtyEnd;
+}
+
+/**
+ * @brief Reserve a palette of `bones` bones, set to identity.
+ *
+ * @return First bone of the palette, or -1 on failure.
+ */
+SKR_API int skr_skinning_alloc(SkrSkinning* s, const unsigned int bones) {
+	if (!s || bones == 0) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "palette needs at least one bone");
+		return -1;
+	}
+
+	const unsigned int base = s->Count;
+	const unsigned int count = base + bones;
+
+	if (count > s->Capacity) {
+		unsigned int cap = s->Capacity ? s->Capacity : 256;
+		while (cap < count)
+			cap *= 2;
+
+		vec4* grown = (vec4*)m_skr_aligned_grow(
+		        s->Bones, (size_t)s->Capacity * 3 * sizeof(vec4),
+		        (size_t)cap * 3 * sizeof(vec4), 16);
+		if (!grown) {
+			m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+			                     "failed to grow bone palettes");
+			return -1;
+		}
+
+		s->Bones = grown;
+		s->Capacity = cap;
+	}
+
+	for (unsigned int i = base; i < count; ++i) {
+		vec4* rows = &s->Bones[i * 3];
+		glm_vec4_copy((vec4){1.0f, 0.0f, 0.0f, 0.0f}, rows[0]);
+		glm_vec4_copy((vec4){0.0f, 1.0f, 0.0f, 0.0f}, rows[1]);
+		glm_vec4_copy((vec4){0.0f, 0.0f, 1.0f, 0.0f}, rows[2]);
+	}
+
+	s->Count = count;
+	m_skr_skinning_touch(s, base, count);
+	return (int)base;
+}
+
+/**
+ * @brief Set a bone for linear-blend skinning (`skr_skin_lbs`).
+ *
+ * @param m Affine matrix from bind pose to posed model space, i.e. the
+ *          bone's model matrix times its inverse bind matrix.
+ */
+SKR_API void skr_skinning_set(SkrSkinning* s, const int base,
+                              const unsigned int bone, const mat4 m) {
+	const unsigned int i = (unsigned int)base + bone;
+	vec4*              rows = &s->Bones[i * 3];
+
+	for (int r = 0; r < 3; ++r) {
+		rows[r][0] = m[0][r];
+		rows[r][1] = m[1][r];
+		rows[r][2] = m[2][r];
+		rows[r][3] = m[3][r];
+	}
+
+	m_skr_skinning_touch(s, i, i + 1);
+}
+
+/**
+ * @brief Set a bone for dual-quaternion skinning (`skr_skin_dq`).
+ *
+ * Dual quaternions blend rotations without the volume loss of linear
+ * blending but cannot express scale.
+ */
+SKR_API void skr_skinning_set_dq(SkrSkinning* s, const int base,
+                                 const unsigned int bone,
+                                 const versor       rotation,
+                                 const vec3         translation) {
+	const unsigned int i = (unsigned int)base + bone;
+	vec4*              rows = &s->Bones[i * 3];
+	versor             t = {translation[0], translation[1], translation[2],
+	                        0.0f};
+
+	glm_quat_normalize_to((float*)rotation, rows[0]);
+	glm_quat_mul(t, rows[0], rows[1]);
+	glm_vec4_scale(rows[1], 0.5f, rows[1]);
+	glm_vec4_zero(rows[2]);
+
+	m_skr_skinning_touch(s, i, i + 1);
+}
+
+/**
+ * @brief Upload `bones` bones from `base` next frame.
+ *
+ * For palettes written directly, e.g. by ::skr_skeleton_palette from
+ * several jobs at once.
+ */
+SKR_API void skr_skinning_mark(SkrSkinning* s, const int base,
+                               const unsigned int bones) {
+	m_skr_skinning_touch(s, (unsigned int)base, (unsigned int)base + bones);
+}
+
+/**
+ * @brief Release the CPU side of every palette and reset `s`.
+ */
+SKR_API void skr_skinning_free(SkrSkinning* s) {
+	if (!s)
+		return;
+
+	m_skr_aligned_free(s->Bones);
+	m_skr_aligned_free(s->Scratch);
+	free(s->Outputs);
+	*s = (SkrSkinning){0};
+}
+
+/**
+ * @internal
+ * @brief ::skr_skin_vertices adding `morph` deltas (two vec4 per vertex,
+ * see SkrMorphs::Deltas) first, if given.
+ */
+static inline void m_skr_skin_vertices(const SkrSkinning* s, const int base,
+                                       const SkrVertex*   src,
+                                       const unsigned int count,
+                                       const vec4* morph, vec4* out) {
+	for (unsigned int v = 0; v < count; ++v) {
+		const SkrVertex* vert = &src[v];
+		vec4             p, n;
+		vec4             r0 = {0}, r1 = {0}, r2 = {0};
+		float            sum = 0.0f;
+
+		glm_vec4((float*)vert->Position, 1.0f, p);
+		glm_vec4((float*)vert->Normal, 0.0f, n);
+		if (morph) {
+			glm_vec3_add(p, (float*)morph[v * 2], p);
+			glm_vec3_add(n, (float*)morph[v * 2 + 1], n);
+		}
+
+		for (int i = 0; i < MAX_BONE_INFLUENCE && base >= 0; ++i) {
+			const float w = vert->BoneWeights[i];
+			if (w <= 0.0f)
+				continue;
+
+			vec4* rows = &s->Bones[(base + vert->BoneIDs[i]) * 3];
+			glm_vec4_muladds(rows[0], w, r0);
+			glm_vec4_muladds(rows[1], w, r1);
+			glm_vec4_muladds(rows[2], w, r2);
+			sum += w;
+		}
+
+		if (sum <= 0.0f) {
+			glm_vec4_copy(p, out[v * 2]);
+			glm_vec4_copy(n, out[v * 2 + 1]);
+			continue;
+		}
+
+		out[v * 2][0] = glm_vec4_dot(r0, p);
+		out[v * 2][1] = glm_vec4_dot(r1, p);
+		out[v * 2][2] = glm_vec4_dot(r2, p);
+		out[v * 2][3] = 1.0f;
+
+		vec3 sn = {glm_vec4_dot(r0, n), glm_vec4_dot(r1, n),
+		           glm_vec4_dot(r2, n)};
+		glm_vec3_normalize(sn);
+		glm_vec4(sn, 0.0f, out[v * 2 + 1]);
+	}
+}
+
+/**
+ * @brief Linear-blend skin vertices on the CPU.
+ *
+ * Same result as `skr_skin_lbs`: the bone rows are blended with 4-wide
+ * multiply-adds, then applied with dot products. Rigid vertices are
+ * copied.
+ *
+ * @param out Two vec4 per vertex: position (w = 1), normal (w = 0).
+ */
+SKR_API void skr_skin_vertices(const SkrSkinning* s, const int base,
+                               const SkrVertex* src, const unsigned int count,
+                               vec4* out) {
+	m_skr_skin_vertices(s, base, src, count, NULL, out);
+}
+
+/**
+ * @brief Add a morph target to `mesh` from dense per-vertex deltas.
+ *
+ * Only vertices whose position or normal delta exceeds `epsilon` on some
+ * axis are kept. Targets may be added before or after the mesh is
+ * uploaded; the mesh does not need to be re-uploaded.
+ *
+ * @param positions VertexCount position deltas.
+ * @param normals   VertexCount normal deltas, or NULL.
+ * @return Target index, or -1 on failure.
+ */
+SKR_API int skr_mesh_add_morph_target(SkrMesh* mesh, const vec3* positions,
+                                      const vec3* normals,
+                                      const float epsilon) {
+	if (!mesh || !positions || mesh->VertexCount <= 0) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "morph target needs a mesh and positions");
+		return -1;
+	}
+
+	const unsigned int count = (unsigned int)mesh->VertexCount;
+	unsigned int       moved = 0;
+	float              range = 0.0f;
+
+	for (unsigned int v = 0; v < count; ++v) {
+		float big = 0.0f;
+		for (int c = 0; c < 3; ++c) {
+			big = glm_max(big, fabsf(positions[v][c]));
+			if (normals)
+				big = glm_max(big, fabsf(normals[v][c]));
+			range = glm_max(range, fabsf(positions[v][c]));
+		}
+		moved += big > epsilon;
+	}
+
+	SkrMorphTarget* targets = (SkrMorphTarget*)realloc(
+	        mesh->Targets,
+	        (mesh->TargetCount + 1) * sizeof(SkrMorphTarget));
+	if (!targets)
+		goto fail;
+	mesh->Targets = targets;
+
+	SkrMorphDelta* deltas = (SkrMorphDelta*)realloc(
+	        mesh->Deltas,
+	        ((size_t)mesh->DeltaCount + moved) * sizeof(SkrMorphDelta));
+	if (!deltas && moved)
+		goto fail;
+	if (deltas)
+		mesh->Deltas = deltas;
+
+	SkrMorphTarget* t = &mesh->Targets[mesh->TargetCount];
+	const float     scale = range > 0.0f ? range / 32767.0f : 1.0f;
+
+	*t = (SkrMorphTarget){mesh->DeltaCount, 0, scale};
+	for (unsigned int v = 0; v < count && t->Count < moved; ++v) {
+		float big = 0.0f;
+		for (int c = 0; c < 3; ++c) {
+			big = glm_max(big, fabsf(positions[v][c]));
+			if (normals)
+				big = glm_max(big, fabsf(normals[v][c]));
+		}
+		if (big <= epsilon)
+			continue;
+
+		SkrMorphDelta* d = &mesh->Deltas[t->First + t->Count++];
+		d->Vertex = v;
+		for (int c = 0; c < 3; ++c) {
+			const float n =
+			        normals ? glm_clamp(normals[v][c], -2.0f, 2.0f)
+			                : 0.0f;
+			d->Position[c] =
+			        (short)lroundf(positions[v][c] / scale);
+			d->Normal[c] = (short)lroundf(n * (32767.0f / 2.0f));
+		}
+	}
+
+	mesh->DeltaCount += t->Count;
+	return (int)mesh->TargetCount++;
+
+fail:
+	m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+	                     "failed to grow morph targets");
+	return -1;
+}
+
+/**
+ * @brief Release the morph targets of `mesh`.
+ *
+ * Instances from ::skr_morphs_alloc must not be updated afterwards.
+ */
+SKR_API void skr_mesh_free_morph_targets(SkrMesh* mesh) {
+	if (!mesh)
+		return;
+
+	free(mesh->Targets);
+	free(mesh->Deltas);
+	mesh->Targets = NULL;
+	mesh->Deltas = NULL;
+	mesh->TargetCount = mesh->DeltaCount = 0;
+}
+
+/**
+ * @internal
+ * @brief Unit normal of triangle `t` of `mesh`, zero if degenerate.
+ */
+static inline void m_skr_triangle_normal(const SkrMesh*     mesh,
+                                         const unsigned int t, vec3 normal) {
+	const unsigned int* idx = &mesh->Indices[t * 3];
+	vec3                e1, e2;
+
+	glm_vec3_sub(mesh->Vertices[idx[1]].Position,
+	             mesh->Vertices[idx[0]].Position, e1);
+	glm_vec3_sub(mesh->Vertices[idx[2]].Position,
+	             mesh->Vertices[idx[0]].Position, e2);
+	glm_vec3_cross(e1, e2, normal);
+	glm_vec3_normalize(normal);
+}
+
+/**
+ * @internal
+ * @brief Fit the bounds and normal cone of the `count` triangles of
+ * `mesh` from triangle `first`.
+ */
+static inline void m_skr_cluster_fit(const SkrMesh*     mesh,
+                                     const unsigned int first,
+                                     const unsigned int count,
+                                     SkrCluster*        c) {
+	const unsigned int* idx = &mesh->Indices[first * 3];
+	vec3                lo, hi, center, axis = {0.0f, 0.0f, 0.0f};
+	float               radius = 0.0f, least = 1.0f;
+
+	glm_vec3_copy(mesh->Vertices[idx[0]].Position, lo);
+	glm_vec3_copy(lo, hi);
+	for (unsigned int i = 1; i < count * 3; ++i) {
+		glm_vec3_minv(lo, mesh->Vertices[idx[i]].Position, lo);
+		glm_vec3_maxv(hi, mesh->Vertices[idx[i]].Position, hi);
+	}
+	glm_vec3_add(lo, hi, center);
+	glm_vec3_scale(center, 0.5f, center);
+	for (unsigned int i = 0; i < count * 3; ++i) {
+		const float* p = mesh->Vertices[idx[i]].Position;
+		radius = glm_max(radius, glm_vec3_distance(center, (float*)p));
+	}
+
+	/* Axis from the mean normal, spread from the least aligned one. */
+	for (unsigned int t = 0; t < count; ++t) {
+		vec3 n;
+		m_skr_triangle_normal(mesh, first + t, n);
+		glm_vec3_add(axis, n, axis);
+	}
+	glm_vec3_normalize(axis);
+	for (unsigned int t = 0; t < count; ++t) {
+		vec3 n;
+		m_skr_triangle_normal(mesh, first + t, n);
+		least = glm_min(least, glm_vec3_dot(axis, n));
+	}
+
+	glm_vec4(center, radius, c->Bounds);
+	glm_vec4(axis, least > 0.1f ? sqrtf(1.0f - least * least) : 1.0f,
+	         c->Cone);
+	c->First = first * 3;
+	c->Count = count * 3;
+}
+
+/**
+ * @brief Split the triangles of `mesh` into clusters for
+ * ::skr_renderables_cull_clusters.
+ *
+ * Triangles are taken in index order, so meshes ordered for the vertex
+ * cache give compact clusters. A cluster ends after `triangles`
+ * triangles, or before one turning more than 60 degrees from its mean
+ * normal, which keeps normal cones narrow enough to cull. Indices are not
+ * reordered, so an uploaded mesh needs no new upload.
+ *
+ * @param triangles Most triangles per cluster, 0 for 64.
+ * @return Number of clusters, or -1 on failure.
+ */
+SKR_API int skr_mesh_build_clusters(SkrMesh* mesh, unsigned int triangles) {
+	if (!mesh || !mesh->Vertices || !mesh->Indices ||
+	    mesh->IndexCount < 3) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "clusters need indexed CPU vertices");
+		return -1;
+	}
+
+	const unsigned int count = mesh->IndexCount / 3;
+	const unsigned int limit = triangles ? triangles : 64;
+	unsigned int       capacity = 0, first = 0;
+	vec3               sum = {0.0f, 0.0f, 0.0f};
+
+	skr_mesh_free_clusters(mesh);
+	for (unsigned int t = 0; t <= count; ++t) {
+		vec3 n = {0.0f, 0.0f, 0.0f}, mean;
+		if (t < count)
+			m_skr_triangle_normal(mesh, t, n);
+		glm_vec3_copy(sum, mean);
+		glm_vec3_normalize(mean);
+
+		const unsigned int size = t - first;
+		const bool         turns = glm_vec3_norm2(n) > 0.0f &&
+		                   glm_vec3_norm2(mean) > 0.0f &&
+		                   glm_vec3_dot(mean, n) < 0.5f;
+		if (size && (t == count || size == limit || turns)) {
+			if (mesh->ClusterCount == capacity) {
+				capacity = capacity ? capacity * 2 : 64;
+				SkrCluster* grown = (SkrCluster*)realloc(
+				        mesh->Clusters,
+				        capacity * sizeof(SkrCluster));
+				if (!grown) {
+					m_skr_last_error_set(
+					        SKR_ERROR_OUT_OF_MEMORY,
+					        "failed to grow clusters");
+					skr_mesh_free_clusters(mesh);
+					return -1;
+				}
+				mesh->Clusters = grown;
+			}
+			SkrCluster* c = &mesh->Clusters[mesh->ClusterCount++];
+			m_skr_cluster_fit(mesh, first, size, c);
+			first = t;
+			glm_vec3_zero(sum);
+		}
+		glm_vec3_add(sum, n, sum);
+	}
+
+	return (int)mesh->ClusterCount;
+}
+
+/**
+ * @brief Release the clusters of `mesh`; it is drawn whole again.
+ */
+SKR_API void skr_mesh_free_clusters(SkrMesh* mesh) {
+	if (!mesh)
+		return;
+
+	free(mesh->Clusters);
+	mesh->Clusters = NULL;
+	mesh->ClusterCount = 0;
+}
+
+/**
+ * @internal
+ * @brief Extend the range of vertices uploaded next frame.
+ */
+static inline void m_skr_morphs_touch(SkrMorphs* m, const unsigned int begin,
+                                      const unsigned int end) {
+	if (m->DirtyBegin == m->DirtyEnd) {
+		m->DirtyBegin = begin;
+		m->DirtyEnd = end;
+		return;
+	}
+
+	if (begin < m->DirtyBegin)
+		m->DirtyBegin = begin;
+	if (end > m->DirtyEnd)
+		m->DirtyEnd = end;
+}
+
+/**
+ * @brief Allocate morph weights and deltas for an instance of `mesh`.
+ *
+ * Weights start at 0; assign the instance to renderables drawing `mesh`
+ * with ::skr_renderables_set_morph. Add the mesh's targets first.
+ *
+ * @return Instance index, or -1 on failure.
+ */
+SKR_API int skr_morphs_alloc(SkrMorphs* m, SkrMesh* mesh) {
+	if (!m || !mesh || mesh->VertexCount <= 0) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "morph instance needs a mesh");
+		return -1;
+	}
+
+	const unsigned int vertices = (unsigned int)mesh->VertexCount;
+	const unsigned int count = m->Count + vertices;
+
+	if (count > m->Capacity) {
+		unsigned int cap = m->Capacity ? m->Capacity : 4096;
+		while (cap < count)
+			cap *= 2;
+
+		vec4* grown = (vec4*)m_skr_aligned_grow(
+		        m->Deltas, (size_t)m->Capacity * 2 * sizeof(vec4),
+		        (size_t)cap * 2 * sizeof(vec4), 16);
+		if (!grown)
+			goto fail;
+
+		m->Deltas = grown;
+		m->Capacity = cap;
+	}
+
+	if (m->InstanceCount == m->InstanceCapacity) {
+		const unsigned int cap =
+		        m->InstanceCapacity ? m->InstanceCapacity * 2 : 16;
+		SkrMorphInstance* grown = (SkrMorphInstance*)realloc(
+		        m->Instances, cap * sizeof(SkrMorphInstance));
+		if (!grown)
+			goto fail;
+
+		m->Instances = grown;
+		m->InstanceCapacity = cap;
+	}
+
+	SkrMorphInstance inst = {.Mesh = mesh, .Base = m->Count,
+	                         .TargetCount = mesh->TargetCount};
+	inst.Weights = (float*)calloc(mesh->TargetCount ? mesh->TargetCount : 1,
+	                              sizeof(float));
+	inst.Touched = (unsigned int*)malloc(vertices * sizeof(unsigned int));
+	if (!inst.Weights || !inst.Touched) {
+		free(inst.Weights);
+		free(inst.Touched);
+		goto fail;
+	}
+
+	memset(&m->Deltas[m->Count * 2], 0, vertices * 2 * sizeof(vec4));
+	m->Count = count;
+	m_skr_morphs_touch(m, inst.Base, count);
+
+	m->Instances[m->InstanceCount] = inst;
+	return (int)m->InstanceCount++;
+
+fail:
+	m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+	                     "failed to grow morph instances");
+	return -1;
+}
+
+/**
+ * @brief Set the weight of `target` on `instance`, applied on the next
+ * ::skr_morphs_update.
+ *
+ * Targets added to the mesh after the instance was allocated start at 0.
+ */
+SKR_API void skr_morphs_set_weight(SkrMorphs* m, const unsigned int instance,
+                                   const unsigned int target,
+                                   const float        weight) {
+	if (!m || instance >= m->InstanceCount)
+		return;
+
+	SkrMorphInstance* inst = &m->Instances[instance];
+	if (target >= inst->Mesh->TargetCount)
+		return;
+
+	if (target >= inst->TargetCount) {
+		const unsigned int count = inst->Mesh->TargetCount;
+		float*             grown =
+		        (float*)realloc(inst->Weights, count * sizeof(float));
+		if (!grown) {
+			m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+			                     "failed to grow morph weights");
+			return;
+		}
+		memset(&grown[inst->TargetCount], 0,
+		       (count - inst->TargetCount) * sizeof(float));
+		inst->Weights = grown;
+		inst->TargetCount = count;
+	}
+
+	if (inst->Weights[target] == weight)
+		return;
+
+	inst->Weights[target] = weight;
+	inst->Dirty = true;
+}
+
+/**
+ * @internal
+ * @brief Rebuild the deltas of one instance from its weighted targets.
+ */
+static inline void m_skr_morph_apply(SkrMorphs* m, SkrMorphInstance* inst) {
+	const SkrMesh* mesh = inst->Mesh;
+	vec4*          deltas = &m->Deltas[inst->Base * 2];
+	unsigned int   lo = (unsigned int)mesh->VertexCount, hi = 0;
+
+	/* Clear what the previous weights wrote, nothing else is set. */
+	for (unsigned int i = 0; i < inst->TouchedCount; ++i) {
+		const unsigned int v = inst->Touched[i];
+		glm_vec4_zero(deltas[v * 2]);
+		glm_vec4_zero(deltas[v * 2 + 1]);
+		lo = v < lo ? v : lo;
+		hi = v > hi ? v : hi;
+	}
+	inst->TouchedCount = 0;
+
+	const unsigned int targets = inst->TargetCount < mesh->TargetCount
+	                                     ? inst->TargetCount
+	                                     : mesh->TargetCount;
+	for (unsigned int t = 0; t < targets; ++t) {
+		const float w = inst->Weights[t];
+		if (w == 0.0f)
+			continue;
+
+		const SkrMorphTarget* target = &mesh->Targets[t];
+		const SkrMorphDelta*  d = &mesh->Deltas[target->First];
+		const float           ps = w * target->Scale;
+		const float           ns = w * (2.0f / 32767.0f);
+
+		for (unsigned int i = 0; i < target->Count; ++i) {
+			const unsigned int v = d[i].Vertex;
+			float*             p = deltas[v * 2];
+			float*             n = deltas[v * 2 + 1];
+
+			/* w marks vertices already listed. */
+			if (p[3] == 0.0f) {
+				p[3] = 1.0f;
+				inst->Touched[inst->TouchedCount++] = v;
+				lo = v < lo ? v : lo;
+				hi = v > hi ? v : hi;
+			}
+
+			p[0] += (float)d[i].Position[0] * ps;
+			p[1] += (float)d[i].Position[1] * ps;
+			p[2] += (float)d[i].Position[2] * ps;
+			n[0] += (float)d[i].Normal[0] * ns;
+			n[1] += (float)d[i].Normal[1] * ns;
+			n[2] += (float)d[i].Normal[2] * ns;
+		}
+	}
+
+	if (lo <= hi)
+		m_skr_morphs_touch(m, inst->Base + lo, inst->Base + hi + 1);
+	inst->Dirty = false;
+}
+
+/**
+ * @brief Apply the weights changed since the last update.
+ *
+ * Work is proportional to the deltas of the targets with a non-zero
+ * weight on the changed instances.
+ */
+SKR_API void skr_morphs_update(SkrMorphs* m) {
+	for (unsigned int i = 0; i < m->InstanceCount; ++i)
+		if (m->Instances[i].Dirty)
+			m_skr_morph_apply(m, &m->Instances[i]);
+}
+
+/**
+ * @brief Release the CPU side of every instance and reset `m`.
+ */
+SKR_API void skr_morphs_free(SkrMorphs* m) {
+	if (!m)
+		return;
+
+	for (unsigned int i = 0; i < m->InstanceCount; ++i) {
+		free(m->Instances[i].Weights);
+		free(m->Instances[i].Touched);
+	}
+
+	free(m->Instances);
+	m_skr_aligned_free(m->Deltas);
+	*m = (SkrMorphs){0};
+}
+
+/**
+ * @brief Allocate a skeleton of `bones` root bones at identity.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+SKR_API int skr_skeleton_init(SkrSkeleton* skel, const unsigned int bones) {
+	*skel = (SkrSkeleton){0};
+
+	skel->Parent = (int*)malloc(bones * sizeof(int));
+	skel->InverseBind = (mat4*)m_skr_aligned_alloc(bones * sizeof(mat4), 32);
+	skel->BindPose = (SkrBonePose*)m_skr_aligned_alloc(
+	        bones * sizeof(SkrBonePose), 16);
+
+	if (!skel->Parent || !skel->InverseBind || !skel->BindPose) {
+		skr_skeleton_free(skel);
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to allocate skeleton");
+		return 0;
+	}
+
+	for (unsigned int i = 0; i < bones; ++i) {
+		skel->Parent[i] = -1;
+		glm_mat4_identity(skel->InverseBind[i]);
+		glm_quat_identity(skel->BindPose[i].Rotation);
+		glm_vec4_zero(skel->BindPose[i].Translation);
+		glm_vec4_one(skel->BindPose[i].Scale);
+	}
+
+	skel->BoneCount = bones;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief ::skr_skeleton_model over the bones kept by `remap` (or all).
+ */
+static inline void m_skr_skeleton_model(const SkrSkeleton* skel,
+                                        const SkrBonePose* local,
+                                        const int* remap, mat4* model) {
+	for (unsigned int i = 0; i < skel->BoneCount; ++i) {
+		if (remap && remap[i] != (int)i)
+			continue;
+
+		const SkrBonePose* p = &local[i];
+		const int          parent = skel->Parent[i];
+
+		if (parent < 0) {
+			m_skr_trs_mat4(p->Translation, p->Rotation, p->Scale,
+			               model[i]);
+		} else {
+			mat4 m;
+			m_skr_trs_mat4(p->Translation, p->Rotation, p->Scale, m);
+			glm_mul(model[parent], m, model[i]);
+		}
+	}
+}
+
+/**
+ * @internal
+ * @brief ::skr_skeleton_palette writing to `rows`; bones dropped by
+ * `remap` copy the rows of the bone they follow.
+ */
+static inline void m_skr_skeleton_palette(const SkrSkeleton* skel,
+                                          const mat4*        model,
+                                          const int* remap, vec4* rows) {
+	for (unsigned int i = 0; i < skel->BoneCount; ++i) {
+		vec4* out = &rows[i * 3];
+
+		if (remap && remap[i] != (int)i) {
+			memcpy(out, &rows[remap[i] * 3], 3 * sizeof(vec4));
+			continue;
+		}
+
+		mat4 m;
+		glm_mul((vec4*)model[i], skel->InverseBind[i], m);
+		for (int r = 0; r < 3; ++r) {
+			out[r][0] = m[0][r];
+			out[r][1] = m[1][r];
+			out[r][2] = m[2][r];
+			out[r][3] = m[3][r];
+		}
+	}
+}
+
+/**
+ * @brief Compose local bone transforms into model-space matrices.
+ *
+ * @param model Output, one matrix per bone (32-byte aligned).
+ */
+SKR_API void skr_skeleton_model(const SkrSkeleton* skel,
+                                const SkrBonePose* local, mat4* model) {
+	m_skr_skeleton_model(skel, local, NULL, model);
+}
+
+/**
+ * @brief Write the skinning matrices of a posed skeleton to a palette.
+ *
+ * Does not mark the palette for upload, so instances can be written from
+ * several jobs; call ::skr_skinning_mark afterwards.
+ *
+ * @param model Output of ::skr_skeleton_model.
+ * @param base  Palette from ::skr_skinning_alloc with BoneCount bones.
+ */
+SKR_API void skr_skeleton_palette(const SkrSkeleton* skel, const mat4* model,
+                                  SkrSkinning* skin, const int base) {
+	m_skr_skeleton_palette(skel, model, NULL,
+	                       &skin->Bones[(unsigned int)base * 3]);
+}
+
+/**
+ * @brief Release the arrays of `skel` and reset it.
+ */
+SKR_API void skr_skeleton_free(SkrSkeleton* skel) {
+	if (!skel)
+		return;
+
+	free(skel->Parent);
+	m_skr_aligned_free(skel->InverseBind);
+	m_skr_aligned_free(skel->BindPose);
+	*skel = (SkrSkeleton){0};
+}
+
+/**
+ * @internal
+ * @brief Largest component of a smallest-three quaternion, 1/sqrt(2).
+ */
+#define M_SKR_QUAT_RANGE 0.70710678f
+
+/**
+ * @internal
+ * @brief Quantize a unit quaternion to 47 bits (smallest three).
+ */
+static inline void m_skr_quat_encode(const float* q, uint16_t out[3]) {
+	int largest = 0;
+	for (int i = 1; i < 4; ++i)
+		if (fabsf(q[i]) > fabsf(q[largest]))
+			largest = i;
+
+	/* q and -q are the same rotation: make the dropped one positive. */
+	const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+	for (int i = 0, k = 0; i < 4; ++i) {
+		if (i == largest)
+			continue;
+
+		const float v = glm_clamp(sign * q[i] / M_SKR_QUAT_RANGE, -1.0f,
+		                          1.0f);
+		out[k++] = (uint16_t)lroundf((v * 0.5f + 0.5f) * 32767.0f);
+	}
+
+	out[0] |= (uint16_t)((largest & 1) << 15);
+	out[1] |= (uint16_t)((largest >> 1) << 15);
+}
+
+/**
+ * @internal
+ * @brief Expand a quaternion from ::m_skr_quat_encode.
+ */
+static inline void m_skr_quat_decode(const uint16_t in[3], versor q) {
+	const int largest = (in[0] >> 15) | ((in[1] >> 15) << 1);
+	float     sum = 0.0f;
+
+	for (int i = 0, k = 0; i < 4; ++i) {
+		if (i == largest)
+			continue;
+
+		const float v = (float)(in[k++] & 0x7fff) * (1.0f / 32767.0f);
+		q[i] = (v * 2.0f - 1.0f) * M_SKR_QUAT_RANGE;
+		sum += q[i] * q[i];
+	}
+
+	q[largest] = sqrtf(glm_max(1.0f - sum, 0.0f));
+}
+
+/**
+ * @brief Compress keyframes into a clip.
+ *
+ * @param tracks ::SKR_TRACK_TYPES sources per bone, in ::SkrTrackType order.
+ * @return 1 on success, 0 on failure.
+ */
+SKR_API int skr_clip_build(SkrClip* clip, const float duration,
+                           const unsigned int    bones,
+                           const SkrTrackSource* tracks) {
+	const unsigned int track_count = bones * SKR_TRACK_TYPES;
+	unsigned int       keys = 0;
+
+	if (!clip || !tracks || duration <= 0.0f) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "clip needs tracks and a duration");
+		return 0;
+	}
+
+	for (unsigned int t = 0; t < track_count; ++t)
+		keys += tracks[t].Count;
+
+	*clip = (SkrClip){.Duration = duration, .BoneCount = bones};
+	clip->Tracks = (SkrTrack*)calloc(track_count, sizeof(SkrTrack));
+	clip->Keys = (SkrKey*)malloc((keys ? keys : 1) * sizeof(SkrKey));
+	if (!clip->Tracks || !clip->Keys) {
+		skr_clip_free(clip);
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to allocate clip");
+		return 0;
+	}
+
+	for (unsigned int t = 0; t < track_count; ++t) {
+		const SkrTrackSource* src = &tracks[t];
+		SkrTrack*             dst = &clip->Tracks[t];
+		const bool rotation = t % SKR_TRACK_TYPES == SKR_TRACK_ROTATION;
+		const int  width = rotation ? 4 : 3;
+
+		dst->First = clip->KeyCount;
+		dst->Count = src->Count;
+
+		/* Per-track range of translation and scale. */
+		vec3 max;
+		for (int c = 0; c < 3 && src->Count; ++c) {
+			dst->Min[c] = max[c] = src->Values[c];
+			for (unsigned int k = 1; k < src->Count; ++k) {
+				const float v = src->Values[k * 3 + c];
+				dst->Min[c] = glm_min(dst->Min[c], v);
+				max[c] = glm_max(max[c], v);
+			}
+			dst->Step[c] = (max[c] - dst->Min[c]) / 65535.0f;
+		}
+
+		for (unsigned int k = 0; k < src->Count; ++k) {
+			SkrKey*      key = &clip->Keys[clip->KeyCount++];
+			const float* v = &src->Values[k * width];
+			const float  f = glm_clamp(src->Times[k] / duration, 0.0f,
+			                           1.0f);
+
+			key->Time = (uint16_t)lroundf(f * 65535.0f);
+
+			if (rotation) {
+				versor q;
+				glm_quat_normalize_to((float*)v, q);
+				m_skr_quat_encode(q, key->Value);
+				continue;
+			}
+
+			for (int c = 0; c < 3; ++c)
+				key->Value[c] =
+				        dst->Step[c] > 0.0f
+				                ? (uint16_t)lroundf(
+				                          (v[c] - dst->Min[c]) /
+				                          dst->Step[c])
+				                : 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Release the arrays of `clip` and reset it.
+ */
+SKR_API void skr_clip_free(SkrClip* clip) {
+	if (!clip)
+		return;
+
+	free(clip->Tracks);
+	free(clip->Keys);
+	*clip = (SkrClip){0};
+}
+
+/**
+ * @brief Allocate a playback cursor for `clip`, at its start.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+SKR_API int skr_clip_cursor_init(SkrClipCursor* cursor, const SkrClip* clip) {
+	*cursor = (SkrClipCursor){0};
+	cursor->Key = (unsigned int*)calloc(
+	        (size_t)clip->BoneCount * SKR_TRACK_TYPES, sizeof(unsigned int));
+	if (!cursor->Key) {
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to allocate clip cursor");
+		return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Release the cursor's key cache.
+ */
+SKR_API void skr_clip_cursor_free(SkrClipCursor* cursor) {
+	if (!cursor)
+		return;
+
+	free(cursor->Key);
+	*cursor = (SkrClipCursor){0};
+}
+
+/**
+ * @internal
+ * @brief Decode key `k` of a translation or scale track.
+ */
+static inline void m_skr_track_decode(const SkrTrack* track, const SkrKey* key,
+                                      vec4 out) {
+	out[0] = track->Min[0] + (float)key->Value[0] * track->Step[0];
+	out[1] = track->Min[1] + (float)key->Value[1] * track->Step[1];
+	out[2] = track->Min[2] + (float)key->Value[2] * track->Step[2];
+	out[3] = 0.0f;
+}
+
+/**
+ * @internal
+ * @brief ::skr_clip_sample skipping the bones dropped by `remap`.
+ */
+static inline void m_skr_clip_sample(const SkrClip* clip,
+                                     SkrClipCursor* cursor, const float time,
+                                     const int* remap, SkrBonePose* out) {
+	const float        t = clip->Duration > 0.0f
+	                               ? glm_clamp(time / clip->Duration, 0.0f,
+	                                           1.0f) * 65535.0f
+	                               : 0.0f;
+	const unsigned int track_count = clip->BoneCount * SKR_TRACK_TYPES;
+
+	if (time < cursor->Time)
+		memset(cursor->Key, 0, track_count * sizeof(unsigned int));
+	cursor->Time = time;
+
+	for (unsigned int i = 0; i < track_count; ++i) {
+		const SkrTrack* track = &clip->Tracks[i];
+		const int       bone = (int)(i / SKR_TRACK_TYPES);
+
+		if (track->Count == 0 || (remap && remap[bone] != bone))
+			continue;
+
+		const SkrKey* keys = &clip->Keys[track->First];
+		unsigned int  k = cursor->Key[i];
+
+		while (k + 1 < track->Count && keys[k + 1].Time <= t)
+			k++;
+		cursor->Key[i] = k;
+
+		const unsigned int n = k + 1 < track->Count ? k + 1 : k;
+		const float        span = (float)(keys[n].Time - keys[k].Time);
+		const float        f =
+		        span > 0.0f
+		                       ? glm_clamp((t - keys[k].Time) / span, 0.0f,
+		                                   1.0f)
+		                       : 0.0f;
+
+		SkrBonePose* pose = &out[i / SKR_TRACK_TYPES];
+		vec4         a, b;
+
+		switch (i % SKR_TRACK_TYPES) {
+		case SKR_TRACK_ROTATION:
+			m_skr_quat_decode(keys[k].Value, a);
+			m_skr_quat_decode(keys[n].Value, b);
+			if (glm_vec4_dot(a, b) < 0.0f)
+				glm_vec4_negate(b);
+			glm_vec4_lerp(a, b, f, pose->Rotation);
+			glm_quat_normalize(pose->Rotation);
+			break;
+		case SKR_TRACK_TRANSLATION:
+			m_skr_track_decode(track, &keys[k], a);
+			m_skr_track_decode(track, &keys[n], b);
+			glm_vec4_lerp(a, b, f, pose->Translation);
+			break;
+		default:
+			m_skr_track_decode(track, &keys[k], a);
+			m_skr_track_decode(track, &keys[n], b);
+			glm_vec4_lerp(a, b, f, pose->Scale);
+			break;
+		}
+	}
+}
+
+/**
+ * @brief Sample a clip at `time` seconds into local bone transforms.
+ *
+ * Bones whose tracks have no keys keep the values already in `out`, so it
+ * is usually seeded with SkrSkeleton::BindPose. Sampling at or after the
+ * previous time reuses the cursor; earlier times (e.g. looping) rewind it.
+ *
+ * @param time Time in [0, SkrClip::Duration], clamped.
+ */
+SKR_API void skr_clip_sample(const SkrClip* clip, SkrClipCursor* cursor,
+                             const float time, SkrBonePose* out) {
+	m_skr_clip_sample(clip, cursor, time, NULL, out);
+}
+
+/**
+ * @brief Blend two poses, `weight` 0 gives `a` and 1 gives `b`.
+ *
+ * With a `mask` (one factor per bone) the weight is scaled per bone, which
+ * layers `b` over part of the skeleton, e.g. an upper-body action over a
+ * walk. `out` may alias `a` or `b`.
+ */
+SKR_API void skr_pose_blend(SkrBonePose* out, const SkrBonePose* a,
+                            const SkrBonePose* b, const float weight,
+                            const float* mask, const unsigned int bones) {
+	for (unsigned int i = 0; i < bones; ++i) {
+		const float w = mask ? weight * mask[i] : weight;
+		versor      rb;
+
+		/* Shortest arc, then normalized lerp. */
+		glm_vec4_copy((float*)b[i].Rotation, rb);
+		if (glm_vec4_dot((float*)a[i].Rotation, rb) < 0.0f)
+			glm_vec4_negate(rb);
+
+		glm_vec4_lerp((float*)a[i].Rotation, rb, w, out[i].Rotation);
+		glm_quat_normalize(out[i].Rotation);
+		glm_vec4_lerp((float*)a[i].Translation,
+		              (float*)b[i].Translation, w, out[i].Translation);
+		glm_vec4_lerp((float*)a[i].Scale, (float*)b[i].Scale, w,
+		              out[i].Scale);
+	}
+}
+
+/**
+ * @internal
+ * @brief Grow every column of `a` to hold at least `count` rows.
+ */
+static inline int m_skr_animations_reserve(SkrAnimations*     a,
+                                           const unsigned int count) {
+	if (count <= a->Capacity)
+		return 1;
+
+	const size_t old = a->Capacity;
+	size_t       cap = a->Capacity ? a->Capacity * 2 : 64;
+	while (cap < count)
+		cap *= 2;
+
+#define M_SKR_ANIMATIONS_GROW(field, type)                                     \
+	do {                                                                   \
+		type* grown = (type*)m_skr_aligned_grow(                       \
+		        a->field, old * sizeof(type), cap * sizeof(type), 16); \
+		if (!grown)                                                    \
+			goto fail;                                             \
+		a->field = grown;                                              \
+	} while (0)
+
+	M_SKR_ANIMATIONS_GROW(Skeleton, SkrSkeleton*);
+	M_SKR_ANIMATIONS_GROW(Clip, SkrClip*);
+	M_SKR_ANIMATIONS_GROW(Cursor, SkrClipCursor);
+	M_SKR_ANIMATIONS_GROW(Time, float);
+	M_SKR_ANIMATIONS_GROW(Speed, float);
+	M_SKR_ANIMATIONS_GROW(Palette, int);
+	M_SKR_ANIMATIONS_GROW(Renderable, SkrRenderable);
+	M_SKR_ANIMATIONS_GROW(Lod, unsigned char);
+	M_SKR_ANIMATIONS_GROW(Age, unsigned int);
+	M_SKR_ANIMATIONS_GROW(Interval, unsigned int);
+	M_SKR_ANIMATIONS_GROW(Frame, unsigned int);
+	M_SKR_ANIMATIONS_GROW(Queue, uint64_t);
+
+#undef M_SKR_ANIMATIONS_GROW
+
+	a->Capacity = (unsigned int)cap;
+	return 1;
+
+fail:
+	m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+	                     "failed to grow animations");
+	return 0;
+}
+
+/**
+ * @brief Add an animated instance of `skel` playing `clip` in a loop.
+ *
+ * Throttled rows blend across the loop point, so the clip's first and
+ * last poses should match.
+ *
+ * Allocates the instance's palette in `skin`; assign it to the renderable
+ * with ::skr_renderables_set_skin. Unset SkrAnimations::Lods take
+ * defaults: every frame down to a tenth of the view, then every 2, 4 and
+ * 8 frames as the character shrinks, and frozen offscreen.
+ *
+ * @param renderable Renderable whose bounds pick the LOD, 0 to always
+ *                   animate at full rate. Once it is removed the row
+ *                   animates at full rate.
+ * @return Row index, or -1 on failure.
+ */
+SKR_API int skr_animations_add(SkrAnimations* a, SkrSkinning* skin,
+                               SkrSkeleton* skel, SkrClip* clip,
+                               const SkrRenderable renderable) {
+	if (!a || !skin || !skel || !clip ||
+	    clip->BoneCount != skel->BoneCount || !(clip->Duration > 0.0f)) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "animation needs a skeleton and a clip "
+		                     "with the same bones and a duration");
+		return -1;
+	}
+
+	bool unset = true;
+	for (int l = 0; l < SKR_ANIM_LODS; ++l)
+		unset = unset && a->Lods[l].Interval == 0;
+	if (unset) {
+		a->Lods[0] = (SkrAnimLod){0.1f, 1};
+		a->Lods[1] = (SkrAnimLod){0.03f, 2};
+		a->Lods[2] = (SkrAnimLod){0.01f, 4};
+		a->Lods[3] = (SkrAnimLod){0.0f, 8};
+	}
+
+	const unsigned int rows = skel->BoneCount * 3;
+	const unsigned int frames = a->FrameCount + rows * 2;
+	if (frames > a->FrameCapacity) {
+		unsigned int cap = a->FrameCapacity ? a->FrameCapacity : 1024;
+		while (cap < frames)
+			cap *= 2;
+
+		vec4* grown = (vec4*)m_skr_aligned_grow(
+		        a->Frames, (size_t)a->FrameCapacity * sizeof(vec4),
+		        (size_t)cap * sizeof(vec4), 16);
+		if (!grown) {
+			m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+			                     "failed to grow animation frames");
+			return -1;
+		}
+
+		a->Frames = grown;
+		a->FrameCapacity = cap;
+	}
+
+	if (skel->BoneCount > a->ScratchBones) {
+		const size_t size =
+		        skel->BoneCount * (sizeof(mat4) + sizeof(SkrBonePose));
+		void* scratch = m_skr_aligned_alloc(size, 32);
+		if (!scratch) {
+			m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+			                     "failed to allocate pose scratch");
+			return -1;
+		}
+
+		m_skr_aligned_free(a->Scratch);
+		a->Scratch = scratch;
+		a->ScratchBones = skel->BoneCount;
+	}
+
+	if (!m_skr_animations_reserve(a, a->Count + 1))
+		return -1;
+
+	const unsigned int i = a->Count;
+	if (!skr_clip_cursor_init(&a->Cursor[i], clip))
+		return -1;
+
+	const int palette = skr_skinning_alloc(skin, skel->BoneCount);
+	if (palette < 0) {
+		skr_clip_cursor_free(&a->Cursor[i]);
+		return -1;
+	}
+
+	a->Skeleton[i] = skel;
+	a->Clip[i] = clip;
+	a->Time[i] = 0.0f;
+	a->Speed[i] = 1.0f;
+	a->Palette[i] = palette;
+	a->Renderable[i] = renderable;
+	a->Lod[i] = 0;
+	a->Age[i] = 0;
+	a->Interval[i] = 0; /* Due on the first update. */
+	a->Frame[i] = a->FrameCount;
+
+	a->FrameCount = frames;
+	a->Count++;
+	return (int)i;
+}
+
+/**
+ * @internal
+ * @brief Pick the LOD of row `i`, SKR_ANIM_LODS when offscreen.
+ */
+static inline unsigned char m_skr_animations_lod(const SkrAnimations*  a,
+                                                 const unsigned int    i,
+                                                 const SkrView*        view,
+                                                 const SkrRenderables* r) {
+	const int row = skr_renderables_row(r, a->Renderable[i]);
+	if (!view || !view->Valid || row < 0)
+		return 0;
+
+	const float* b = r->Bounds[row];
+	for (int p = 0; p < 6; ++p) {
+		const float* plane = view->Planes[p];
+		if (glm_vec3_dot((float*)plane, (float*)b) + plane[3] < -b[3])
+			return SKR_ANIM_LODS;
+	}
+
+	const float distance = glm_vec3_distance((float*)b,
+	                                         (float*)view->Position);
+	const float size = b[3] / glm_max(distance, 1e-4f);
+
+	for (unsigned char l = 0; l < SKR_ANIM_LODS - 1; ++l)
+		if (size >= a->Lods[l].MinSize)
+			return l;
+	return SKR_ANIM_LODS - 1;
+}
+
+/**
+ * @internal
+ * @brief Frames between samples at `lod`, 0 when frozen.
+ */
+static inline unsigned int m_skr_animations_interval(const SkrAnimations* a,
+                                                     const unsigned char lod) {
+	return lod < SKR_ANIM_LODS ? a->Lods[lod].Interval
+	                           : a->OffscreenInterval;
+}
+
+/**
+ * @internal
+ * @brief Wrap `t` into a looping clip, 0 if it has no length.
+ */
+static inline float m_skr_clip_wrap(const float t, const float duration) {
+	if (!(duration > 0.0f))
+		return 0.0f;
+
+	const float wrapped = fmodf(t, duration);
+	return wrapped < 0.0f ? wrapped + duration : wrapped;
+}
+
+/**
+ * @internal
+ * @brief Sample row `i` for the next `ahead` frames of `dt`.
+ *
+ * With `ahead` 1 the pose goes straight to the palette. Otherwise the
+ * palette as shown, one frame old, becomes the start pose and the clip is
+ * sampled `ahead - 1` frames on, so blending by (age + 1) / ahead tracks
+ * the clip exactly while `dt` holds.
+ */
+static inline void m_skr_animations_sample(SkrAnimations* a, SkrSkinning* skin,
+                                           const unsigned int i,
+                                           const unsigned int ahead,
+                                           const float        dt) {
+	SkrSkeleton*       skel = a->Skeleton[i];
+	const SkrClip*     clip = a->Clip[i];
+	const unsigned int bones = skel->BoneCount;
+	const int*         remap =
+	        skel->Remap[a->Lod[i] < SKR_ANIM_LODS ? a->Lod[i]
+	                                              : SKR_ANIM_LODS - 1];
+	mat4*        model = (mat4*)a->Scratch;
+	SkrBonePose* pose = (SkrBonePose*)&model[a->ScratchBones];
+	vec4*        palette = &skin->Bones[(unsigned int)a->Palette[i] * 3];
+	vec4*        to = palette;
+
+	float t = a->Time[i];
+	if (ahead > 1) {
+		vec4* from = &a->Frames[a->Frame[i]];
+		memcpy(from, palette, bones * 3 * sizeof(vec4));
+		to = from + bones * 3;
+
+		t = m_skr_clip_wrap(t + a->Speed[i] * dt * (float)(ahead - 1),
+		                    clip->Duration);
+	}
+
+	memcpy(pose, skel->BindPose, bones * sizeof(SkrBonePose));
+	m_skr_clip_sample(clip, &a->Cursor[i], t, remap, pose);
+	m_skr_skeleton_model(skel, pose, remap, model);
+	m_skr_skeleton_palette(skel, (const mat4*)model, remap, to);
+
+	a->Age[i] = 0;
+	a->Interval[i] = ahead;
+}
+
+/**
+ * @internal
+ * @brief Order queued rows most urgent first, for qsort.
+ */
+static inline int m_skr_animations_cmp(const void* a, const void* b) {
+	const uint64_t x = *(const uint64_t*)a;
+	const uint64_t y = *(const uint64_t*)b;
+	return (x < y) - (x > y);
+}
+
+/**
+ * @brief Advance every animation by `dt` seconds and update its palette.
+ *
+ * Each row picks a level from how large its renderable's bounds appear
+ * from `view` and is sampled once per SkrAnimLod::Interval frames, only
+ * on the bones its SkrSkeleton::Remap keeps. Between samples the palette
+ * blends towards a pose sampled ahead, so throttled characters still move
+ * smoothly. With a SkrAnimations::Budget the most overdue and most
+ * detailed rows are sampled first and the rest wait a frame.
+ *
+ * @param view Camera the LOD is measured from, or NULL for full rate.
+ */
+SKR_API void skr_animations_update(SkrAnimations* a, SkrSkinning* skin,
+                                   const SkrView*        view,
+                                   const SkrRenderables* r, const float dt) {
+	unsigned int queued = 0;
+
+	a->Sampled = 0;
+	a->Deferred = 0;
+	a->Frozen = 0;
+
+	for (unsigned int i = 0; i < a->Count; ++i) {
+		a->Time[i] = m_skr_clip_wrap(a->Time[i] + a->Speed[i] * dt,
+		                             a->Clip[i]->Duration);
+
+		const unsigned char lod = m_skr_animations_lod(a, i, view, r);
+		const unsigned int  interval =
+		        m_skr_animations_interval(a, lod);
+
+		/* Rows entering a rate together start spread over it. */
+		const bool entered = lod != a->Lod[i] || a->Interval[i] == 0;
+
+		a->Lod[i] = lod;
+		if (interval == 0 && a->Interval[i] != 0) {
+			/* Hold the pose as shown, due as soon as it thaws. */
+			a->Age[i] = a->Interval[i];
+			a->Frozen++;
+			continue;
+		}
+
+		/* Due once its span has been shown, or sooner if the row now
+		 * needs a higher rate than it was sampled for. */
+		a->Age[i]++;
+		if (a->Age[i] < a->Interval[i] && interval >= a->Interval[i])
+			continue;
+
+		uint64_t overdue = a->Age[i] > a->Interval[i]
+		                           ? a->Age[i] - a->Interval[i]
+		                           : 0;
+		if (overdue > 0xffffff)
+			overdue = 0xffffff;
+		a->Queue[queued++] = overdue << 40 |
+		                     (uint64_t)(SKR_ANIM_LODS - lod) << 36 |
+		                     (uint64_t)entered << 32 | i;
+	}
+
+	if (a->Budget > 0.0f && queued > 1)
+		qsort(a->Queue, queued, sizeof(uint64_t), m_skr_animations_cmp);
+
+	const double deadline = skr_clock_now() + a->Budget * 1e-6;
+	for (unsigned int q = 0; q < queued; ++q) {
+		/* Always sample one so the most urgent row makes progress. */
+		if (a->Budget > 0.0f && q > 0 && skr_clock_now() >= deadline) {
+			a->Deferred = queued - q;
+			break;
+		}
+
+		const uint64_t     key = a->Queue[q];
+		const unsigned int i = (unsigned int)(key & 0xffffffff);
+		unsigned int       ahead = m_skr_animations_interval(a, a->Lod[i]);
+
+		if (ahead == 0)
+			ahead = 1;
+		else if (key >> 32 & 1)
+			ahead = 1 + i % ahead;
+
+		m_skr_animations_sample(a, skin, i, ahead, dt);
+		a->Sampled++;
+	}
+
+	for (unsigned int i = 0; i < a->Count; ++i) {
+		const unsigned int bones = a->Skeleton[i]->BoneCount;
+		const unsigned int n = a->Interval[i];
+
+		if (n > 1 && a->Age[i] < n) {
+			const vec4* from = &a->Frames[a->Frame[i]];
+			const vec4* to = from + bones * 3;
+			vec4*       palette =
+			        &skin->Bones[(unsigned int)a->Palette[i] * 3];
+			const float f = (float)(a->Age[i] + 1) / (float)n;
+
+			for (unsigned int k = 0; k < bones * 3; ++k)
+				glm_vec4_lerp((float*)from[k], (float*)to[k], f,
+				              palette[k]);
+		} else if (a->Age[i] != 0) {
+			continue; /* Frozen or holding the end of its span. */
+		}
+
+		skr_skinning_mark(skin, a->Palette[i], bones);
+	}
+}
+
+/**
+ * @brief Release every row of `a` and reset it, keeping its settings.
+ *
+ * Palettes stay allocated in the SkrSkinning they came from.
+ */
+SKR_API void skr_animations_free(SkrAnimations* a) {
+	if (!a)
+		return;
+
+	for (unsigned int i = 0; i < a->Count; ++i)
+		skr_clip_cursor_free(&a->Cursor[i]);
+
+	m_skr_aligned_free(a->Skeleton);
+	m_skr_aligned_free(a->Clip);
+	m_skr_aligned_free(a->Cursor);
+	m_skr_aligned_free(a->Time);
+	m_skr_aligned_free(a->Speed);
+	m_skr_aligned_free(a->Palette);
+	m_skr_aligned_free(a->Renderable);
+	m_skr_aligned_free(a->Lod);
+	m_skr_aligned_free(a->Age);
+	m_skr_aligned_free(a->Interval);
+	m_skr_aligned_free(a->Frame);
+	m_skr_aligned_free(a->Queue);
+	m_skr_aligned_free(a->Frames);
+	m_skr_aligned_free(a->Scratch);
+
+	const SkrAnimations settings = *a;
+	*a = (SkrAnimations){0};
+	memcpy(a->Lods, settings.Lods, sizeof(a->Lods));
+	a->OffscreenInterval = settings.OffscreenInterval;
+	a->Budget = settings.Budget;
+}
+
+/**
+ * @internal
+ * @brief GL framebuffer resize callback
+ *
+ * Adjusts the OpenGL viewport when the window is resized.
+ *
+ * @param width  New framebuffer width.
+ * @param height New framebuffer height.
+ */
+static inline void m_skr_gl_framebuffer_size_callback(const int width,
+                                                      const int height) {
+	glViewport(0, 0, width, height);
+}
+
+/**
+ * @internal
+ * @brief GLFW framebuffer resize callback wrapper.
+ *
+ * @param window GLFW window handle.
+ * @param width  New framebuffer width.
+ * @param height New framebuffer height.
+ */
+static inline void m_skr_gl_glfw_framebuffer_size_callback(GLFWwindow* window,
+                                                           const int   width,
+                                                           const int   height) {
+	(void)window;
+	m_skr_gl_framebuffer_size_callback(width, height);
+}
+
+/**
+ * @internal
+ * @brief GLFW queue an event for the window's simulation.
+ */
+static inline void m_skr_glfw_input_push(GLFWwindow* window, SkrInputEvent e) {
+	SkrWindow* w = (SkrWindow*)glfwGetWindowUserPointer(window);
+
+	e.Time = skr_clock_now();
+	skr_input_push(&w->Input, &e);
+}
+
+static inline void m_skr_glfw_key_callback(GLFWwindow* window, int key,
+                                           int scancode, int action, int mods) {
+	(void)scancode;
+	m_skr_glfw_input_push(window, (SkrInputEvent){.Type = SKR_INPUT_KEY,
+	                                              .Code = key,
+	                                              .Action = action,
+	                                              .Mods = mods});
+}
+
+static inline void m_skr_glfw_mouse_button_callback(GLFWwindow* window,
+                                                    int button, int action,
+                                                    int mods) {
+	m_skr_glfw_input_push(window,
+	                      (SkrInputEvent){.Type = SKR_INPUT_MOUSE_BUTTON,
+	                                      .Code = button,
+	                                      .Action = action,
+	                                      .Mods = mods});
+}
+
+static inline void m_skr_glfw_cursor_pos_callback(GLFWwindow* window,
+                                                  double x, double y) {
+	m_skr_glfw_input_push(window,
+	                      (SkrInputEvent){.Type = SKR_INPUT_MOUSE_MOVE,
+	                                      .X = x,
+	                                      .Y = y});
+}
+
+static inline void m_skr_glfw_scroll_callback(GLFWwindow* window, double x,
+                                              double y) {
+	m_skr_glfw_input_push(window, (SkrInputEvent){.Type = SKR_INPUT_SCROLL,
+	                                              .X = x,
+	                                              .Y = y});
+}
+
+static inline void m_skr_glfw_char_callback(GLFWwindow*  window,
+                                            unsigned int codepoint) {
+	m_skr_glfw_input_push(window, (SkrInputEvent){.Type = SKR_INPUT_CHAR,
+	                                              .Code = (int)codepoint});
+}
+
+/**
+ * @internal
+ * @brief Initialize a GLFW window for OpenGL rendering.
+ *
+ * @param w Pointer to SkrWindow to initialize (must not be NULL).
+ * @return 1 on success, 0 on failure.
+ */
+static inline int m_skr_gl_glfw_init(SkrWindow* w) {
+	if (!glfwInit() || !w) {
+		m_skr_last_error_set(
+		        SKR_ERROR_WINDOW,
+		        "either glfwInit != 1 or SkrWindow == NULL");
+		return 0;
+	}
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT,
+	               w->Debug ? GLFW_TRUE : GLFW_FALSE);
+
+	w->Backend.Handler.GLFW = NULL;
+
+	w->Backend.Handler.GLFW =
+	        glfwCreateWindow(w->Width, w->Height, w->Title, NULL, NULL);
+
+	if (!w->Backend.Handler.GLFW) {
+		m_skr_last_error_set(SKR_ERROR_WINDOW, "window backend is NULL");
+		glfwTerminate();
+		return 0;
+	}
+
+	glfwSetFramebufferSizeCallback(w->Backend.Handler.GLFW,
+	                               m_skr_gl_glfw_framebuffer_size_callback);
+
+	/* Events are queued as they arrive, whoever pumps them. */
+	glfwSetWindowUserPointer(w->Backend.Handler.GLFW, w);
+	glfwSetKeyCallback(w->Backend.Handler.GLFW, m_skr_glfw_key_callback);
+	glfwSetMouseButtonCallback(w->Backend.Handler.GLFW,
+	                           m_skr_glfw_mouse_button_callback);
+	glfwSetCursorPosCallback(w->Backend.Handler.GLFW,
+	                         m_skr_glfw_cursor_pos_callback);
+	glfwSetScrollCallback(w->Backend.Handler.GLFW,
+	                      m_skr_glfw_scroll_callback);
+	glfwSetCharCallback(w->Backend.Handler.GLFW, m_skr_glfw_char_callback);
+
+	glfwMakeContextCurrent(w->Backend.Handler.GLFW);
+
+	m_skr_last_error_clear();
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief GL check shader or program compile/link status.
+ *
+ * @param shader OpenGL shader or program ID.
+ * @param type   String ("vert","frag","prog", etc.).
+ *
+ * @return ::SKR_SUCCESS, or ::SKR_ERROR_SHADER if compiling or linking
+ * failed.
+ */
+static inline SkrResult m_skr_gl_check_compile_errors(const GLuint shader,
+                                                      const char*  type) {
+	GLint  success;
+	GLchar infoLog[1024];
+
+	if (strcmp(type, "prog") == 0) {
+		glGetProgramiv(shader, GL_LINK_STATUS, &success);
+		if (!success) {
+			glGetProgramInfoLog(shader, sizeof(infoLog), NULL,
+			                    infoLog);
+			m_skr_last_error_set(SKR_ERROR_SHADER,
+			                     "failed to link %s: %s", type,
+			                     infoLog);
+			return SKR_ERROR_SHADER;
+		}
+	} else {
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			glGetShaderInfoLog(shader, sizeof(infoLog), NULL,
+			                   infoLog);
+			m_skr_last_error_set(SKR_ERROR_SHADER,
+			                     "failed to compile %s: %s", type,
+			                     infoLog);
+			return SKR_ERROR_SHADER;
+		}
+	}
+
+	return SKR_SUCCESS;
+}
+
+/**
+ * @internal
+ * @brief GL create an OpenGL shader from source.
+ *
+ * @param type   Shader type (GL_VERTEX_SHADER, etc.).
+ * @param source Null-terminated GLSL source code.
+ *
+ * @return Shader ID, or 0 on failure.
+ */
+static inline GLuint m_skr_gl_create_shader(const GLenum type,
+                                            const char*  source) {
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+
+	const char* type_str = NULL;
+	switch (type) {
+	case GL_VERTEX_SHADER:
+		type_str = "vert";
+		break;
+	case GL_FRAGMENT_SHADER:
+		type_str = "frag";
+		break;
+	case GL_GEOMETRY_SHADER:
+		type_str = "geom";
+		break;
+	case GL_COMPUTE_SHADER:
+		type_str = "comp";
+		break;
+	default:
+		type_str = "unknown";
+		break;
+	}
+
+	if (m_skr_gl_check_compile_errors(shader, type_str) != SKR_SUCCESS) {
+		glDeleteShader(shader);
+		return 0;
+	}
+
+	m_skr_last_error_clear();
+	return shader;
+}
+
+/**
+ * @internal
+ * @brief GL create an OpenGL shader from a file.
+ *
+ * Reads the file contents and compiles it as a shader of the given type.
+ *
+ * @param type Shader type.
+ * @param path File path to GLSL source.
+ *
+ * @return Shader ID, or 0 on failure.
+ */
+static inline GLuint m_skr_gl_create_shader_from_file(const GLenum type,
+                                                      const char*  path) {
+	char* source = m_skr_read_file(path);
+	if (!source) {
+		return 0;
+	}
+
+	GLuint shader = m_skr_gl_create_shader(type, source);
+	free(source);
+
+	m_skr_last_error_clear();
+	return shader;
+}
+
+/**
+ * @internal
+ * @brief GL link multiple shaders into a program.
+ *
+ * Attaches all shaders, links, deletes them, and returns the program.
+ *
+ * @param shaders Array of shader IDs.
+ * @param count   Number of shaders.
+ *
+ * @return Program ID, or 0 on failure.
+ */
+static inline GLuint m_skr_gl_create_program(const GLuint* shaders,
+                                             const size_t  count) {
+	GLuint program = glCreateProgram();
+	for (size_t i = 0; i < count; ++i) {
+		glAttachShader(program, shaders[i]);
+	}
+
+	glLinkProgram(program);
+	if (m_skr_gl_check_compile_errors(program, "prog") != SKR_SUCCESS) {
+		glDeleteProgram(program);
+		return 0;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		glDetachShader(program, shaders[i]);
+		glDeleteShader(shaders[i]);
+	}
+
+	m_skr_last_error_clear();
+	return program;
+}
+
+/**
+ * @internal
+ * @brief GL create program from SkrShader array (source or file).
+ *
+ * @param shaders_input Array of SkrShader descriptors.
+ * @param count         Number of shaders.
+ *
+ * @return Program ID, or 0 on failure.
+ */
+static inline GLuint
+m_skr_gl_create_program_from_shaders(const SkrShader* shader_array,
+                                     const size_t     size) {
+	if (!shader_array || size == 0) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "either shaders_input != 1 or count == 0");
+		return 0;
+	}
+
+	const size_t count = size / sizeof(SkrShader);
+
+	GLuint* shaders = (GLuint*)malloc(sizeof(GLuint) * count);
+	if (!shaders) {
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "shaders_input == NULL");
+		return 0;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		const SkrShader* s = &shader_array[i];
+		GLuint           shader = 0;
+
+		if (s->GLSL) {
+			shader = m_skr_gl_create_shader(s->Type, s->GLSL);
+		} else if (s->Path) {
+			shader = m_skr_gl_create_shader_from_file(s->Type,
+			                                          s->Path);
+		} else {
+			for (size_t j = 0; j < i; ++j) {
+				glDeleteShader(shaders[j]);
+			}
+			free(shaders);
+			m_skr_last_error_set(
+			        SKR_ERROR_INVALID_ARGUMENT,
+			        "shader.Source and shader.Path are NULL");
+			return 0;
+		}
+
+		if (!shader) {
+			for (size_t j = 0; j < i; ++j) {
+				glDeleteShader(shaders[j]);
+			}
+			free(shaders);
+			return 0;
+		}
+
+		shaders[i] = shader;
+	}
+
+	GLuint program = m_skr_gl_create_program(shaders, count);
+	free(shaders);
+
+	if (!program) {
+		return 0;
+	}
+
+	m_skr_last_error_clear();
+	return program;
+}
+
+/**
+ * @internal
+ * @brief GL destroy an OpenGL shader program.
+ *
+ * @param program Pointer to program ID. Resets to 0 on success.
+ */
+static inline void m_skr_gl_shader_destroy(GLuint program) {
+	if (program) {
+		glDeleteProgram(program);
+		program = 0;
+	}
+}
+
+static inline void m_skr_gl_shader_set_bool(const GLuint program,
+                                            const char* name, const int value) {
+	glUniform1i(glGetUniformLocation(program, name), value);
+}
+
+static inline void m_skr_gl_shader_set_int(const GLuint program,
+                                           const char* name, const int value) {
+	glUniform1i(glGetUniformLocation(program, name), value);
+}
+
+static inline void m_skr_gl_shader_set_float(const GLuint program,
+                                             const char*  name,
+                                             const float  value) {
+	glUniform1f(glGetUniformLocation(program, name), value);
+}
+
+static inline void m_skr_gl_shader_set_vec2(const GLuint program,
+                                            const char*  name,
+                                            const vec2   value) {
+	glUniform2fv(glGetUniformLocation(program, name), 1, value);
+}
+
+static inline void m_skr_gl_shader_set_vec3(const GLuint program,
+                                            const char*  name,
+                                            const vec3   value) {
+	glUniform3fv(glGetUniformLocation(program, name), 1, value);
+}
+
+static inline void m_skr_gl_shader_set_vec4(const GLuint program,
+                                            const char*  name,
+                                            const vec4   value) {
+	glUniform4fv(glGetUniformLocation(program, name), 1, value);
+}
+
+static inline void m_skr_gl_shader_set_mat2(const GLuint program,
+                                            const char*  name,
+                                            const mat2   value) {
+	glUniformMatrix2fv(glGetUniformLocation(program, name), 1, GL_FALSE,
+	                   (const float*)value);
+}
+
+static inline void m_skr_gl_shader_set_mat3(const GLuint program,
+                                            const char*  name,
+                                            const mat3   value) {
+	glUniformMatrix3fv(glGetUniformLocation(program, name), 1, GL_FALSE,
+	                   (const float*)value);
+}
+
+static inline void m_skr_gl_shader_set_mat4(const GLuint program,
+                                            const char*  name,
+                                            const mat4   value) {
+	glUniformMatrix4fv(glGetUniformLocation(program, name), 1, GL_FALSE,
+	                   (const float*)value);
+}
+
+/**
+ * @internal
+ * @brief Calling convention of GL callbacks.
+ */
+#if defined(GLAPIENTRY)
+#define M_SKR_GLAPIENTRY GLAPIENTRY
+#elif defined(APIENTRY)
+#define M_SKR_GLAPIENTRY APIENTRY
+#else
+#define M_SKR_GLAPIENTRY
+#endif
+
+/**
+ * @internal
+ * @brief GL check whether the current context exposes an extension.
+ */
+static inline int m_skr_gl_has_extension(const char* name) {
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+	for (GLint i = 0; i < count; ++i) {
+		const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		if (ext && strcmp(ext, name) == 0)
+			return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @internal
+ * @brief GL check whether the current context is at least `major.minor`.
+ */
+static inline int m_skr_gl_has_version(const int major, const int minor) {
+	GLint ctx_major = 0, ctx_minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &ctx_major);
+	glGetIntegerv(GL_MINOR_VERSION, &ctx_minor);
+
+	return ctx_major > major || (ctx_major == major && ctx_minor >= minor);
+}
+
+/**
+ * @brief Count a debug message and decide whether to log it.
+ *
+ * Applies the category mask, the per-ID repeat limit and the per-frame limit,
+ * logging a single notice when an ID starts being suppressed. IDs that find
+ * the table full are only held to the per-frame limit. Driver messages arrive
+ * here; applications may report their own through the same limits.
+ */
+SKR_API void skr_debug_report(SkrState* s, const SkrDebugCategory cat,
+                              const unsigned int id, const char* message) {
+	SkrDebug* d = &s->Debug;
+
+	s->Stats.DebugMessages++;
+	if (cat == SKR_DEBUG_PERFORMANCE)
+		s->Stats.PerformanceWarnings++;
+	else if (cat == SKR_DEBUG_ERROR)
+		s->Stats.Errors++;
+
+	if (!(d->Mask & (1u << cat)))
+		return;
+
+	unsigned int slot = id % SKR_DEBUG_SLOTS;
+	unsigned int probe = 0;
+	for (; probe < SKR_DEBUG_SLOTS; ++probe) {
+		if (d->Seen[slot].Count == 0 || d->Seen[slot].ID == id)
+			break;
+		slot = (slot + 1) % SKR_DEBUG_SLOTS;
+	}
+
+	const bool   tracked = probe < SKR_DEBUG_SLOTS;
+	unsigned int count = 0;
+	if (tracked) {
+		d->Seen[slot].ID = id;
+		count = ++d->Seen[slot].Count;
+	}
+
+	if (count > SKR_DEBUG_MAX_REPEATS ||
+	    d->FrameLogged >= SKR_DEBUG_MAX_PER_FRAME) {
+		s->Stats.Suppressed++;
+		return;
+	}
+
+	d->FrameLogged++;
+
+	char buffer[SKR_LAST_ERROR_SIZE];
+	if (tracked && count == SKR_DEBUG_MAX_REPEATS) {
+		snprintf(buffer, sizeof(buffer), "%s (further repeats suppressed)",
+		         message);
+		message = buffer;
+	}
+
+	if (d->Handler) {
+		d->Handler(cat, id, message);
+	} else {
+		static const char* names[] = {"error", "performance", "undefined",
+		                              "portability", "other"};
+		fprintf(stderr, "[SKR] GL %s %u: %s\n", names[cat], id, message);
+	}
+}
+
+/**
+ * @internal
+ * @brief GL KHR_debug message callback.
+ */
+static inline void M_SKR_GLAPIENTRY m_skr_gl_debug_callback(
+        GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+        const GLchar* message, const void* user) {
+	(void)source;
+	(void)length;
+
+	SkrDebugCategory cat = SKR_DEBUG_OTHER;
+	switch (type) {
+	case GL_DEBUG_TYPE_ERROR:
+		cat = SKR_DEBUG_ERROR;
+		break;
+	case GL_DEBUG_TYPE_PERFORMANCE:
+		cat = SKR_DEBUG_PERFORMANCE;
+		break;
+	case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+	case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+		cat = SKR_DEBUG_UNDEFINED;
+		break;
+	case GL_DEBUG_TYPE_PORTABILITY:
+		cat = SKR_DEBUG_PORTABILITY;
+		break;
+	default:
+		break;
+	}
+
+	if (severity == GL_DEBUG_SEVERITY_NOTIFICATION &&
+	    cat != SKR_DEBUG_PERFORMANCE)
+		cat = SKR_DEBUG_OTHER;
+
+	skr_debug_report((SkrState*)user, cat, id, message);
+}
+
+/**
+ * @internal
+ * @brief GL install driver debug output.
+ *
+ * Uses the KHR_debug callback when available, filtering group and
+ * notification messages in the driver so they never reach the callback.
+ * Falls back to polling glGetError once per frame.
+ */
+static inline void m_skr_gl_debug_init(SkrState* s) {
+	SkrDebug* d = &s->Debug;
+
+	if (d->Mask == 0)
+		d->Mask = ~(1u << SKR_DEBUG_OTHER);
+
+	const int khr = m_skr_gl_has_version(4, 3) ||
+	                m_skr_gl_has_extension("GL_KHR_debug");
+
+	d->Groups = d->Groups && khr;
+	d->Enabled = s->Window->Debug;
+	if (!d->Enabled)
+		return;
+
+	GLint flags = 0;
+	glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+	d->Output = khr && (flags & GL_CONTEXT_FLAG_DEBUG_BIT);
+	d->Groups = khr;
+
+	if (!d->Output)
+		return;
+
+	glEnable(GL_DEBUG_OUTPUT);
+	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	glDebugMessageCallback(m_skr_gl_debug_callback, s);
+
+	glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PUSH_GROUP,
+	                      GL_DONT_CARE, 0, NULL, GL_FALSE);
+	glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_POP_GROUP,
+	                      GL_DONT_CARE, 0, NULL, GL_FALSE);
+	if (!(d->Mask & (1u << SKR_DEBUG_OTHER))) {
+		glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_MARKER,
+		                      GL_DONT_CARE, 0, NULL, GL_FALSE);
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE,
+		                      GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL,
+		                      GL_FALSE);
+		/* Some drivers report perf hints as notifications. */
+		glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PERFORMANCE,
+		                      GL_DONT_CARE, 0, NULL, GL_TRUE);
+	}
+}
+
+/**
+ * @brief Start a frame's statistics and debug limits.
+ *
+ * Called by ::SkrRendererRender. Clears the per-ID repeat counts every
+ * ::SKR_DEBUG_REPEAT_FRAMES frames.
+ */
+SKR_API void skr_debug_frame_begin(SkrState* s) {
+	s->Stats.Frame++;
+	s->Stats.DrawCalls = 0;
+	s->Stats.DebugMessages = 0;
+	s->Stats.PerformanceWarnings = 0;
+	s->Stats.Errors = 0;
+	s->Stats.Suppressed = 0;
+	s->Debug.FrameLogged = 0;
+
+	if (s->Stats.Frame % SKR_DEBUG_REPEAT_FRAMES == 0)
+		memset(s->Debug.Seen, 0, sizeof(s->Debug.Seen));
+}
+
+/**
+ * @internal
+ * @brief GL poll glGetError when no debug callback is installed.
+ */
+static inline void m_skr_gl_debug_frame_end(SkrState* s) {
+	if (!s->Debug.Enabled || s->Debug.Output)
+		return;
+
+	/* Bounded: a lost context reports errors forever. */
+	for (int i = 0; i < 8; ++i) {
+		const GLenum err = glGetError();
+		if (err == GL_NO_ERROR)
+			break;
+		skr_debug_report(s, SKR_DEBUG_ERROR, err, "glGetError");
+	}
+}
+
+/**
+ * @internal
+ * @brief GL open a named debug group around a pass.
+ */
+static inline void m_skr_gl_debug_group_push(const SkrState* s,
+                                             const char*     name) {
+	if (s->Debug.Groups)
+		glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+}
+
+/**
+ * @internal
+ * @brief GL close the debug group opened by ::m_skr_gl_debug_group_push.
+ */
+static inline void m_skr_gl_debug_group_pop(const SkrState* s) {
+	if (s->Debug.Groups)
+		glPopDebugGroup();
+}
+
+/**
+ * @internal
+ * @brief GL draw one mesh with the currently bound program and VAO.
+ */
+static inline void m_skr_gl_draw_mesh(SkrState* s, const SkrMesh* mesh) {
+	if (mesh->IndexCount > 0) {
+		glDrawElements(GL_TRIANGLES, (GLsizei)mesh->IndexCount,
+		               GL_UNSIGNED_INT, 0);
+	} else {
+		glDrawArrays(GL_TRIANGLES, 0, mesh->VertexCount);
+	}
+	s->Stats.DrawCalls++;
+}
+
+/**
+ * @internal
+ * @brief GL face culling for the next draw.
+ *
+ * `front` is the front-face winding to cull the back faces of, or 0 to
+ * draw both sides. `state` holds the current value within a pass, which
+ * must end with `front` 0.
+ */
+static inline void m_skr_gl_cull_face(const GLenum front, GLenum* state) {
+	if (front == *state)
+		return;
+
+	if (!front) {
+		glDisable(GL_CULL_FACE);
+		glFrontFace(GL_CCW);
+	} else {
+		if (!*state)
+			glEnable(GL_CULL_FACE);
+		glFrontFace(front);
+	}
+	*state = front;
+}
+
+/**
+ * @internal
+ * @brief GL draw the index runs `draw` kept from
+ * ::skr_renderables_cull_clusters, or its whole mesh.
+ *
+ * Back faces are culled for SkrMaterial::CullBackFaces, with the winding
+ * flipped under mirroring transforms.
+ */
+static inline void m_skr_gl_draw_item(SkrState* s, const SkrDrawItem* draw,
+                                      GLenum* cull) {
+	const unsigned int* runs = &s->Renderables.Runs[draw->FirstRun * 2];
+	GLsizei             counts[64];
+	const void*         offsets[64];
+
+	GLenum        front = 0;
+	const SkrNode node = s->Renderables.Node[draw->Index];
+	if (draw->Material->CullBackFaces)
+		front = node && m_skr_mat4_mirrors(
+		                        s->Scene.World[s->Scene.Slot[node]])
+		                ? GL_CW
+		                : GL_CCW;
+	m_skr_gl_cull_face(front, cull);
+
+	if (!draw->RunCount) {
+		m_skr_gl_draw_mesh(s, draw->Mesh);
+		return;
+	}
+
+	for (unsigned int k = 0; k < draw->RunCount; k += 64) {
+		const unsigned int left = draw->RunCount - k;
+		const unsigned int n = left < 64 ? left : 64;
+		for (unsigned int j = 0; j < n; ++j) {
+			const unsigned int* run = &runs[(k + j) * 2];
+			counts[j] = (GLsizei)run[1];
+			offsets[j] =
+			        (const void*)(uintptr_t)(run[0] *
+			                                 sizeof(unsigned int));
+		}
+		glMultiDrawElements(GL_TRIANGLES, counts, GL_UNSIGNED_INT,
+		                    offsets, (GLsizei)n);
+		s->Stats.DrawCalls++;
+	}
+}
+
+/**
+ * @internal
+ * @brief GL depth-only program of the depth pre-pass and shadow maps.
+ *
+ * Computes the position exactly as ::skr_lit_3d_vert does, so both
+ * passes produce the same depth for GL_EQUAL testing.
+ */
+static const char* m_skr_gl_depth_vert =
+        "#version 330 core\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "uniform mat4 skr_depth_matrix;\n"
+        "uniform mat4 model;\n"
+        "invariant gl_Position;\n"
+        "void main() {\n"
+        "  vec4 world = model * vec4(aPos, 1.0);\n"
+        "  gl_Position = skr_depth_matrix * world;\n"
+        "}\n";
+
+static const char* m_skr_gl_depth_frag = "#version 330 core\n"
+                                         "void main() {}\n";
+
+/**
+ * @internal
+ * @brief GL depth-only program for deformed shadow casters.
+ *
+ * Applies morph deltas and linear-blend skinning as the skinning pre-pass
+ * does, for casters it did not skin this frame.
+ */
+static const char* m_skr_gl_depth_deform_vert =
+        "#version 330 core\n" SKR_MORPH_GLSL SKR_SKINNING_GLSL
+        "layout (location = 0) in vec3 aPos;\n"
+        "layout (location = 1) in vec3 aNormal;\n"
+        "uniform mat4 skr_depth_matrix;\n"
+        "uniform mat4 model;\n"
+        "void main() {\n"
+        "  vec3 p = aPos, n = aNormal;\n"
+        "  skr_morph(p, n);\n"
+        "  skr_skin_lbs(p, n);\n"
+        "  gl_Position = skr_depth_matrix * (model * vec4(p, 1.0));\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL compile the depth-only program on first use.
+ *
+ * @return 1 when it is available, 0 on failure.
+ */
+static inline int m_skr_gl_depth_init(SkrDepthPass* d) {
+	if (d->Backend.GL.Program)
+		return 1;
+
+	const SkrShader shaders[] = {
+	        {.Type = GL_VERTEX_SHADER, .GLSL = m_skr_gl_depth_vert},
+	        {.Type = GL_FRAGMENT_SHADER, .GLSL = m_skr_gl_depth_frag},
+	};
+	const GLuint program =
+	        m_skr_gl_create_program_from_shaders(shaders, sizeof(shaders));
+	if (!program)
+		return 0;
+
+	d->Backend.GL.Program = program;
+	d->Backend.GL.Matrix =
+	        glGetUniformLocation(program, "skr_depth_matrix");
+	d->Backend.GL.Model = glGetUniformLocation(program, "model");
+
+	const SkrShader deform[] = {
+	        {.Type = GL_VERTEX_SHADER, .GLSL = m_skr_gl_depth_deform_vert},
+	        {.Type = GL_FRAGMENT_SHADER, .GLSL = m_skr_gl_depth_frag},
+	};
+	const GLuint variant =
+	        m_skr_gl_create_program_from_shaders(deform, sizeof(deform));
+	if (!variant) {
+		/* Shadows fall back to undeformed casters. */
+		SkrClearError();
+		return 1;
+	}
+
+	glUseProgram(variant);
+	glUniform1i(glGetUniformLocation(variant, "skr_bones"),
+	            SKR_SKINNING_UNIT);
+	glUniform1i(glGetUniformLocation(variant, "skr_morphs"),
+	            SKR_MORPH_UNIT);
+	d->Backend.GL.Deform = variant;
+	d->Backend.GL.DeformMatrix =
+	        glGetUniformLocation(variant, "skr_depth_matrix");
+	d->Backend.GL.DeformModel = glGetUniformLocation(variant, "model");
+	d->Backend.GL.DeformBone =
+	        glGetUniformLocation(variant, "skr_bone_base");
+	d->Backend.GL.DeformMorph =
+	        glGetUniformLocation(variant, "skr_morph_base");
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief GL VAO the depth-only program draws renderable `i` from.
+ *
+ * Skinned renderables use their pre-pass output. Without one, skinned
+ * and morphed renderables are deformed by their material's vertex
+ * shader, which the depth-only program cannot reproduce: 0 is returned.
+ */
+static inline GLuint m_skr_gl_depth_vao(const SkrState*    s,
+                                        const unsigned int i) {
+	const SkrRenderables* r = &s->Renderables;
+	const SkrSkinning*    k = &s->Skinning;
+
+	if (k->Prepass && r->Skinned[i] && r->Skin[i] >= 0)
+		return k->Outputs[r->Skinned[i] - 1].Backend.GL.VAO;
+	if (r->Skin[i] >= 0 || r->Morph[i] >= 0)
+		return 0;
+	return r->Mesh[i]->PositionVAO;
+}
+
+/**
+ * @internal
+ * @brief GL set the `model` uniform at `location` for renderable `i`.
+ */
+static inline void m_skr_gl_depth_model(const SkrState*    s,
+                                        const unsigned int i,
+                                        const GLint        location) {
+	static const mat4 identity = GLM_MAT4_IDENTITY_INIT;
+	const SkrNode     node = s->Renderables.Node[i];
+
+	glUniformMatrix4fv(
+	        location, 1, GL_FALSE,
+	        node ? (const float*)s->Scene.World[s->Scene.Slot[node]]
+	             : (const float*)identity);
+}
+
+/**
+ * @internal
+ * @brief GL draw the depth of every culled renderable the depth-only
+ * program can reproduce.
+ *
+ * @return 1 if the pre-pass ran, 0 if the program is unavailable.
+ */
+static inline int m_skr_gl_depth_prepass(SkrState* s) {
+	const SkrRenderables* r = &s->Renderables;
+
+	if (!m_skr_gl_depth_init(&s->Depth))
+		return 0;
+
+	m_skr_gl_debug_group_push(s, "skr: depth pre-pass");
+	glUseProgram(s->Depth.Backend.GL.Program);
+	glUniformMatrix4fv(s->Depth.Backend.GL.Matrix, 1, GL_FALSE,
+	                   (const float*)s->View.ViewProjection);
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+	GLuint bound = 0;
+	GLenum cull = 0;
+	for (unsigned int d = 0; d < r->DrawCount; ++d) {
+		const unsigned int i = r->Draws[d].Index;
+		const GLuint       vao = m_skr_gl_depth_vao(s, i);
+		if (!vao)
+			continue;
+
+		if (vao != bound) {
+			glBindVertexArray(vao);
+			bound = vao;
+		}
+		m_skr_gl_depth_model(s, i, s->Depth.Backend.GL.Model);
+		m_skr_gl_draw_item(s, &r->Draws[d], &cull);
+	}
+
+	m_skr_gl_cull_face(0, &cull);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	m_skr_gl_debug_group_pop(s);
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief GL submit `count` draws of SkrState::Renderables.
+ *
+ * Program, textures and VAO are only rebound when they differ from the
+ * previous draw. After a depth pre-pass, the draws it covered test with
+ * GL_EQUAL and leave depth untouched.
+ */
+static inline void m_skr_gl_renderables_render(SkrState*          s,
+                                               const SkrDrawItem* draws,
+                                               const unsigned int count,
+                                               const bool prepassed) {
+	const SkrRenderables* r = &s->Renderables;
+	const SkrSkinning*    k = &s->Skinning;
+	const SkrMaterial*    material = NULL;
+	const SkrMesh*        mesh = NULL;
+	const GLenum          func = s->View.ReverseZ ? GL_GREATER : GL_LESS;
+	bool                  equal = false;
+	GLenum                cull = 0;
+
+	for (unsigned int i = 0; i < count; ++i) {
+		const SkrDrawItem* draw = &draws[i];
+
+		const bool covered =
+		        prepassed && m_skr_gl_depth_vao(s, draw->Index) != 0;
+		if (covered != equal) {
+			glDepthFunc(covered ? GL_EQUAL : func);
+			glDepthMask(covered ? GL_FALSE : GL_TRUE);
+			equal = covered;
+		}
+
+		if (draw->Material != material) {
+			material = draw->Material;
+			glUseProgram(material->Program->Backend.GL.ID);
+			for (unsigned int t = 0; t < material->TextureCount;
+			     ++t) {
+				glActiveTexture(GL_TEXTURE0 + t);
+				glBindTexture(GL_TEXTURE_2D,
+				              material->Textures[t].Backend.GL.ID);
+			}
+		}
+
+		/* Pre-skinned renderables draw from their own stream. */
+		const SkrSkinOutput* skinned =
+		        k->Prepass && r->Skinned[draw->Index] &&
+		                        r->Skin[draw->Index] >= 0
+		                ? &k->Outputs[r->Skinned[draw->Index] - 1]
+		                : NULL;
+
+		if (skinned) {
+			mesh = NULL;
+			glBindVertexArray(skinned->Backend.GL.VAO);
+		} else if (draw->Mesh != mesh) {
+			mesh = draw->Mesh;
+			glBindVertexArray(mesh->VAO);
+		}
+
+		const SkrNode node = r->Node[draw->Index];
+		const GLint   loc = material->Program->Backend.GL.Model;
+		if (node && loc >= 0)
+			glUniformMatrix4fv(
+			        loc, 1, GL_FALSE,
+			        (const float*)s->Scene.World[s->Scene.Slot[node]]);
+
+		if (material->Program->Backend.GL.BoneBase >= 0)
+			glUniform1i(material->Program->Backend.GL.BoneBase,
+			            skinned ? -1 : r->Skin[draw->Index]);
+
+		/* The pre-pass already applied the morph to skinned streams. */
+		const int   morph = r->Morph[draw->Index];
+		const GLint morph_base =
+		        !skinned && morph >= 0
+		                ? (GLint)s->Morphs.Instances[morph].Base
+		                : -1;
+		if (material->Program->Backend.GL.MorphBase >= 0)
+			glUniform1i(material->Program->Backend.GL.MorphBase,
+			            morph_base);
+
+		m_skr_gl_draw_item(s, draw, &cull);
+	}
+
+	m_skr_gl_cull_face(0, &cull);
+	if (equal) {
+		glDepthFunc(func);
+		glDepthMask(GL_TRUE);
+	}
+}
+
+/**
+ * @internal
+ * @brief GL upload SkrState::View to the `SkrFrame` block if it changed.
+ */
+static inline void m_skr_gl_view_upload(SkrView* v) {
+	if (!v->Backend.GL.Buffer || v->Backend.GL.Version == v->Version)
+		return;
+
+	struct {
+		mat4 View;
+		mat4 Projection;
+		mat4 ViewProjection;
+		vec4 CameraPosition;
+	} frame;
+
+	glm_mat4_copy(v->View, frame.View);
+	glm_mat4_copy(v->Projection, frame.Projection);
+	glm_mat4_copy(v->ViewProjection, frame.ViewProjection);
+	glm_vec4(v->Position, 1.0f, frame.CameraPosition);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, v->Backend.GL.Buffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(frame), &frame);
+	v->Backend.GL.Version = v->Version;
+}
+
+/**
+ * @internal
+ * @brief GL upload the bone range written since the last frame and bind
+ * the palette texture.
+ */
+static inline void m_skr_gl_skinning_upload(SkrSkinning* k) {
+	if (k->Count == 0)
+		return;
+
+	if (!k->Backend.GL.Buffer) {
+		glGenBuffers(1, &k->Backend.GL.Buffer);
+		glGenTextures(1, &k->Backend.GL.Texture);
+	}
+
+	glBindBuffer(GL_TEXTURE_BUFFER, k->Backend.GL.Buffer);
+
+	if (k->Backend.GL.Capacity < k->Capacity) {
+		/* Reallocate and send everything. */
+		glBufferData(GL_TEXTURE_BUFFER,
+		             (GLsizeiptr)k->Capacity * 3 * sizeof(vec4), NULL,
+		             GL_DYNAMIC_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, k->Backend.GL.Texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, k->Backend.GL.Buffer);
+		k->Backend.GL.Capacity = k->Capacity;
+		k->DirtyBegin = 0;
+		k->DirtyEnd = k->Count;
+	}
+
+	if (k->DirtyBegin < k->DirtyEnd) {
+		const GLintptr offset =
+		        (GLintptr)k->DirtyBegin * 3 * sizeof(vec4);
+		glBufferSubData(GL_TEXTURE_BUFFER, offset,
+		                (GLsizeiptr)(k->DirtyEnd - k->DirtyBegin) * 3 *
+		                        sizeof(vec4),
+		                k->Bones[k->DirtyBegin * 3]);
+		k->DirtyBegin = k->DirtyEnd = 0;
+	}
+
+	glActiveTexture(GL_TEXTURE0 + SKR_SKINNING_UNIT);
+	glBindTexture(GL_TEXTURE_BUFFER, k->Backend.GL.Texture);
+}
+
+/**
+ * @internal
+ * @brief GL upload the morph deltas changed since the last frame and bind
+ * the delta texture.
+ */
+static inline void m_skr_gl_morphs_upload(SkrMorphs* m) {
+	if (m->Count == 0)
+		return;
+
+	if (!m->Backend.GL.Buffer) {
+		glGenBuffers(1, &m->Backend.GL.Buffer);
+		glGenTextures(1, &m->Backend.GL.Texture);
+	}
+
+	glBindBuffer(GL_TEXTURE_BUFFER, m->Backend.GL.Buffer);
+
+	if (m->Backend.GL.Capacity < m->Capacity) {
+		glBufferData(GL_TEXTURE_BUFFER,
+		             (GLsizeiptr)m->Capacity * 2 * sizeof(vec4), NULL,
+		             GL_DYNAMIC_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, m->Backend.GL.Texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m->Backend.GL.Buffer);
+		m->Backend.GL.Capacity = m->Capacity;
+		m->DirtyBegin = 0;
+		m->DirtyEnd = m->Count;
+	}
+
+	if (m->DirtyBegin < m->DirtyEnd) {
+		glBufferSubData(GL_TEXTURE_BUFFER,
+		                (GLintptr)m->DirtyBegin * 2 * sizeof(vec4),
+		                (GLsizeiptr)(m->DirtyEnd - m->DirtyBegin) * 2 *
+		                        sizeof(vec4),
+		                m->Deltas[m->DirtyBegin * 2]);
+		m->DirtyBegin = m->DirtyEnd = 0;
+	}
+
+	glActiveTexture(GL_TEXTURE0 + SKR_MORPH_UNIT);
+	glBindTexture(GL_TEXTURE_BUFFER, m->Backend.GL.Texture);
+}
+
+/**
+ * @internal
+ * @brief GL (re)allocate buffer `b` of the light buffers as a texture
+ * buffer of `format` holding `size` bytes.
+ */
+static inline void m_skr_gl_lights_buffer(SkrLights* l, const int b,
+                                          const GLenum     format,
+                                          const GLsizeiptr size) {
+	glBindBuffer(GL_TEXTURE_BUFFER, l->Backend.GL.Buffers[b]);
+	glBufferData(GL_TEXTURE_BUFFER, size, NULL, GL_STREAM_DRAW);
+	glBindTexture(GL_TEXTURE_BUFFER, l->Backend.GL.Textures[b]);
+	glTexBuffer(GL_TEXTURE_BUFFER, format, l->Backend.GL.Buffers[b]);
+}
+
+/**
+ * @internal
+ * @brief GL upload the lights and cluster grid binned this frame and bind
+ * their textures and the `SkrClusters` block.
+ *
+ * The block is filled by ::m_skr_gl_lights_target once the size of the
+ * scene target is known.
+ */
+static inline void m_skr_gl_lights_upload(SkrLights* l) {
+	if (!l->Grid)
+		return;
+
+	if (!l->Backend.GL.Block) {
+		glGenBuffers(3, l->Backend.GL.Buffers);
+		glGenTextures(3, l->Backend.GL.Textures);
+		glGenBuffers(1, &l->Backend.GL.Block);
+		glBindBuffer(GL_UNIFORM_BUFFER, l->Backend.GL.Block);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(vec4), NULL,
+		             GL_DYNAMIC_DRAW);
+		m_skr_gl_lights_buffer(l, 1, GL_RG32UI,
+		                       SKR_CLUSTERS * 2 * sizeof(unsigned int));
+	}
+
+	/* Grow to capacity so steady light counts never reallocate. */
+	if (l->Backend.GL.Capacity[0] < l->Capacity || !l->Capacity) {
+		const unsigned int cap = l->Capacity ? l->Capacity : 1;
+		m_skr_gl_lights_buffer(l, 0, GL_RGBA32F,
+		                       cap * sizeof(SkrPointLight));
+		l->Backend.GL.Capacity[0] = cap;
+	}
+	if (l->Backend.GL.Capacity[1] < l->IndexCapacity ||
+	    !l->IndexCapacity) {
+		const unsigned int cap =
+		        l->IndexCapacity ? l->IndexCapacity : 1;
+		m_skr_gl_lights_buffer(l, 2, GL_R32UI,
+		                       cap * sizeof(unsigned int));
+		l->Backend.GL.Capacity[1] = cap;
+	}
+
+	glBindBuffer(GL_TEXTURE_BUFFER, l->Backend.GL.Buffers[0]);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0,
+	                l->Count * sizeof(SkrPointLight), l->Points);
+	glBindBuffer(GL_TEXTURE_BUFFER, l->Backend.GL.Buffers[1]);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0,
+	                SKR_CLUSTERS * 2 * sizeof(unsigned int), l->Grid);
+	glBindBuffer(GL_TEXTURE_BUFFER, l->Backend.GL.Buffers[2]);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0,
+	                l->IndexCount * sizeof(unsigned int), l->Indices);
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, SKR_CLUSTER_BINDING,
+	                 l->Backend.GL.Block);
+
+	static const GLenum units[3] = {SKR_LIGHTS_UNIT, SKR_LIGHT_GRID_UNIT,
+	                                SKR_LIGHT_INDEX_UNIT};
+	for (int b = 0; b < 3; ++b) {
+		glActiveTexture(GL_TEXTURE0 + units[b]);
+		glBindTexture(GL_TEXTURE_BUFFER, l->Backend.GL.Textures[b]);
+	}
+}
+
+/**
+ * @internal
+ * @brief GL fill the `SkrClusters` block for a scene target of `width` by
+ * `height` pixels, the size tiles divide in the shaders.
+ */
+static inline void m_skr_gl_lights_target(const SkrLights* l,
+                                          const int width, const int height) {
+	if (!l->Backend.GL.Block)
+		return;
+
+	const vec4 cluster = {(float)width, (float)height, l->Near, l->Scale};
+	glBindBuffer(GL_UNIFORM_BUFFER, l->Backend.GL.Block);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(vec4), cluster);
+}
+
+/**
+ * @internal
+ * @brief GL cache a program's uniform locations and bind its engine
+ * blocks and samplers to their fixed slots.
+ */
+static inline void m_skr_gl_program_init(SkrShaderProgram* program) {
+	program->Backend.GL.Model =
+	        glGetUniformLocation(program->Backend.GL.ID, "model");
+
+	const GLuint block =
+	        glGetUniformBlockIndex(program->Backend.GL.ID, "SkrFrame");
+	if (block != GL_INVALID_INDEX)
+		glUniformBlockBinding(program->Backend.GL.ID, block,
+		                      SKR_FRAME_BINDING);
+
+	program->Backend.GL.BoneBase =
+	        glGetUniformLocation(program->Backend.GL.ID, "skr_bone_base");
+	program->Backend.GL.MorphBase =
+	        glGetUniformLocation(program->Backend.GL.ID, "skr_morph_base");
+
+	const GLint bones =
+	        glGetUniformLocation(program->Backend.GL.ID, "skr_bones");
+	if (bones >= 0) {
+		glUseProgram(program->Backend.GL.ID);
+		glUniform1i(bones, SKR_SKINNING_UNIT);
+	}
+
+	const GLint morphs =
+	        glGetUniformLocation(program->Backend.GL.ID, "skr_morphs");
+	if (morphs >= 0) {
+		glUseProgram(program->Backend.GL.ID);
+		glUniform1i(morphs, SKR_MORPH_UNIT);
+	}
+
+	const GLuint clusters =
+	        glGetUniformBlockIndex(program->Backend.GL.ID, "SkrClusters");
+	if (clusters != GL_INVALID_INDEX) {
+		glUniformBlockBinding(program->Backend.GL.ID, clusters,
+		                      SKR_CLUSTER_BINDING);
+		glUseProgram(program->Backend.GL.ID);
+		glUniform1i(glGetUniformLocation(program->Backend.GL.ID,
+		                                 "skr_lights"),
+		            SKR_LIGHTS_UNIT);
+		glUniform1i(glGetUniformLocation(program->Backend.GL.ID,
+		                                 "skr_light_grid"),
+		            SKR_LIGHT_GRID_UNIT);
+		glUniform1i(glGetUniformLocation(program->Backend.GL.ID,
+		                                 "skr_light_indices"),
+		            SKR_LIGHT_INDEX_UNIT);
+	}
+
+	const GLuint shadows =
+	        glGetUniformBlockIndex(program->Backend.GL.ID, "SkrShadows");
+	if (shadows != GL_INVALID_INDEX) {
+		glUniformBlockBinding(program->Backend.GL.ID, shadows,
+		                      SKR_SHADOW_BINDING);
+		glUseProgram(program->Backend.GL.ID);
+		glUniform1i(glGetUniformLocation(program->Backend.GL.ID,
+		                                 "skr_shadow_map"),
+		            SKR_SHADOW_UNIT);
+	}
+}
+
+/**
+ * @internal
+ * @brief GL fullscreen triangle, no attributes. `Texcoord` spans [0, 1]
+ * over the viewport.
+ */
+static const char* m_skr_gl_fullscreen_vert =
+        "#version 330 core\n"
+        "out vec2 Texcoord;\n"
+        "void main() {\n"
+        "  vec2 p = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 4.0 - 1.0;\n"
+        "  Texcoord = p * 0.5 + 0.5;\n"
+        "  gl_Position = vec4(p, 0.0, 1.0);\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL G-buffer resolve: rebuilds each position from depth with
+ * `skr_depth` (scale and bias to NDC, clear value) and lights it with the
+ * clusters of SkrState::Lights and the sun of SkrState::Shadows.
+ */
+static const char* m_skr_gl_resolve_frag =
+        "#version 330 core\n" SKR_LIGHTING_GLSL SKR_SHADOW_GLSL
+        "layout(std140) uniform SkrFrame {\n"
+        "  mat4 View;\n"
+        "  mat4 Projection;\n"
+        "  mat4 ViewProjection;\n"
+        "  vec4 CameraPosition;\n"
+        "};\n"
+        "uniform sampler2D skr_gbuffer0;\n"
+        "uniform sampler2D skr_gbuffer1;\n"
+        "uniform sampler2D skr_gbuffer_depth;\n"
+        "uniform mat4 skr_inverse_view_projection;\n"
+        "uniform vec3 skr_depth;\n"
+        "out vec4 FragColor;\n"
+        "vec3 skr_oct_decode(vec2 e) {\n"
+        "  e = e * 2.0 - 1.0;\n"
+        "  vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));\n"
+        "  float t = max(-n.z, 0.0);\n"
+        "  n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);\n"
+        "  return normalize(n);\n"
+        "}\n"
+        "void main() {\n"
+        "  ivec2 p = ivec2(gl_FragCoord.xy);\n"
+        "  float d = texelFetch(skr_gbuffer_depth, p, 0).r;\n"
+        "  if (d == skr_depth.z) discard;\n"
+        "  vec4 g0 = texelFetch(skr_gbuffer0, p, 0);\n"
+        "  vec4 g1 = texelFetch(skr_gbuffer1, p, 0);\n"
+        "  vec2 uv = gl_FragCoord.xy / vec2(textureSize(skr_gbuffer0, 0));\n"
+        "  vec4 ndc = vec4(uv * 2.0 - 1.0, d * skr_depth.x + skr_depth.y, "
+        "1.0);\n"
+        "  vec4 world = skr_inverse_view_projection * ndc;\n"
+        "  vec3 position = world.xyz / world.w;\n"
+        "  float depth = -(View * vec4(position, 1.0)).z;\n"
+        "  vec3 normal = skr_oct_decode(g1.xy);\n"
+        "  vec3 diffuse = g0.rgb * (1.0 - g0.a);\n"
+        "  vec3 light = skr_lighting_at(position, normal, diffuse, "
+        "gl_FragCoord.xy, depth) +\n"
+        "               skr_sun(position, normal, diffuse, depth);\n"
+        "  FragColor = vec4(g0.rgb * 0.03 + light, 1.0);\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL compile the resolve on first use.
+ *
+ * @return 1 when the resolve is ready, 0 on failure.
  */
-static inline char* m_skr_read_file(const char* path) {
-	FILE* file = fopen(path, "rb");
-	if (!file) {
-		m_skr_last_error_set("failed to open");
-		return NULL;
+static inline int m_skr_gl_gbuffer_prepare(SkrGBuffer* g) {
+	if (g->Resolve.Backend.GL.ID)
+		return 1;
+
+	const SkrShader shaders[] = {
+	        {.Type = GL_VERTEX_SHADER, .GLSL = m_skr_gl_fullscreen_vert},
+	        {.Type = GL_FRAGMENT_SHADER, .GLSL = m_skr_gl_resolve_frag},
+	};
+	const GLuint program =
+	        m_skr_gl_create_program_from_shaders(shaders, sizeof(shaders));
+	if (!program)
+		return 0;
+
+	g->Resolve.Backend.GL.ID = program;
+	m_skr_gl_program_init(&g->Resolve);
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "skr_gbuffer0"), 0);
+	glUniform1i(glGetUniformLocation(program, "skr_gbuffer1"), 1);
+	glUniform1i(glGetUniformLocation(program, "skr_gbuffer_depth"), 2);
+	g->Backend.GL.InverseViewProjection =
+	        glGetUniformLocation(program, "skr_inverse_view_projection");
+	g->Backend.GL.Depth = glGetUniformLocation(program, "skr_depth");
+
+	glGenVertexArrays(1, &g->Backend.GL.VAO);
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief GL render graph pass lighting the G-buffer into the bound
+ * target.
+ */
+static inline void m_skr_gl_gbuffer_resolve(SkrState* s, const SkrGraph* gr,
+                                            void* user) {
+	const SkrGBuffer* g = &s->GBuffer;
+	const SkrView*    v = &s->View;
+	(void)user;
+
+	m_skr_gl_debug_group_push(s, "skr: resolve");
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glDisable(GL_DEPTH_TEST);
+
+	glUseProgram(g->Resolve.Backend.GL.ID);
+	glUniformMatrix4fv(g->Backend.GL.InverseViewProjection, 1, GL_FALSE,
+	                   (const float*)v->InverseViewProjection);
+	if (v->ReverseZ)
+		glUniform3f(g->Backend.GL.Depth, 1.0f, 0.0f, 0.0f);
+	else
+		glUniform3f(g->Backend.GL.Depth, 2.0f, -1.0f, 1.0f);
+
+	for (int t = 0; t < 3; ++t) {
+		glActiveTexture(GL_TEXTURE0 + t);
+		glBindTexture(GL_TEXTURE_2D,
+		              gr->Resources[g->Targets[t]].Backend.GL.Texture);
+	}
+
+	glBindVertexArray(g->Backend.GL.VAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glEnable(GL_DEPTH_TEST);
+	m_skr_gl_debug_group_pop(s);
+}
+
+/**
+ * @internal
+ * @brief GL bilinear upscale of the scene into the viewport.
+ */
+static const char* m_skr_gl_upscale_frag =
+        "#version 330 core\n"
+        "in vec2 Texcoord;\n"
+        "uniform sampler2D skr_scene;\n"
+        "out vec4 FragColor;\n"
+        "void main() {\n"
+        "  FragColor = texture(skr_scene, Texcoord);\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL create the timer queries and the upscale on first use.
+ *
+ * @return 1 when dynamic resolution is ready, 0 on failure.
+ */
+static inline int m_skr_gl_resolution_prepare(SkrResolution* r) {
+	if (r->Backend.GL.Program)
+		return 1;
+
+	const SkrShader shaders[] = {
+	        {.Type = GL_VERTEX_SHADER, .GLSL = m_skr_gl_fullscreen_vert},
+	        {.Type = GL_FRAGMENT_SHADER, .GLSL = m_skr_gl_upscale_frag},
+	};
+	const GLuint program =
+	        m_skr_gl_create_program_from_shaders(shaders, sizeof(shaders));
+	if (!program)
+		return 0;
+
+	r->Backend.GL.Program = program;
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "skr_scene"), 0);
+	glGenVertexArrays(1, &r->Backend.GL.VAO);
+	glGenQueries(SKR_RESOLUTION_QUERIES, r->Backend.GL.Queries);
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief GL feed finished timer queries to ::skr_resolution_update and
+ * start timing this frame, unless its query is still in flight.
+ *
+ * @return 1 if a query was started.
+ */
+static inline int m_skr_gl_resolution_begin(SkrResolution* r) {
+	for (unsigned int i = 0; i < SKR_RESOLUTION_QUERIES; ++i) {
+		const GLuint query = r->Backend.GL.Queries[i];
+		GLint        available = 0;
+		if (!r->Backend.GL.Pending[i])
+			continue;
+
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE,
+		                   &available);
+		if (!available)
+			continue;
+
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+		r->Backend.GL.Pending[i] = false;
+		skr_resolution_update(r, (double)elapsed * 1e-9);
+	}
+
+	const unsigned int next = r->Backend.GL.Next;
+	if (r->Backend.GL.Pending[next])
+		return 0;
+
+	glBeginQuery(GL_TIME_ELAPSED, r->Backend.GL.Queries[next]);
+	r->Backend.GL.Pending[next] = true;
+	r->Backend.GL.Next = (next + 1) % SKR_RESOLUTION_QUERIES;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief GL render graph pass upscaling the scene color into the bound
+ * target.
+ */
+static inline void m_skr_gl_upscale_pass(SkrState* s, const SkrGraph* g,
+                                         void* user) {
+	const SkrResolution* r = &s->Resolution;
+	const unsigned int   scene = (unsigned int)(uintptr_t)user;
+
+	m_skr_gl_debug_group_push(s, "skr: upscale");
+	glClear(GL_DEPTH_BUFFER_BIT);
+	glDisable(GL_DEPTH_TEST);
+	glUseProgram(r->Backend.GL.Program);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, g->Resources[scene].Backend.GL.Texture);
+	glBindVertexArray(r->Backend.GL.VAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glEnable(GL_DEPTH_TEST);
+	m_skr_gl_debug_group_pop(s);
+}
+
+/**
+ * @internal
+ * @brief Velocity cleared into the velocity buffer. The TAA resolve
+ * treats anything above half of it as unknown and uses camera motion.
+ */
+#define M_SKR_VELOCITY_NONE 10000.0f
+
+/**
+ * @internal
+ * @brief GL velocity program: positions as ::m_skr_gl_depth_vert for
+ * GL_EQUAL testing, and the screen motion since last frame, unjittered.
+ */
+static const char* m_skr_gl_velocity_vert =
+        "#version 330 core\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "uniform mat4 skr_depth_matrix;\n"
+        "uniform mat4 model;\n"
+        "uniform mat4 skr_unjittered;\n"
+        "uniform mat4 skr_previous;\n"
+        "uniform mat4 skr_previous_model;\n"
+        "invariant gl_Position;\n"
+        "out vec4 Current;\n"
+        "out vec4 Previous;\n"
+        "void main() {\n"
+        "  vec4 world = model * vec4(aPos, 1.0);\n"
+        "  gl_Position = skr_depth_matrix * world;\n"
+        "  Current = skr_unjittered * world;\n"
+        "  Previous = skr_previous * (skr_previous_model * vec4(aPos, "
+        "1.0));\n"
+        "}\n";
+
+static const char* m_skr_gl_velocity_frag =
+        "#version 330 core\n"
+        "in vec4 Current;\n"
+        "in vec4 Previous;\n"
+        "out vec2 Velocity;\n"
+        "void main() {\n"
+        "  Velocity = (Current.xy / Current.w -\n"
+        "              Previous.xy / max(Previous.w, 1e-5)) * 0.5;\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL TAA resolve into the history.
+ *
+ * The new sample is read unjittered at `skr_jitter` (scene pixels). The
+ * velocity of the nearest pixel around it finds last frame's history,
+ * falling back to reprojecting its depth with `skr_reproject` where no
+ * renderable wrote one. The history is clamped to the 3x3 neighborhood
+ * of the sample to reject stale colors, and `skr_feedback` is 0 when
+ * there is no history.
+ */
+static const char* m_skr_gl_temporal_frag =
+        "#version 330 core\n"
+        "in vec2 Texcoord;\n"
+        "uniform sampler2D skr_color;\n"
+        "uniform sampler2D skr_velocity;\n"
+        "uniform sampler2D skr_scene_depth;\n"
+        "uniform sampler2D skr_history;\n"
+        "uniform mat4 skr_reproject;\n"
+        "uniform vec2 skr_jitter;\n"
+        "uniform vec3 skr_depth;\n"
+        "uniform float skr_feedback;\n"
+        "out vec4 FragColor;\n"
+        "void main() {\n"
+        "  vec2 size = vec2(textureSize(skr_color, 0));\n"
+        "  vec2 uv = Texcoord + skr_jitter / size;\n"
+        "  ivec2 last = ivec2(size) - 1;\n"
+        "  ivec2 center = clamp(ivec2(uv * size), ivec2(0), last);\n"
+        "  vec3 lo = vec3(65504.0), hi = vec3(-65504.0);\n"
+        "  float closest = skr_depth.z;\n"
+        "  ivec2 nearest = center;\n"
+        "  for (int y = -1; y <= 1; ++y)\n"
+        "    for (int x = -1; x <= 1; ++x) {\n"
+        "      ivec2 p = clamp(center + ivec2(x, y), ivec2(0), last);\n"
+        "      vec3 c = texelFetch(skr_color, p, 0).rgb;\n"
+        "      lo = min(lo, c);\n"
+        "      hi = max(hi, c);\n"
+        "      float d = texelFetch(skr_scene_depth, p, 0).r;\n"
+        "      if (skr_depth.z == 0.0 ? d > closest : d < closest) {\n"
+        "        closest = d;\n"
+        "        nearest = p;\n"
+        "      }\n"
+        "    }\n"
+        "  vec3 current = texture(skr_color, uv).rgb;\n"
+        "  vec2 velocity = texelFetch(skr_velocity, nearest, 0).xy;\n"
+        "  if (velocity.x > 5000.0) {\n"
+        "    vec2 ndc = Texcoord * 2.0 - 1.0;\n"
+        "    vec4 previous = skr_reproject *\n"
+        "        vec4(ndc, closest * skr_depth.x + skr_depth.y, 1.0);\n"
+        "    velocity = (ndc - previous.xy / previous.w) * 0.5;\n"
+        "  }\n"
+        "  vec2 previous = Texcoord - velocity;\n"
+        "  bool inside = all(greaterThanEqual(previous, vec2(0.0))) &&\n"
+        "                all(lessThanEqual(previous, vec2(1.0)));\n"
+        "  vec3 history = clamp(texture(skr_history, previous).rgb, lo, "
+        "hi);\n"
+        "  FragColor = vec4(mix(current, history, inside ? skr_feedback : "
+        "0.0), 1.0);\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL compile the temporal programs on first use and (re)allocate
+ * the histories at `width` by `height`, which drops the history.
+ *
+ * @return 1 when TAA is ready, 0 on failure.
+ */
+static inline int m_skr_gl_temporal_prepare(SkrState* s, const int width,
+                                            const int height) {
+	SkrTemporal* t = &s->Temporal;
+
+	/* The history is presented with the upscale. */
+	if (!m_skr_gl_resolution_prepare(&s->Resolution))
+		return 0;
+
+	if (!t->Backend.GL.Velocity) {
+		const SkrShader velocity[] = {
+		        {.Type = GL_VERTEX_SHADER,
+		         .GLSL = m_skr_gl_velocity_vert},
+		        {.Type = GL_FRAGMENT_SHADER,
+		         .GLSL = m_skr_gl_velocity_frag},
+		};
+		const SkrShader resolve[] = {
+		        {.Type = GL_VERTEX_SHADER,
+		         .GLSL = m_skr_gl_fullscreen_vert},
+		        {.Type = GL_FRAGMENT_SHADER,
+		         .GLSL = m_skr_gl_temporal_frag},
+		};
+		const GLuint program = m_skr_gl_create_program_from_shaders(
+		        velocity, sizeof(velocity));
+		if (!program)
+			return 0;
+		t->Backend.GL.Resolve = m_skr_gl_create_program_from_shaders(
+		        resolve, sizeof(resolve));
+		if (!t->Backend.GL.Resolve) {
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		t->Backend.GL.Velocity = program;
+		t->Backend.GL.Matrix =
+		        glGetUniformLocation(program, "skr_depth_matrix");
+		t->Backend.GL.Model = glGetUniformLocation(program, "model");
+		t->Backend.GL.Unjittered =
+		        glGetUniformLocation(program, "skr_unjittered");
+		t->Backend.GL.Previous =
+		        glGetUniformLocation(program, "skr_previous");
+		t->Backend.GL.PreviousModel =
+		        glGetUniformLocation(program, "skr_previous_model");
+
+		const GLuint r = t->Backend.GL.Resolve;
+		glUseProgram(r);
+		glUniform1i(glGetUniformLocation(r, "skr_color"), 0);
+		glUniform1i(glGetUniformLocation(r, "skr_velocity"), 1);
+		glUniform1i(glGetUniformLocation(r, "skr_scene_depth"), 2);
+		glUniform1i(glGetUniformLocation(r, "skr_history"), 3);
+		t->Backend.GL.Reproject =
+		        glGetUniformLocation(r, "skr_reproject");
+		t->Backend.GL.Offset = glGetUniformLocation(r, "skr_jitter");
+		t->Backend.GL.DepthScale = glGetUniformLocation(r, "skr_depth");
+		t->Backend.GL.Weight = glGetUniformLocation(r, "skr_feedback");
+	}
+
+	if (t->Backend.GL.Width == width && t->Backend.GL.Height == height)
+		return 1;
+
+	if (t->Backend.GL.History[0]) {
+		glDeleteFramebuffers(2, t->Backend.GL.FBO);
+		glDeleteTextures(2, t->Backend.GL.History);
+	}
+	glGenTextures(2, t->Backend.GL.History);
+	glGenFramebuffers(2, t->Backend.GL.FBO);
+	for (int i = 0; i < 2; ++i) {
+		glBindTexture(GL_TEXTURE_2D, t->Backend.GL.History[i]);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0,
+		             GL_RGBA, GL_HALF_FLOAT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+		                GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+		                GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
+		                GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
+		                GL_CLAMP_TO_EDGE);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, t->Backend.GL.FBO[i]);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+		                       GL_TEXTURE_2D, t->Backend.GL.History[i],
+		                       0);
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	t->Backend.GL.Width = width;
+	t->Backend.GL.Height = height;
+	t->Valid = false;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief GL render graph pass writing the velocity of every renderable
+ * the velocity program can reproduce, over the scene depth.
+ */
+static inline void m_skr_gl_velocity_pass(SkrState* s, const SkrGraph* g,
+                                          void* user) {
+	static const mat4     identity = GLM_MAT4_IDENTITY_INIT;
+	static const GLfloat  none[4] = {M_SKR_VELOCITY_NONE,
+	                                 M_SKR_VELOCITY_NONE, 0.0f, 0.0f};
+	const SkrRenderables* r = &s->Renderables;
+	const SkrTemporal*    t = &s->Temporal;
+	const SkrView*        v = &s->View;
+	(void)g;
+	(void)user;
+
+	m_skr_gl_debug_group_push(s, "skr: velocity");
+	glClearBufferfv(GL_COLOR, 0, none);
+	glDepthFunc(GL_EQUAL);
+	glDepthMask(GL_FALSE);
+
+	glUseProgram(t->Backend.GL.Velocity);
+	glUniformMatrix4fv(t->Backend.GL.Matrix, 1, GL_FALSE,
+	                   (const float*)v->ViewProjection);
+	glUniformMatrix4fv(t->Backend.GL.Unjittered, 1, GL_FALSE,
+	                   (const float*)v->Unjittered);
+	glUniformMatrix4fv(t->Backend.GL.Previous, 1, GL_FALSE,
+	                   t->Valid ? (const float*)t->PreviousViewProjection
+	                            : (const float*)v->Unjittered);
+
+	GLuint bound = 0;
+	GLenum cull = 0;
+	for (unsigned int d = 0; d < r->DrawCount; ++d) {
+		const unsigned int i = r->Draws[d].Index;
+		const GLuint       vao = m_skr_gl_depth_vao(s, i);
+		if (!vao)
+			continue;
+
+		if (vao != bound) {
+			glBindVertexArray(vao);
+			bound = vao;
+		}
+
+		/* Rows added since last frame have no previous transform. */
+		const SkrNode node = r->Node[i];
+		const float*  model =
+		        node ? (const float*)s->Scene.World[s->Scene.Slot[node]]
+		             : (const float*)identity;
+		glUniformMatrix4fv(t->Backend.GL.Model, 1, GL_FALSE, model);
+		glUniformMatrix4fv(t->Backend.GL.PreviousModel, 1, GL_FALSE,
+		                   t->Valid && r->Previous[i][3][3] != 0.0f
+		                           ? (const float*)r->Previous[i]
+		                           : model);
+		m_skr_gl_draw_item(s, &r->Draws[d], &cull);
+	}
+
+	m_skr_gl_cull_face(0, &cull);
+	glDepthFunc(v->ReverseZ ? GL_GREATER : GL_LESS);
+	glDepthMask(GL_TRUE);
+	m_skr_gl_debug_group_pop(s);
+}
+
+/**
+ * @internal
+ * @brief GL render graph pass resolving the scene into the history.
+ */
+static inline void m_skr_gl_temporal_pass(SkrState* s, const SkrGraph* g,
+                                          void* user) {
+	const SkrTemporal* t = &s->Temporal;
+	const SkrView*     v = &s->View;
+	mat4               reproject;
+	(void)user;
+
+	/* Current unjittered NDC to last frame's clip space. */
+	glm_mat4_inv((vec4*)v->Unjittered, reproject);
+	glm_mat4_mul(t->Valid ? (vec4*)t->PreviousViewProjection
+	                      : (vec4*)v->Unjittered,
+	             reproject, reproject);
+
+	m_skr_gl_debug_group_push(s, "skr: temporal");
+	glDisable(GL_DEPTH_TEST);
+	glUseProgram(t->Backend.GL.Resolve);
+	glUniformMatrix4fv(t->Backend.GL.Reproject, 1, GL_FALSE,
+	                   (const float*)reproject);
+	glUniform2f(t->Backend.GL.Offset, t->Jitter[0], t->Jitter[1]);
+	if (v->ReverseZ)
+		glUniform3f(t->Backend.GL.DepthScale, 1.0f, 0.0f, 0.0f);
+	else
+		glUniform3f(t->Backend.GL.DepthScale, 2.0f, -1.0f, 1.0f);
+	glUniform1f(t->Backend.GL.Weight,
+	            !t->Valid             ? 0.0f
+	            : t->Feedback > 0.0f ? t->Feedback
+	                                 : 0.9f);
+
+	for (int i = 0; i < 4; ++i) {
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D,
+		              g->Resources[t->Targets[i]].Backend.GL.Texture);
+	}
+
+	glBindVertexArray(s->Resolution.Backend.GL.VAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glEnable(GL_DEPTH_TEST);
+	m_skr_gl_debug_group_pop(s);
+}
+
+/**
+ * @internal
+ * @brief GL bloom downsample of the level above, a box of four bilinear
+ * taps around a center one. The first level keeps what is brighter than
+ * `skr_threshold`.
+ */
+static const char* m_skr_gl_bloom_down_frag =
+        "#version 330 core\n"
+        "in vec2 Texcoord;\n"
+        "uniform sampler2D skr_source;\n"
+        "uniform float skr_threshold;\n"
+        "out vec4 FragColor;\n"
+        "void main() {\n"
+        "  vec2 t = 1.0 / vec2(textureSize(skr_source, 0));\n"
+        "  vec3 c = texture(skr_source, Texcoord).rgb * 0.5;\n"
+        "  c += texture(skr_source, Texcoord + vec2(-t.x, -t.y)).rgb * "
+        "0.125;\n"
+        "  c += texture(skr_source, Texcoord + vec2(t.x, -t.y)).rgb * "
+        "0.125;\n"
+        "  c += texture(skr_source, Texcoord + vec2(-t.x, t.y)).rgb * "
+        "0.125;\n"
+        "  c += texture(skr_source, Texcoord + t).rgb * 0.125;\n"
+        "  float b = max(c.r, max(c.g, c.b));\n"
+        "  c *= max(b - skr_threshold, 0.0) / max(b, 1e-4);\n"
+        "  FragColor = vec4(c, 1.0);\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL bloom 3x3 tent upsample of the level below, added to the
+ * bound one by blending.
+ */
+static const char* m_skr_gl_bloom_up_frag =
+        "#version 330 core\n"
+        "in vec2 Texcoord;\n"
+        "uniform sampler2D skr_source;\n"
+        "out vec4 FragColor;\n"
+        "vec3 skr_tap(float x, float y) {\n"
+        "  vec2 t = 1.0 / vec2(textureSize(skr_source, 0));\n"
+        "  return texture(skr_source, Texcoord + vec2(x, y) * t).rgb;\n"
+        "}\n"
+        "void main() {\n"
+        "  vec3 c = skr_tap(0.0, 0.0) * 4.0;\n"
+        "  c += (skr_tap(-1.0, 0.0) + skr_tap(1.0, 0.0) +\n"
+        "        skr_tap(0.0, -1.0) + skr_tap(0.0, 1.0)) * 2.0;\n"
+        "  c += skr_tap(-1.0, -1.0) + skr_tap(1.0, -1.0) +\n"
+        "       skr_tap(-1.0, 1.0) + skr_tap(1.0, 1.0);\n"
+        "  FragColor = vec4(c / 16.0, 1.0);\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL post-processing, compiled once per combination of the
+ * `SKR_*` macros defined before it (see ::m_skr_gl_post_defines).
+ *
+ * `skr_post` holds the exposure, bloom intensity, vignette and LUT size.
+ * With `SKR_FXAA`, `skr_scene` is the output of a pass with `SKR_LUMA`,
+ * which stores the luma FXAA compares in alpha.
+ */
+static const char* m_skr_gl_post_frag =
+        "in vec2 Texcoord;\n"
+        "uniform sampler2D skr_scene;\n"
+        "uniform sampler2D skr_bloom;\n"
+        "uniform sampler2D skr_lut;\n"
+        "uniform vec4 skr_post;\n"
+        "out vec4 FragColor;\n"
+        "const vec3 skr_luma = vec3(0.299, 0.587, 0.114);\n"
+        "vec3 skr_tonemap(vec3 x) {\n"
+        "  return clamp(x * (2.51 * x + 0.03) /\n"
+        "               (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);\n"
+        "}\n"
+        "vec3 skr_grade(vec3 c) {\n"
+        "  float n = skr_post.w;\n"
+        "  c = clamp(c, 0.0, 1.0) * (n - 1.0);\n"
+        "  float slice = min(floor(c.b), n - 2.0);\n"
+        "  vec2 uv = vec2((c.r + 0.5 + slice * n) / (n * n), (c.g + 0.5) / "
+        "n);\n"
+        "  vec3 a = texture(skr_lut, uv).rgb;\n"
+        "  vec3 b = texture(skr_lut, uv + vec2(1.0 / n, 0.0)).rgb;\n"
+        "  return mix(a, b, c.b - slice);\n"
+        "}\n"
+        "vec3 skr_fxaa() {\n"
+        "  vec2 t = 1.0 / vec2(textureSize(skr_scene, 0));\n"
+        "  vec4 m = texture(skr_scene, Texcoord);\n"
+        "  float nw = texture(skr_scene, Texcoord + vec2(-t.x, t.y)).a;\n"
+        "  float ne = texture(skr_scene, Texcoord + t).a;\n"
+        "  float sw = texture(skr_scene, Texcoord - t).a;\n"
+        "  float se = texture(skr_scene, Texcoord + vec2(t.x, -t.y)).a;\n"
+        "  float lo = min(m.a, min(min(nw, ne), min(sw, se)));\n"
+        "  float hi = max(m.a, max(max(nw, ne), max(sw, se)));\n"
+        "  if (hi - lo < max(0.0312, hi * 0.125)) return m.rgb;\n"
+        "  vec2 dir = vec2(sw + se - nw - ne, ne + se - nw - sw);\n"
+        "  float reduce = max((nw + ne + sw + se) * 0.03125, 1.0 / 128.0);\n"
+        "  dir = clamp(dir / (min(abs(dir.x), abs(dir.y)) + reduce),\n"
+        "              -8.0, 8.0) * t;\n"
+        "  vec3 a = 0.5 * (texture(skr_scene, Texcoord - dir / 6.0).rgb +\n"
+        "                  texture(skr_scene, Texcoord + dir / 6.0).rgb);\n"
+        "  vec3 b = 0.5 * a +\n"
+        "           0.25 * (texture(skr_scene, Texcoord - dir * 0.5).rgb +\n"
+        "                   texture(skr_scene, Texcoord + dir * 0.5).rgb);\n"
+        "  float l = dot(b, skr_luma);\n"
+        "  return l < lo || l > hi ? a : b;\n"
+        "}\n"
+        "void main() {\n"
+        "#ifdef SKR_FXAA\n"
+        "  vec3 color = skr_fxaa();\n"
+        "#else\n"
+        "  vec3 color = texture(skr_scene, Texcoord).rgb;\n"
+        "#ifdef SKR_BLOOM\n"
+        "  color += texture(skr_bloom, Texcoord).rgb * skr_post.y;\n"
+        "#endif\n"
+        "  color *= skr_post.x;\n"
+        "#ifdef SKR_TONEMAP\n"
+        "  color = skr_tonemap(color);\n"
+        "#endif\n"
+        "#ifdef SKR_GRADE\n"
+        "  color = skr_grade(color);\n"
+        "#endif\n"
+        "#endif\n"
+        "#ifdef SKR_VIGNETTE\n"
+        "  vec2 d = Texcoord - 0.5;\n"
+        "  color *= 1.0 - skr_post.z * 2.0 * dot(d, d);\n"
+        "#endif\n"
+        "#ifdef SKR_LUMA\n"
+        "  FragColor = vec4(color, dot(clamp(color, 0.0, 1.0), skr_luma));\n"
+        "#else\n"
+        "  FragColor = vec4(color, 1.0);\n"
+        "#endif\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief Macro of each bit of a post program key.
+ */
+static const char* const m_skr_gl_post_defines[] = {
+        "SKR_BLOOM", "SKR_TONEMAP", "SKR_GRADE",
+        "SKR_VIGNETTE", "SKR_FXAA", "SKR_LUMA",
+};
+
+/**
+ * @internal
+ * @brief Split `flags` into the keys of the fused post passes, in order.
+ *
+ * @return Number of passes, 1 or 2.
+ */
+static inline unsigned int m_skr_post_keys(const unsigned int flags,
+                                           unsigned int       keys[2]) {
+	if (!(flags & SKR_POST_FXAA)) {
+		keys[0] = flags;
+		return 1;
+	}
+
+	keys[0] = (flags & (SKR_POST_BLOOM | SKR_POST_TONEMAP |
+	                    SKR_POST_GRADE)) |
+	          M_SKR_POST_LUMA;
+	keys[1] = flags & (SKR_POST_FXAA | SKR_POST_VIGNETTE);
+	return 2;
+}
+
+/**
+ * @internal
+ * @brief GL compile the post program of `key` on first use.
+ *
+ * @return 1 when it is available, 0 on failure.
+ */
+static inline int m_skr_gl_post_variant(SkrPost* p, const unsigned int key) {
+	if (p->Backend.GL.Programs[key])
+		return 1;
+
+	char   header[256] = "#version 330 core\n";
+	size_t length = strlen(header);
+	for (unsigned int bit = 0; bit < 6; ++bit)
+		if (key & (1u << bit))
+			length += (size_t)snprintf(
+			        header + length, sizeof(header) - length,
+			        "#define %s\n", m_skr_gl_post_defines[bit]);
+
+	char* source = (char*)malloc(length + strlen(m_skr_gl_post_frag) + 1);
+	if (!source) {
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to build post program");
+		return 0;
+	}
+	memcpy(source, header, length);
+	strcpy(source + length, m_skr_gl_post_frag);
+
+	const SkrShader shaders[] = {
+	        {.Type = GL_VERTEX_SHADER, .GLSL = m_skr_gl_fullscreen_vert},
+	        {.Type = GL_FRAGMENT_SHADER, .GLSL = source},
+	};
+	const GLuint program =
+	        m_skr_gl_create_program_from_shaders(shaders, sizeof(shaders));
+	free(source);
+	if (!program)
+		return 0;
+
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "skr_scene"), 0);
+	glUniform1i(glGetUniformLocation(program, "skr_bloom"), 1);
+	glUniform1i(glGetUniformLocation(program, "skr_lut"), 2);
+	p->Backend.GL.Programs[key] = program;
+	p->Backend.GL.Params[key] = glGetUniformLocation(program, "skr_post");
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief GL compile the bloom programs and the post programs `flags`
+ * needs on first use.
+ *
+ * @return 1 when post-processing is ready, 0 on failure.
+ */
+static inline int m_skr_gl_post_prepare(SkrPost*           p,
+                                        const unsigned int flags) {
+	if (!p->Backend.GL.VAO) {
+		const SkrShader down[] = {
+		        {.Type = GL_VERTEX_SHADER,
+		         .GLSL = m_skr_gl_fullscreen_vert},
+		        {.Type = GL_FRAGMENT_SHADER,
+		         .GLSL = m_skr_gl_bloom_down_frag},
+		};
+		const SkrShader up[] = {
+		        {.Type = GL_VERTEX_SHADER,
+		         .GLSL = m_skr_gl_fullscreen_vert},
+		        {.Type = GL_FRAGMENT_SHADER,
+		         .GLSL = m_skr_gl_bloom_up_frag},
+		};
+		const GLuint program = m_skr_gl_create_program_from_shaders(
+		        down, sizeof(down));
+		if (!program)
+			return 0;
+		p->Backend.GL.Upsample =
+		        m_skr_gl_create_program_from_shaders(up, sizeof(up));
+		if (!p->Backend.GL.Upsample) {
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		p->Backend.GL.Downsample = program;
+		p->Backend.GL.Threshold =
+		        glGetUniformLocation(program, "skr_threshold");
+		glGenVertexArrays(1, &p->Backend.GL.VAO);
+	}
+
+	unsigned int       keys[2];
+	const unsigned int passes = m_skr_post_keys(flags, keys);
+	for (unsigned int i = 0; i < passes; ++i)
+		if (!m_skr_gl_post_variant(p, keys[i]))
+			return 0;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief GL render graph pass halving the resource in `user` into the
+ * bound bloom level.
+ */
+static inline void m_skr_gl_bloom_down_pass(SkrState* s, const SkrGraph* g,
+                                            void* user) {
+	const SkrPost*     p = &s->Post;
+	const unsigned int source = (unsigned int)(uintptr_t)user;
+
+	m_skr_gl_debug_group_push(s, "skr: bloom down");
+	glDisable(GL_DEPTH_TEST);
+	glUseProgram(p->Backend.GL.Downsample);
+	glUniform1f(p->Backend.GL.Threshold,
+	            (int)source != p->Source ? 0.0f
+	            : p->Threshold > 0.0f    ? p->Threshold
+	                                     : 1.0f);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, g->Resources[source].Backend.GL.Texture);
+	glBindVertexArray(p->Backend.GL.VAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glEnable(GL_DEPTH_TEST);
+	m_skr_gl_debug_group_pop(s);
+}
+
+/**
+ * @internal
+ * @brief GL render graph pass adding the bloom level in `user` to the
+ * bound one.
+ */
+static inline void m_skr_gl_bloom_up_pass(SkrState* s, const SkrGraph* g,
+                                          void* user) {
+	const SkrPost*     p = &s->Post;
+	const unsigned int source = (unsigned int)(uintptr_t)user;
+
+	m_skr_gl_debug_group_push(s, "skr: bloom up");
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+	glUseProgram(p->Backend.GL.Upsample);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, g->Resources[source].Backend.GL.Texture);
+	glBindVertexArray(p->Backend.GL.VAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+	m_skr_gl_debug_group_pop(s);
+}
+
+/**
+ * @internal
+ * @brief GL render graph pass running the post program of the key in
+ * `user` into the bound target.
+ */
+static inline void m_skr_gl_post_pass(SkrState* s, const SkrGraph* g,
+                                      void* user) {
+	const SkrPost*     p = &s->Post;
+	const unsigned int key = (unsigned int)(uintptr_t)user;
+	const int          input = key & SKR_POST_FXAA ? p->Color : p->Source;
+
+	m_skr_gl_debug_group_push(s, "skr: post");
+	glClear(GL_DEPTH_BUFFER_BIT);
+	glDisable(GL_DEPTH_TEST);
+	glUseProgram(p->Backend.GL.Programs[key]);
+	glUniform4f(p->Backend.GL.Params[key],
+	            p->Exposure > 0.0f ? p->Exposure : 1.0f,
+	            p->Intensity > 0.0f ? p->Intensity : 0.05f,
+	            p->Vignette > 0.0f ? p->Vignette : 0.3f,
+	            (float)(p->LutSize ? p->LutSize : 16));
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, g->Resources[input].Backend.GL.Texture);
+	if (key & SKR_POST_BLOOM) {
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D,
+		              g->Resources[p->Bloom].Backend.GL.Texture);
+	}
+	if (key & SKR_POST_GRADE) {
+		glActiveTexture(GL_TEXTURE2);
+		glBindTexture(GL_TEXTURE_2D, p->Lut.Backend.GL.ID);
+	}
+
+	glBindVertexArray(p->Backend.GL.VAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glEnable(GL_DEPTH_TEST);
+	m_skr_gl_debug_group_pop(s);
+}
+
+/**
+ * @internal
+ * @brief GL create the `SkrShadows` block, and (re)allocate the shadow
+ * map for the current size and cascade count.
+ *
+ * @return 1 when the shadow map changed, 0 otherwise.
+ */
+static inline int m_skr_gl_shadows_prepare(SkrShadows* sh) {
+	if (!sh->Backend.GL.Block) {
+		glGenBuffers(1, &sh->Backend.GL.Block);
+		glBindBuffer(GL_UNIFORM_BUFFER, sh->Backend.GL.Block);
+		glBufferData(GL_UNIFORM_BUFFER,
+		             SKR_CASCADES * sizeof(mat4) + 4 * sizeof(vec4),
+		             NULL, GL_DYNAMIC_DRAW);
 	}
 
-	fseek(file, 0, SEEK_END);
-	long len = ftell(file);
-	rewind(file);
+	const unsigned int size = sh->Size ? sh->Size : 2048;
+	if (!sh->Count ||
+	    (sh->Backend.GL.Size == size && sh->Backend.GL.Layers == sh->Count))
+		return 0;
 
-	char* buffer = (char*)malloc((unsigned long)len + 1);
-	if (!buffer) {
-		fclose(file);
-		m_skr_last_error_set("failed to open");
-		return NULL;
+	if (!sh->Backend.GL.Texture) {
+		glGenTextures(1, &sh->Backend.GL.Texture);
+		glGenFramebuffers(1, &sh->Backend.GL.FBO);
 	}
 
-	fread(buffer, 1, (unsigned long)len, file);
-	buffer[len] = '\0';
-	fclose(file);
-
-	m_skr_last_error_clear();
-	return buffer;
+	glBindTexture(GL_TEXTURE_2D_ARRAY, sh->Backend.GL.Texture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F,
+	             (GLsizei)size, (GLsizei)size, (GLsizei)sh->Count, 0,
+	             GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S,
+	                GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T,
+	                GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE,
+	                GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC,
+	                GL_LEQUAL);
+
+	sh->Backend.GL.Size = size;
+	sh->Backend.GL.Layers = sh->Count;
+	return 1;
 }
 
 /**
  * @internal
- * @brief GL framebuffer resize callback
+ * @brief GL VAO the plain depth-only program draws caster `i` from, or 0
+ * if it must be deformed first.
  *
- * Adjusts the OpenGL viewport when the window is resized.
- *
- * @param width  New framebuffer width.
- * @param height New framebuffer height.
+ * Pre-pass outputs only count when skinned this frame: casters outside
+ * the view keep the pose of the last frame they were seen in.
  */
-static inline void m_skr_gl_framebuffer_size_callback(const int width,
-                                                      const int height) {
-	glViewport(0, 0, width, height);
-	m_skr_last_error_clear();
+static inline GLuint m_skr_gl_shadow_vao(const SkrState*    s,
+                                         const unsigned int i) {
+	const SkrRenderables* r = &s->Renderables;
+	const SkrSkinning*    k = &s->Skinning;
+
+	if (k->Prepass && r->Skinned[i] && r->Skin[i] >= 0) {
+		const SkrSkinOutput* o = &k->Outputs[r->Skinned[i] - 1];
+		return o->Frame == s->Stats.Frame ? o->Backend.GL.VAO : 0;
+	}
+	if (r->Skin[i] >= 0 || r->Morph[i] >= 0)
+		return 0;
+	return r->Mesh[i]->PositionVAO;
 }
 
 /**
  * @internal
- * @brief GLFW framebuffer resize callback wrapper.
- *
- * @param window GLFW window handle.
- * @param width  New framebuffer width.
- * @param height New framebuffer height.
+ * @brief GL switch between the plain and deforming depth-only programs,
+ * both drawing with `matrix`.
  */
-static inline void m_skr_gl_glfw_framebuffer_size_callback(GLFWwindow* window,
-                                                           const int   width,
-                                                           const int   height) {
-	(void)window;
-	m_skr_gl_framebuffer_size_callback(width, height);
-	m_skr_last_error_clear();
+static inline void m_skr_gl_depth_program(const SkrDepthPass* d,
+                                          const bool deform, mat4 matrix) {
+	glUseProgram(deform ? d->Backend.GL.Deform : d->Backend.GL.Program);
+	glUniformMatrix4fv(deform ? d->Backend.GL.DeformMatrix
+	                          : d->Backend.GL.Matrix,
+	                   1, GL_FALSE, (const float*)matrix);
 }
 
 /**
  * @internal
- * @brief Initialize a GLFW window for OpenGL rendering.
+ * @brief GL set the deforming depth-only program's uniforms for caster
+ * `i`.
+ */
+static inline void m_skr_gl_depth_deform(const SkrState*    s,
+                                         const unsigned int i) {
+	const SkrDepthPass* d = &s->Depth;
+	const int           morph = s->Renderables.Morph[i];
+
+	glUniform1i(d->Backend.GL.DeformBone, s->Renderables.Skin[i]);
+	glUniform1i(d->Backend.GL.DeformMorph,
+	            morph >= 0 ? (GLint)s->Morphs.Instances[morph].Base : -1);
+	m_skr_gl_depth_model(s, i, d->Backend.GL.DeformModel);
+}
+
+/**
+ * @internal
+ * @brief GL render the dirty shadow cascades and upload the `SkrShadows`
+ * block.
  *
- * @param w Pointer to SkrWindow to initialize (must not be NULL).
- * @return 1 on success, 0 on failure.
+ * Casters draw with the depth-only program, from the same streams as the
+ * depth pre-pass, with depth clamping so casters in front of a cascade
+ * still land in it. Skinned or morphed casters the pre-pass did not
+ * deform this frame, such as those outside the view, deform in the
+ * vertex shader instead.
  */
-static inline int m_skr_gl_glfw_init(SkrWindow* w) {
-	if (!glfwInit() || !w) {
-		m_skr_last_error_set(
-		        "either glfwInit != 1 or SkrWindow == NULL");
-		return 0;
+static inline void m_skr_gl_shadows_render(SkrState* s) {
+	SkrShadows*           sh = &s->Shadows;
+	const SkrRenderables* r = &s->Renderables;
+
+	/* A new shadow map holds nothing, cached cascades included. */
+	if (m_skr_gl_shadows_prepare(sh)) {
+		skr_shadows_invalidate(sh);
+		if (!skr_shadows_update(sh, &s->View, r))
+			sh->Count = 0;
 	}
 
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#ifdef __APPLE__
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
+	const unsigned int count =
+	        sh->Count && m_skr_gl_depth_init(&s->Depth) ? sh->Count : 0;
+	GLint target = 0, viewport[4];
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	/* Clip control maps depth to [0, 1]: remap the [-1, 1] matrices. */
+	const mat4 zo = {{1.0f, 0.0f, 0.0f, 0.0f},
+	                 {0.0f, 1.0f, 0.0f, 0.0f},
+	                 {0.0f, 0.0f, 0.5f, 0.0f},
+	                 {0.0f, 0.0f, 0.5f, 1.0f}};
+	bool       bound = false;
+	const bool deformer = s->Depth.Backend.GL.Deform != 0;
+	const GLint model = s->Depth.Backend.GL.Model;
+
+	for (unsigned int c = 0; c < count; ++c) {
+		const SkrCascade* cascade = &sh->Cascades[c];
+		if (!cascade->Dirty)
+			continue;
 
-	w->Backend.Handler.GLFW = NULL;
+		if (!bound) {
+			m_skr_gl_debug_group_push(s, "skr: shadows");
+			glBindFramebuffer(GL_FRAMEBUFFER, sh->Backend.GL.FBO);
+			glDrawBuffer(GL_NONE);
+			glReadBuffer(GL_NONE);
+			glViewport(0, 0, (GLsizei)sh->Backend.GL.Size,
+			           (GLsizei)sh->Backend.GL.Size);
+			glEnable(GL_DEPTH_CLAMP);
+			glEnable(GL_POLYGON_OFFSET_FILL);
+			glPolygonOffset(2.0f, 2.0f);
+			glDepthFunc(GL_LESS);
+			glClearDepth(1.0);
+			glUseProgram(s->Depth.Backend.GL.Program);
+			bound = true;
+		}
 
-	w->Backend.Handler.GLFW =
-	        glfwCreateWindow(w->Width, w->Height, w->Title, NULL, NULL);
+		mat4 m;
+		if (s->View.ReverseZ)
+			glm_mat4_mul((vec4*)zo, (vec4*)cascade->Matrix, m);
+		else
+			glm_mat4_copy((vec4*)cascade->Matrix, m);
+
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+		                          sh->Backend.GL.Texture, 0, (GLint)c);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		glUniformMatrix4fv(s->Depth.Backend.GL.Matrix, 1, GL_FALSE,
+		                   (const float*)m);
+
+		bool deforming = false;
+		for (unsigned int j = 0; j < cascade->CasterCount; ++j) {
+			const unsigned int i = cascade->Casters[j];
+			GLuint             vao = m_skr_gl_shadow_vao(s, i);
+			const bool         deform = !vao && deformer;
+			if (deform)
+				vao = r->Mesh[i]->VAO;
+			if (!vao)
+				vao = r->Mesh[i]->PositionVAO;
+			if (!vao)
+				continue;
 
-	if (!w->Backend.Handler.GLFW) {
-		m_skr_last_error_set("window backend is NULL");
-		glfwTerminate();
-		return 0;
+			if (deform != deforming) {
+				m_skr_gl_depth_program(&s->Depth, deform, m);
+				deforming = deform;
+			}
+
+			glBindVertexArray(vao);
+			if (deform)
+				m_skr_gl_depth_deform(s, i);
+			else
+				m_skr_gl_depth_model(s, i, model);
+			m_skr_gl_draw_mesh(s, r->Mesh[i]);
+		}
+
+		/* The next cascade starts on the plain program. */
+		if (deforming)
+			m_skr_gl_depth_program(&s->Depth, false, m);
 	}
 
-	glfwSetFramebufferSizeCallback(w->Backend.Handler.GLFW,
-	                               m_skr_gl_glfw_framebuffer_size_callback);
+	if (bound) {
+		glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)target);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		glDisable(GL_DEPTH_CLAMP);
+		glDisable(GL_POLYGON_OFFSET_FILL);
+		glDepthFunc(s->View.ReverseZ ? GL_GREATER : GL_LESS);
+		glClearDepth(s->View.ReverseZ ? 0.0 : 1.0);
+		m_skr_gl_debug_group_pop(s);
+	}
 
-	glfwMakeContextCurrent(w->Backend.Handler.GLFW);
+	if (!sh->Backend.GL.Block)
+		return;
 
-	m_skr_last_error_clear();
-	return 1;
+	/* Shaders sample with [0, 1] coordinates and depth. */
+	const mat4 bias = {{0.5f, 0.0f, 0.0f, 0.0f},
+	                   {0.0f, 0.5f, 0.0f, 0.0f},
+	                   {0.0f, 0.0f, 0.5f, 0.0f},
+	                   {0.5f, 0.5f, 0.5f, 1.0f}};
+	struct {
+		mat4 Matrices[SKR_CASCADES];
+		vec4 Splits;
+		vec4 Texels;
+		vec4 Direction;
+		vec4 Color;
+	} block = {0};
+
+	for (unsigned int c = 0; c < count; ++c) {
+		glm_mat4_mul((vec4*)bias, sh->Cascades[c].Matrix,
+		             block.Matrices[c]);
+		block.Splits[c] = sh->Cascades[c].Far;
+		block.Texels[c] = sh->Cascades[c].Texel;
+	}
+	if (count)
+		glm_vec3_scale(sh->Direction,
+		               1.0f / glm_vec3_norm(sh->Direction),
+		               block.Direction);
+	block.Direction[3] = (float)count;
+	glm_vec3_copy(sh->Color, block.Color);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, sh->Backend.GL.Block);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+	glBindBufferBase(GL_UNIFORM_BUFFER, SKR_SHADOW_BINDING,
+	                 sh->Backend.GL.Block);
+	glActiveTexture(GL_TEXTURE0 + SKR_SHADOW_UNIT);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, sh->Backend.GL.Texture);
 }
 
 /**
  * @internal
- * @brief GL check shader or program compile/link status.
+ * @brief GL compute shader of the skinning pre-pass.
  *
- * @param shader OpenGL shader or program ID.
- * @param type   String ("vert","frag","prog", etc.).
+ * Reads SkrVertex records as raw floats; `skr_layout` gives the stride and
+ * the normal, bone ID and weight offsets in floats. Morph deltas are
+ * added before skinning.
+ */
+static const char* m_skr_gl_skin_comp =
+        "#version 430 core\n"
+        "layout (local_size_x = 64) in;\n"
+        "layout (std430, binding = 0) readonly buffer SkrSource {\n"
+        "  float skr_src[];\n"
+        "};\n"
+        "layout (std430, binding = 1) writeonly buffer SkrSkinned {\n"
+        "  vec4 skr_dst[];\n"
+        "};\n"
+        "uniform samplerBuffer skr_bones;\n"
+        "uniform samplerBuffer skr_morphs;\n"
+        "uniform int skr_bone_base;\n"
+        "uniform int skr_morph_base;\n"
+        "uniform uint skr_count;\n"
+        "uniform ivec4 skr_layout;\n"
+        "void main() {\n"
+        "  uint v = gl_GlobalInvocationID.x;\n"
+        "  if (v >= skr_count) return;\n"
+        "  int at = int(v) * skr_layout.x;\n"
+        "  int nat = at + skr_layout.y;\n"
+        "  vec4 p = vec4(skr_src[at], skr_src[at + 1], skr_src[at + 2], 1.0);\n"
+        "  vec4 n = vec4(skr_src[nat], skr_src[nat + 1], skr_src[nat + 2], "
+        "0.0);\n"
+        "  if (skr_morph_base >= 0) {\n"
+        "    int m = (skr_morph_base + int(v)) * 2;\n"
+        "    p.xyz += texelFetch(skr_morphs, m).xyz;\n"
+        "    n.xyz += texelFetch(skr_morphs, m + 1).xyz;\n"
+        "  }\n"
+        "  vec4 r0 = vec4(0.0), r1 = vec4(0.0), r2 = vec4(0.0);\n"
+        "  float sum = 0.0;\n"
+        "  for (int i = 0; i < 4; ++i) {\n"
+        "    float w = skr_src[at + skr_layout.w + i];\n"
+        "    if (w <= 0.0) continue;\n"
+        "    int id = floatBitsToInt(skr_src[at + skr_layout.z + i]);\n"
+        "    int b = (skr_bone_base + id) * 3;\n"
+        "    r0 += w * texelFetch(skr_bones, b);\n"
+        "    r1 += w * texelFetch(skr_bones, b + 1);\n"
+        "    r2 += w * texelFetch(skr_bones, b + 2);\n"
+        "    sum += w;\n"
+        "  }\n"
+        "  if (sum > 0.0) {\n"
+        "    p = vec4(dot(r0, p), dot(r1, p), dot(r2, p), 1.0);\n"
+        "    n = vec4(normalize(vec3(dot(r0, n), dot(r1, n), dot(r2, n))), "
+        "0.0);\n"
+        "  }\n"
+        "  skr_dst[v * 2u] = p;\n"
+        "  skr_dst[v * 2u + 1u] = n;\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL compile the skinning pre-pass compute shader if supported.
+ */
+static inline void m_skr_gl_skin_prepass_init(SkrSkinning* k) {
+	if (!m_skr_gl_has_version(4, 3))
+		return;
+
+	GLuint shader =
+	        m_skr_gl_create_shader(GL_COMPUTE_SHADER, m_skr_gl_skin_comp);
+	const GLuint program = shader ? m_skr_gl_create_program(&shader, 1) : 0;
+	if (!program) {
+		/* The CPU path covers it, not an init failure. */
+		SkrClearError();
+		return;
+	}
+
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "skr_bones"),
+	            SKR_SKINNING_UNIT);
+	glUniform1i(glGetUniformLocation(program, "skr_morphs"),
+	            SKR_MORPH_UNIT);
+	glUniform4i(glGetUniformLocation(program, "skr_layout"),
+	            (GLint)(sizeof(SkrVertex) / sizeof(float)),
+	            (GLint)(offsetof(SkrVertex, Normal) / sizeof(float)),
+	            (GLint)(offsetof(SkrVertex, BoneIDs) / sizeof(float)),
+	            (GLint)(offsetof(SkrVertex, BoneWeights) / sizeof(float)));
+
+	k->Backend.GL.Compute = program;
+	k->Backend.GL.ComputeBase = glGetUniformLocation(program, "skr_bone_base");
+	k->Backend.GL.ComputeCount = glGetUniformLocation(program, "skr_count");
+	k->Backend.GL.ComputeMorph =
+	        glGetUniformLocation(program, "skr_morph_base");
+}
+
+/**
+ * @internal
+ * @brief GL get the pre-pass output of renderable `i`, (re)creating it
+ * when the mesh changed.
  *
- * @return 1 if compilation/link succeeded, 0 otherwise.
+ * @return The output, or NULL on allocation failure.
  */
-static inline int m_skr_gl_check_compile_errors(const GLuint shader,
-                                                const char*  type) {
-	GLint  success;
-	GLchar infoLog[1024];
+static inline SkrSkinOutput* m_skr_gl_skin_output(SkrSkinning*    k,
+                                                  SkrRenderables* r,
+                                                  const unsigned int i) {
+	if (!r->Skinned[i]) {
+		if (k->OutputCount == k->OutputCapacity) {
+			const unsigned int cap =
+			        k->OutputCapacity ? k->OutputCapacity * 2 : 16;
+			SkrSkinOutput* grown = (SkrSkinOutput*)realloc(
+			        k->Outputs, cap * sizeof(SkrSkinOutput));
+			if (!grown)
+				return NULL;
+			k->Outputs = grown;
+			k->OutputCapacity = cap;
+		}
 
-	if (strcmp(type, "prog") == 0) {
-		glGetProgramiv(shader, GL_LINK_STATUS, &success);
-		if (!success) {
-			glGetProgramInfoLog(shader, sizeof(infoLog), NULL,
-			                    infoLog);
-			m_skr_last_error_set("failed to link %s: %s", type,
-			                     infoLog);
-			return 0;
+		k->Outputs[k->OutputCount] = (SkrSkinOutput){0};
+		r->Skinned[i] = ++k->OutputCount;
+	}
+
+	SkrSkinOutput* o = &k->Outputs[r->Skinned[i] - 1];
+	SkrMesh*       mesh = r->Mesh[i];
+
+	o->Base = r->Skin[i];
+	if (o->Mesh == mesh && o->VertexCount == (unsigned int)mesh->VertexCount)
+		return o;
+
+	o->Mesh = mesh;
+	o->VertexCount = (unsigned int)mesh->VertexCount;
+	o->Frame = 0;
+
+	if (!o->Backend.GL.Buffer) {
+		glGenBuffers(1, &o->Backend.GL.Buffer);
+		glGenVertexArrays(1, &o->Backend.GL.VAO);
+	}
+
+	glBindVertexArray(o->Backend.GL.VAO);
+
+	/* Skinned position and normal replace attributes 0 and 1. */
+	glBindBuffer(GL_ARRAY_BUFFER, o->Backend.GL.Buffer);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)o->VertexCount * 2 * sizeof(vec4),
+	             NULL, GL_DYNAMIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(vec4),
+	                      (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(vec4),
+	                      (void*)sizeof(vec4));
+
+	/* The rest comes from the mesh; bone attributes stay disabled. */
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->VBO);
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(SkrVertex),
+	                      (void*)offsetof(SkrVertex, UV));
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(SkrVertex),
+	                      (void*)offsetof(SkrVertex, Color));
+	glEnableVertexAttribArray(4);
+	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(SkrVertex),
+	                      (void*)offsetof(SkrVertex, Tangent));
+	glEnableVertexAttribArray(5);
+	glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(SkrVertex),
+	                      (void*)offsetof(SkrVertex, Bitangent));
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->EBO);
+	glBindVertexArray(0);
+
+	return o;
+}
+
+/**
+ * @internal
+ * @brief GL skin every visible skinned renderable once for this frame.
+ */
+static inline void m_skr_gl_skin_prepass(SkrState* s) {
+	SkrSkinning*    k = &s->Skinning;
+	SkrRenderables* r = &s->Renderables;
+	bool            dispatched = false;
+
+	if (!k->Prepass || k->Count == 0)
+		return;
+
+	const unsigned int count = r->DrawCount + r->TransparentCount;
+	for (unsigned int d = 0; d < count; ++d) {
+		const unsigned int i =
+		        d < r->DrawCount
+		                ? r->Draws[d].Index
+		                : r->Transparent[d - r->DrawCount].Index;
+		if (r->Skin[i] < 0)
+			continue;
+
+		SkrSkinOutput* o = m_skr_gl_skin_output(k, r, i);
+		if (!o || o->Frame == s->Stats.Frame)
+			continue;
+		o->Frame = s->Stats.Frame;
+
+		const int morph =
+		        r->Morph[i] >= 0
+		                ? (int)s->Morphs.Instances[r->Morph[i]].Base
+		                : -1;
+
+		if (k->Backend.GL.Compute) {
+			if (!dispatched)
+				glUseProgram(k->Backend.GL.Compute);
+			glUniform1i(k->Backend.GL.ComputeBase, o->Base);
+			glUniform1i(k->Backend.GL.ComputeMorph, morph);
+			glUniform1ui(k->Backend.GL.ComputeCount, o->VertexCount);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+			                 o->Mesh->VBO);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+			                 o->Backend.GL.Buffer);
+			glDispatchCompute((o->VertexCount + 63) / 64, 1, 1);
+			dispatched = true;
+			continue;
 		}
-	} else {
-		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-		if (!success) {
-			glGetShaderInfoLog(shader, sizeof(infoLog), NULL,
-			                   infoLog);
-			m_skr_last_error_set("failed to compile %s: %s", type,
-			                     infoLog);
-			return 0;
+
+		if (k->ScratchCapacity < o->VertexCount) {
+			vec4* grown = (vec4*)m_skr_aligned_grow(
+			        k->Scratch, 0, o->VertexCount * 2 * sizeof(vec4),
+			        16);
+			if (!grown)
+				continue;
+			k->Scratch = grown;
+			k->ScratchCapacity = o->VertexCount;
+		}
+
+		m_skr_skin_vertices(k, o->Base, o->Mesh->Vertices,
+		                    o->VertexCount,
+		                    morph >= 0 ? (const vec4*)&s->Morphs
+		                                         .Deltas[morph * 2]
+		                               : NULL,
+		                    k->Scratch);
+		glBindBuffer(GL_ARRAY_BUFFER, o->Backend.GL.Buffer);
+		glBufferSubData(GL_ARRAY_BUFFER, 0,
+		                (GLsizeiptr)o->VertexCount * 2 * sizeof(vec4),
+		                k->Scratch);
+	}
+
+	if (dispatched)
+		glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+/**
+ * @internal
+ * @brief GL internal format, format and type of each ::SkrFormat.
+ */
+static const GLenum m_skr_gl_formats[][3] = {
+        {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE},
+        {GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV},
+        {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT},
+        {GL_RG16F, GL_RG, GL_HALF_FLOAT},
+        {GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT},
+};
+
+/**
+ * @internal
+ * @brief GL delete the texture of target `t` and the framebuffers it is
+ * attached to.
+ */
+static inline void m_skr_gl_graph_release(SkrGraph* g, const unsigned int t) {
+	SkrGraphTarget* target = &g->Targets[t];
+	if (target->Backend.GL.Texture)
+		glDeleteTextures(1, &target->Backend.GL.Texture);
+	target->Backend.GL.Texture = 0;
+	target->Width = target->Height = 0;
+
+	for (unsigned int f = 0; f < g->FramebufferCount;) {
+		SkrGraphFramebuffer* fb = &g->Framebuffers[f];
+		bool                 attached = false;
+		for (unsigned int i = 0; i < fb->Count; ++i)
+			attached |= fb->Targets[i] == t;
+
+		if (!attached) {
+			++f;
+			continue;
+		}
+		glDeleteFramebuffers(1, &fb->Backend.GL.FBO);
+		*fb = g->Framebuffers[--g->FramebufferCount];
+	}
+}
+
+/**
+ * @internal
+ * @brief GL framebuffer over the transient writes of `pass`, created on
+ * first use and cached.
+ *
+ * @return 1 with `*fbo` set, 0 on failure.
+ */
+static inline int m_skr_gl_graph_framebuffer(SkrGraph*           g,
+                                             const SkrGraphPass* pass,
+                                             GLuint*             fbo) {
+	SkrGraphFramebuffer key = {.Count = pass->WriteCount};
+	for (unsigned int i = 0; i < pass->WriteCount; ++i)
+		key.Targets[i] =
+		        (unsigned int)g->Resources[pass->Writes[i]].Target;
+
+	for (unsigned int f = 0; f < g->FramebufferCount; ++f) {
+		const SkrGraphFramebuffer* fb = &g->Framebuffers[f];
+		if (fb->Count == key.Count &&
+		    memcmp(fb->Targets, key.Targets,
+		           key.Count * sizeof(unsigned int)) == 0) {
+			*fbo = fb->Backend.GL.FBO;
+			return 1;
 		}
 	}
 
+	if (!m_skr_graph_reserve((void**)&g->Framebuffers,
+	                         &g->FramebufferCapacity, g->FramebufferCount,
+	                         sizeof(SkrGraphFramebuffer)))
+		return 0;
+
+	GLenum       buffers[SKR_GRAPH_SLOTS];
+	unsigned int colors = 0;
+	glGenFramebuffers(1, &key.Backend.GL.FBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, key.Backend.GL.FBO);
+	for (unsigned int i = 0; i < key.Count; ++i) {
+		const SkrGraphTarget* t = &g->Targets[key.Targets[i]];
+		GLenum                attachment = GL_DEPTH_ATTACHMENT;
+		if (t->Format != SKR_FORMAT_DEPTH32F) {
+			attachment = GL_COLOR_ATTACHMENT0 + colors;
+			buffers[colors++] = attachment;
+		}
+		glFramebufferTexture2D(GL_FRAMEBUFFER, attachment,
+		                       GL_TEXTURE_2D, t->Backend.GL.Texture, 0);
+	}
+	if (colors)
+		glDrawBuffers((GLsizei)colors, buffers);
+	else
+		glDrawBuffer(GL_NONE);
+
+	const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		m_skr_last_error_set(SKR_ERROR_BACKEND,
+		                     "graph framebuffer incomplete (0x%x)",
+		                     status);
+		glDeleteFramebuffers(1, &key.Backend.GL.FBO);
+		return 0;
+	}
+
+	g->Framebuffers[g->FramebufferCount++] = key;
+	*fbo = key.Backend.GL.FBO;
 	return 1;
 }
 
 /**
  * @internal
- * @brief GL create an OpenGL shader from source.
+ * @brief GL run a compiled graph.
  *
- * @param type   Shader type (GL_VERTEX_SHADER, etc.).
- * @param source Null-terminated GLSL source code.
+ * Releases the targets the graph stopped using, allocates new ones, then
+ * runs each pass, binding its framebuffer only when it differs from the
+ * bound one. GL orders sampling after rendering to a texture on its own,
+ * so there are no barriers to issue. The framebuffer and viewport bound
+ * on entry are restored.
  *
- * @return Shader ID, or 0 on failure.
+ * @return 1 on success, 0 if a pass was skipped.
  */
-static inline GLuint m_skr_gl_create_shader(const GLenum type,
-                                            const char*  source) {
-	GLuint shader = glCreateShader(type);
-	glShaderSource(shader, 1, &source, NULL);
-	glCompileShader(shader);
+static inline int m_skr_gl_graph_execute(SkrState* s, SkrGraph* g) {
+	for (unsigned int t = 0; t < g->TargetCount; ++t) {
+		SkrGraphTarget* target = &g->Targets[t];
+		if (!target->Used) {
+			if (target->Width)
+				m_skr_gl_graph_release(g, t);
+			continue;
+		}
+		if (target->Backend.GL.Texture)
+			continue;
 
-	const char* type_str = NULL;
-	switch (type) {
-	case GL_VERTEX_SHADER:
-		type_str = "vert";
-		break;
-	case GL_FRAGMENT_SHADER:
-		type_str = "frag";
-		break;
-	case GL_GEOMETRY_SHADER:
-		type_str = "geom";
-		break;
-	default:
-		type_str = "unknown";
-		break;
+		const GLenum* format = m_skr_gl_formats[target->Format];
+		const GLint   filter = target->Format == SKR_FORMAT_DEPTH32F
+		                               ? GL_NEAREST
+		                               : GL_LINEAR;
+		glGenTextures(1, &target->Backend.GL.Texture);
+		glBindTexture(GL_TEXTURE_2D, target->Backend.GL.Texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, (GLint)format[0], target->Width,
+		             target->Height, 0, format[1], format[2], NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
+		                GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
+		                GL_CLAMP_TO_EDGE);
+	}
+
+	for (unsigned int r = 0; r < g->ResourceCount; ++r) {
+		SkrGraphResource* resource = &g->Resources[r];
+		if (!resource->Imported)
+			resource->Backend.GL.Texture =
+			        resource->Target >= 0
+			                ? g->Targets[resource->Target]
+			                          .Backend.GL.Texture
+			                : 0;
+	}
+
+	GLint entry = 0, viewport[4];
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &entry);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	GLuint bound = (GLuint)entry;
+	int    ok = 1;
+	g->Binds = 0;
+	for (unsigned int o = 0; o < g->OrderCount; ++o) {
+		const SkrGraphPass*     pass = &g->Passes[g->Order[o]];
+		const SkrGraphResource* first =
+		        pass->WriteCount ? &g->Resources[pass->Writes[0]]
+		                         : NULL;
+
+		GLuint fbo = bound;
+		if (first && first->Imported) {
+			fbo = first->Backend.GL.FBO;
+		} else if (first &&
+		           !m_skr_gl_graph_framebuffer(g, pass, &fbo)) {
+			glBindFramebuffer(GL_FRAMEBUFFER, bound);
+			ok = 0;
+			continue;
+		}
+
+		if (fbo != bound) {
+			glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+			if (first->Imported && !first->Width)
+				glViewport(viewport[0], viewport[1],
+				           viewport[2], viewport[3]);
+			else
+				glViewport(0, 0, first->Width, first->Height);
+			bound = fbo;
+			++g->Binds;
+		}
+
+		pass->Execute(s, g, pass->User);
+	}
+
+	if (bound != (GLuint)entry) {
+		glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)entry);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
 	}
+	return ok;
+}
+
+/**
+ * @internal
+ * @brief GL delete every target and framebuffer of a graph.
+ */
+static inline void m_skr_gl_graph_finalize(SkrGraph* g) {
+	for (unsigned int t = 0; t < g->TargetCount; ++t)
+		m_skr_gl_graph_release(g, t);
+	for (unsigned int r = 0; r < g->ResourceCount; ++r)
+		if (!g->Resources[r].Imported)
+			g->Resources[r].Backend.GL.Texture = 0;
+}
+
+/**
+ * @internal
+ * @brief GL render graph pass drawing the shadow cascades.
+ */
+static inline void m_skr_gl_shadows_pass(SkrState* s, const SkrGraph* g,
+                                         void* user) {
+	(void)g;
+	(void)user;
+	m_skr_gl_shadows_render(s);
+}
+
+/**
+ * @internal
+ * @brief GL render graph pass shading the scene into the bound targets,
+ * the frame target or the G-buffer.
+ */
+static inline void m_skr_gl_scene_pass(SkrState* s, const SkrGraph* g,
+                                       void* user) {
+	(void)g;
+	(void)user;
+
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	const bool prepassed =
+	        s->Depth.Prepass && s->Camera && m_skr_gl_depth_prepass(s);
+
+	for (unsigned int i = 0; i < s->ModelCount; ++i) {
+		SkrModel* model = &s->Models[i];
+		if (!model->Meshes)
+			continue;
+
+		for (unsigned int j = 0; j < model->MeshCount; ++j) {
+			SkrMesh* mesh = &model->Meshes[j];
+
+			if (mesh->VAO == 0 || mesh->VertexCount == 0)
+				continue;
+
+			glUseProgram(mesh->Program->Backend.GL.ID);
+			glBindVertexArray(mesh->VAO);
+
+			if (model->Node && mesh->Program->Backend.GL.Model >= 0)
+				glUniformMatrix4fv(
+				        mesh->Program->Backend.GL.Model, 1,
+				        GL_FALSE,
+				        (const float*)s->Scene
+				                .World[s->Scene.Slot[model->Node]]);
+
+			if (model->Textures && model->TextureCount > 0) {
+				for (unsigned int t = 0;
+				     t < model->TextureCount; ++t) {
+					glActiveTexture(GL_TEXTURE0 + t);
+					glBindTexture(GL_TEXTURE_2D,
+					              model->Textures[t]
+					                      .Backend.GL.ID);
+				}
+			}
 
-	if (!m_skr_gl_check_compile_errors(shader, type_str)) {
-		glDeleteShader(shader);
-		return 0;
+			m_skr_gl_draw_mesh(s, mesh);
+		}
 	}
 
-	m_skr_last_error_clear();
-	return shader;
+	m_skr_gl_renderables_render(s, s->Renderables.Draws,
+	                            s->Renderables.DrawCount, prepassed);
 }
 
 /**
  * @internal
- * @brief GL create an OpenGL shader from a file.
- *
- * Reads the file contents and compiles it as a shader of the given type.
- *
- * @param type Shader type.
- * @param path File path to GLSL source.
+ * @brief GL weighted blended composite: the average color of the
+ * transparent layers, their total coverage as alpha.
+ */
+static const char* m_skr_gl_composite_frag =
+        "#version 330 core\n"
+        "uniform sampler2D skr_accum;\n"
+        "uniform sampler2D skr_weight;\n"
+        "out vec4 FragColor;\n"
+        "void main() {\n"
+        "  ivec2 p = ivec2(gl_FragCoord.xy);\n"
+        "  vec4 accum = texelFetch(skr_accum, p, 0);\n"
+        "  if (accum.a >= 1.0)\n"
+        "    discard;\n"
+        "  float weight = texelFetch(skr_weight, p, 0).r;\n"
+        "  FragColor = vec4(accum.rgb / max(weight, 1e-5), 1.0 - accum.a);\n"
+        "}\n";
+
+/**
+ * @internal
+ * @brief GL create the composite of SKR_TRANSPARENCY_WEIGHTED on first
+ * use.
  *
- * @return Shader ID, or 0 on failure.
+ * @return 1 when it is ready, 0 on failure.
  */
-static inline GLuint m_skr_gl_create_shader_from_file(const GLenum type,
-                                                      const char*  path) {
-	char* source = m_skr_read_file(path);
-	if (!source) {
+static inline int m_skr_gl_transparency_prepare(SkrTransparency* t) {
+	if (t->Backend.GL.Composite)
+		return 1;
+
+	const SkrShader shaders[] = {
+	        {.Type = GL_VERTEX_SHADER, .GLSL = m_skr_gl_fullscreen_vert},
+	        {.Type = GL_FRAGMENT_SHADER, .GLSL = m_skr_gl_composite_frag},
+	};
+	const GLuint program =
+	        m_skr_gl_create_program_from_shaders(shaders, sizeof(shaders));
+	if (!program)
 		return 0;
-	}
 
-	GLuint shader = m_skr_gl_create_shader(type, source);
-	free(source);
+	t->Backend.GL.Composite = program;
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "skr_accum"), 0);
+	glUniform1i(glGetUniformLocation(program, "skr_weight"), 1);
+	glGenVertexArrays(1, &t->Backend.GL.VAO);
+	return 1;
+}
 
-	m_skr_last_error_clear();
-	return shader;
+/**
+ * @internal
+ * @brief GL render graph pass blending the sorted transparent draws over
+ * the bound scene, back to front.
+ */
+static inline void m_skr_gl_transparent_pass(SkrState* s, const SkrGraph* g,
+                                             void* user) {
+	const SkrRenderables* r = &s->Renderables;
+	(void)g;
+	(void)user;
+
+	m_skr_gl_debug_group_push(s, "skr: transparent");
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDepthFunc(s->View.ReverseZ ? GL_GREATER : GL_LESS);
+	glDepthMask(GL_FALSE);
+	m_skr_gl_renderables_render(s, r->Transparent, r->TransparentCount,
+	                            false);
+	glDepthMask(GL_TRUE);
+	glDisable(GL_BLEND);
+	m_skr_gl_debug_group_pop(s);
 }
 
 /**
  * @internal
- * @brief GL link multiple shaders into a program.
- *
- * Attaches all shaders, links, deletes them, and returns the program.
- *
- * @param shaders Array of shader IDs.
- * @param count   Number of shaders.
+ * @brief GL render graph pass summing the weighted transparent draws into
+ * the accumulation and weight targets.
  *
- * @return Program ID, or 0 on failure.
+ * GL 3.3 has one blend function for every target: color and weight add
+ * up, and alpha multiplies into how much of the scene is still revealed,
+ * kept in the accumulation alpha.
  */
-static inline GLuint m_skr_gl_create_program(const GLuint* shaders,
-                                             const size_t  count) {
-	GLuint program = glCreateProgram();
-	for (size_t i = 0; i < count; ++i) {
-		glAttachShader(program, shaders[i]);
-	}
-
-	glLinkProgram(program);
-	if (!m_skr_gl_check_compile_errors(program, "prog")) {
-		glDeleteProgram(program);
-		return 0;
-	}
+static inline void m_skr_gl_accumulate_pass(SkrState* s, const SkrGraph* g,
+                                            void* user) {
+	static const GLfloat  accum[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+	static const GLfloat  weight[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	const SkrRenderables* r = &s->Renderables;
+	(void)g;
+	(void)user;
+
+	m_skr_gl_debug_group_push(s, "skr: accumulate");
+	glClearBufferfv(GL_COLOR, 0, accum);
+	glClearBufferfv(GL_COLOR, 1, weight);
+	glEnable(GL_BLEND);
+	glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+	glDepthFunc(s->View.ReverseZ ? GL_GREATER : GL_LESS);
+	glDepthMask(GL_FALSE);
+	m_skr_gl_renderables_render(s, r->Transparent, r->TransparentCount,
+	                            false);
+	glDepthMask(GL_TRUE);
+	glDisable(GL_BLEND);
+	m_skr_gl_debug_group_pop(s);
+}
 
-	for (size_t i = 0; i < count; ++i) {
-		glDetachShader(program, shaders[i]);
-		glDeleteShader(shaders[i]);
+/**
+ * @internal
+ * @brief GL render graph pass blending the weighted average of the
+ * transparent draws over the bound scene.
+ */
+static inline void m_skr_gl_composite_pass(SkrState* s, const SkrGraph* g,
+                                           void* user) {
+	const SkrTransparency* t = &s->Transparency;
+	(void)user;
+
+	m_skr_gl_debug_group_push(s, "skr: composite");
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glUseProgram(t->Backend.GL.Composite);
+	for (int i = 0; i < 2; ++i) {
+		glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+		glBindTexture(GL_TEXTURE_2D,
+		              g->Resources[t->Targets[i]].Backend.GL.Texture);
 	}
-
-	m_skr_last_error_clear();
-	return program;
+	glBindVertexArray(t->Backend.GL.VAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+	m_skr_gl_debug_group_pop(s);
 }
 
 /**
  * @internal
- * @brief GL create program from SkrShader array (source or file).
+ * @brief GL declare the passes drawing SkrRenderables::Transparent over
+ * `color`, of `width` by `height`, tested against `depth`.
  *
- * @param shaders_input Array of SkrShader descriptors.
- * @param count         Number of shaders.
+ * An imported `color` brings its own depth, and is only blended into
+ * directly: SKR_TRANSPARENCY_WEIGHTED needs a transient one.
  *
- * @return Program ID, or 0 on failure.
+ * @return 1 on success, 0 on error.
  */
-static inline GLuint
-m_skr_gl_create_program_from_shaders(const SkrShader* shader_array,
-                                     const size_t     size) {
-	if (!shader_array || size == 0) {
-		m_skr_last_error_set("either shaders_input != 1 or count == 0");
-		return 0;
+static inline int m_skr_gl_transparency_graph(SkrState* s, const int color,
+                                              int depth, const int width,
+                                              const int height) {
+	SkrGraph*        g = &s->Graph;
+	SkrTransparency* t = &s->Transparency;
+
+	if (!s->Renderables.TransparentCount)
+		return 1;
+	if (g->Resources[color].Imported)
+		depth = -1;
+
+	if (t->Mode != SKR_TRANSPARENCY_WEIGHTED || depth < 0) {
+		const int pass = skr_graph_pass(
+		        g, "transparent", m_skr_gl_transparent_pass, NULL);
+		return pass >= 0 &&
+		       skr_graph_write(g, (unsigned int)pass,
+		                       (unsigned int)color) &&
+		       (depth < 0 || skr_graph_write(g, (unsigned int)pass,
+		                                     (unsigned int)depth));
 	}
 
-	const size_t count = size / sizeof(SkrShader);
+	static const SkrFormat formats[2] = {SKR_FORMAT_RGBA16F,
+	                                     SKR_FORMAT_RG16F};
+	static const char*     names[2] = {"accumulation", "weight"};
 
-	GLuint* shaders = (GLuint*)malloc(sizeof(GLuint) * count);
-	if (!shaders) {
-		m_skr_last_error_set("shaders_input == NULL");
+	const int accumulate = skr_graph_pass(g, "accumulate",
+	                                      m_skr_gl_accumulate_pass, NULL);
+	const int composite = skr_graph_pass(g, "composite",
+	                                     m_skr_gl_composite_pass, NULL);
+	if (accumulate < 0 || composite < 0)
 		return 0;
+
+	for (int i = 0; i < 2; ++i) {
+		const int r = skr_graph_create(g, names[i], formats[i], width,
+		                               height);
+		t->Targets[i] = r;
+		if (r < 0 ||
+		    !skr_graph_write(g, (unsigned int)accumulate,
+		                     (unsigned int)r) ||
+		    !skr_graph_read(g, (unsigned int)composite,
+		                    (unsigned int)r))
+			return 0;
 	}
 
-	for (size_t i = 0; i < count; ++i) {
-		const SkrShader* s = &shader_array[i];
-		GLuint           shader = 0;
+	return skr_graph_write(g, (unsigned int)accumulate,
+	                       (unsigned int)depth) &&
+	       skr_graph_write(g, (unsigned int)composite,
+	                       (unsigned int)color);
+}
 
-		if (s->GLSL) {
-			shader = m_skr_gl_create_shader(s->Type, s->GLSL);
-		} else if (s->Path) {
-			shader = m_skr_gl_create_shader_from_file(s->Type,
-			                                          s->Path);
-		} else {
-			for (size_t j = 0; j < i; ++j) {
-				glDeleteShader(shaders[j]);
-			}
-			free(shaders);
-			m_skr_last_error_set(
-			        "shader.Source and shader.Path are NULL");
+/**
+ * @internal
+ * @brief GL declare the passes shading the scene into `color`, sized
+ * `width` by `height`: a forward pass, or the G-buffer and its resolve,
+ * then the transparent draws.
+ *
+ * A transient `color` gets a transient depth for the forward pass. That
+ * depth, or the G-buffer's, is returned in `depth` (-1 for none).
+ *
+ * @return 1 on success, 0 on error.
+ */
+static inline int m_skr_gl_scene_graph(SkrState* s, const int color,
+                                       const int shadows, const int width,
+                                       const int height, int* depth) {
+	SkrGraph* g = &s->Graph;
+	*depth = -1;
+
+	/* Light tiles follow the scene target, not the window. */
+	m_skr_gl_lights_target(&s->Lights, width, height);
+
+	/* Deferred: geometry fills the G-buffer, the resolve lights it. */
+	const bool deferred = s->Path == SKR_RENDER_DEFERRED && s->Camera;
+	if (deferred && !m_skr_gl_gbuffer_prepare(&s->GBuffer))
+		s->Path = SKR_RENDER_FORWARD;
+
+	if (deferred && s->Path == SKR_RENDER_DEFERRED) {
+		static const SkrFormat formats[3] = {SKR_FORMAT_RGBA8,
+		                                     SKR_FORMAT_RGB10_A2,
+		                                     SKR_FORMAT_DEPTH32F};
+		static const char*     names[3] = {"albedo", "normal", "depth"};
+
+		const int geometry = skr_graph_pass(g, "geometry",
+		                                    m_skr_gl_scene_pass, NULL);
+		const int resolve = skr_graph_pass(
+		        g, "resolve", m_skr_gl_gbuffer_resolve, NULL);
+		if (geometry < 0 || resolve < 0)
 			return 0;
-		}
 
-		if (!shader) {
-			for (size_t j = 0; j < i; ++j) {
-				glDeleteShader(shaders[j]);
-			}
-			free(shaders);
-			return 0;
+		for (int t = 0; t < 3; ++t) {
+			const int r = skr_graph_create(g, names[t], formats[t],
+			                               width, height);
+			s->GBuffer.Targets[t] = r;
+			if (r < 0 ||
+			    !skr_graph_write(g, (unsigned int)geometry,
+			                     (unsigned int)r) ||
+			    !skr_graph_read(g, (unsigned int)resolve,
+			                    (unsigned int)r))
+				return 0;
 		}
 
-		shaders[i] = shader;
+		*depth = s->GBuffer.Targets[2];
+		if ((shadows >= 0 &&
+		     !skr_graph_read(g, (unsigned int)resolve,
+		                     (unsigned int)shadows)) ||
+		    !skr_graph_write(g, (unsigned int)resolve,
+		                     (unsigned int)color))
+			return 0;
+		return m_skr_gl_transparency_graph(s, color, *depth, width,
+		                                   height);
 	}
 
-	GLuint program = m_skr_gl_create_program(shaders, count);
-	free(shaders);
-
-	if (!program) {
+	const int scene = skr_graph_pass(g, "scene", m_skr_gl_scene_pass, NULL);
+	if (scene < 0 ||
+	    (shadows >= 0 &&
+	     !skr_graph_read(g, (unsigned int)scene, (unsigned int)shadows)) ||
+	    !skr_graph_write(g, (unsigned int)scene, (unsigned int)color))
 		return 0;
-	}
 
-	m_skr_last_error_clear();
-	return program;
+	if (!g->Resources[color].Imported) {
+		*depth = skr_graph_create(g, "scene depth", SKR_FORMAT_DEPTH32F,
+		                          width, height);
+		if (*depth < 0 ||
+		    !skr_graph_write(g, (unsigned int)scene,
+		                     (unsigned int)*depth))
+			return 0;
+	}
+	return m_skr_gl_transparency_graph(s, color, *depth, width, height);
 }
 
 /**
  * @internal
- * @brief GL destroy an OpenGL shader program.
+ * @brief GL declare the passes of SkrState::Temporal: the scene into
+ * transient targets of the SkrResolution size and `format`, its velocity
+ * and the resolve into this frame's history.
  *
- * @param program Pointer to program ID. Resets to 0 on success.
+ * @return The history resource, -1 on error.
  */
-static inline void m_skr_gl_shader_destroy(GLuint program) {
-	if (program) {
-		glDeleteProgram(program);
-		program = 0;
-		m_skr_last_error_clear();
-	}
-}
+static inline int m_skr_gl_temporal_graph(SkrState* s, const int shadows,
+                                          const SkrFormat format) {
+	SkrGraph*            g = &s->Graph;
+	SkrTemporal*         t = &s->Temporal;
+	const SkrResolution* res = &s->Resolution;
+	int*                 targets = t->Targets;
+
+	targets[0] = skr_graph_create(g, "scene color", format, res->Width,
+	                              res->Height);
+	if (targets[0] < 0 ||
+	    !m_skr_gl_scene_graph(s, targets[0], shadows, res->Width,
+	                          res->Height, &targets[2]))
+		return -1;
 
-static inline void m_skr_gl_shader_set_bool(const GLuint program,
-                                            const char* name, const int value) {
-	glUniform1i(glGetUniformLocation(program, name), value);
-	m_skr_last_error_clear();
-}
+	/* Velocity tests against the scene depth, so it writes it too. */
+	targets[1] = skr_graph_create(g, "velocity", SKR_FORMAT_RG16F,
+	                              res->Width, res->Height);
+	const int velocity = skr_graph_pass(g, "velocity",
+	                                    m_skr_gl_velocity_pass, NULL);
+	if (targets[1] < 0 || velocity < 0 ||
+	    !skr_graph_write(g, (unsigned int)velocity,
+	                     (unsigned int)targets[1]) ||
+	    !skr_graph_write(g, (unsigned int)velocity,
+	                     (unsigned int)targets[2]))
+		return -1;
 
-static inline void m_skr_gl_shader_set_int(const GLuint program,
-                                           const char* name, const int value) {
-	glUniform1i(glGetUniformLocation(program, name), value);
-	m_skr_last_error_clear();
-}
+	const unsigned int current = t->Backend.GL.Current ^= 1;
+	targets[3] = skr_graph_import(g, "previous history");
+	const int history = skr_graph_import(g, "history");
+	const int resolve = skr_graph_pass(g, "temporal",
+	                                   m_skr_gl_temporal_pass, NULL);
+	if (targets[3] < 0 || history < 0 || resolve < 0)
+		return -1;
 
-static inline void m_skr_gl_shader_set_float(const GLuint program,
-                                             const char*  name,
-                                             const float  value) {
-	glUniform1f(glGetUniformLocation(program, name), value);
-	m_skr_last_error_clear();
+	SkrGraphResource* h = &g->Resources[history];
+	g->Resources[targets[3]].Backend.GL.Texture =
+	        t->Backend.GL.History[current ^ 1];
+	h->Backend.GL.Texture = t->Backend.GL.History[current];
+	h->Backend.GL.FBO = t->Backend.GL.FBO[current];
+	h->Width = t->Backend.GL.Width;
+	h->Height = t->Backend.GL.Height;
+	for (int i = 0; i < 4; ++i)
+		if (!skr_graph_read(g, (unsigned int)resolve,
+		                    (unsigned int)targets[i]))
+			return -1;
+
+	return skr_graph_write(g, (unsigned int)resolve,
+	                       (unsigned int)history)
+	               ? history
+	               : -1;
 }
 
-static inline void m_skr_gl_shader_set_vec2(const GLuint program,
-                                            const char*  name,
-                                            const vec2   value) {
-	glUniform2fv(glGetUniformLocation(program, name), 1, value);
-	m_skr_last_error_clear();
-}
+/**
+ * @internal
+ * @brief GL declare the bloom chain of `source` and the fused post
+ * passes of `flags` presenting it to `out`, of `width` by `height`.
+ *
+ * @return 1 on success, 0 on error.
+ */
+static inline int m_skr_gl_post_graph(SkrState* s, unsigned int flags,
+                                      const int source, const int out,
+                                      const int width, const int height) {
+	SkrGraph* g = &s->Graph;
+	SkrPost*  p = &s->Post;
+	int       bloom[SKR_BLOOM_LEVELS];
+	int       levels = 0;
+
+	p->Source = source;
+	p->Bloom = -1;
+	if (flags & SKR_POST_BLOOM) {
+		const int count = p->Levels ? (int)p->Levels : 5;
+		int       above = source, w = width, h = height;
+		while (levels < count && levels < SKR_BLOOM_LEVELS && w > 1 &&
+		       h > 1) {
+			w /= 2;
+			h /= 2;
+			bloom[levels] = skr_graph_create(
+			        g, "bloom", SKR_FORMAT_RGBA16F, w, h);
+			const int down = skr_graph_pass(
+			        g, "bloom down", m_skr_gl_bloom_down_pass,
+			        (void*)(uintptr_t)above);
+			if (bloom[levels] < 0 || down < 0 ||
+			    !skr_graph_read(g, (unsigned int)down,
+			                    (unsigned int)above) ||
+			    !skr_graph_write(g, (unsigned int)down,
+			                     (unsigned int)bloom[levels]))
+				return 0;
+			above = bloom[levels++];
+		}
 
-static inline void m_skr_gl_shader_set_vec3(const GLuint program,
-                                            const char*  name,
-                                            const vec3   value) {
-	glUniform3fv(glGetUniformLocation(program, name), 1, value);
-	m_skr_last_error_clear();
-}
+		/* Add each level into the one above, from the smallest. */
+		for (int l = levels - 1; l > 0; --l) {
+			const int up = skr_graph_pass(
+			        g, "bloom up", m_skr_gl_bloom_up_pass,
+			        (void*)(uintptr_t)bloom[l]);
+			if (up < 0 ||
+			    !skr_graph_read(g, (unsigned int)up,
+			                    (unsigned int)bloom[l]) ||
+			    !skr_graph_write(g, (unsigned int)up,
+			                     (unsigned int)bloom[l - 1]))
+				return 0;
+		}
+		p->Bloom = levels ? bloom[0] : -1;
+	}
 
-static inline void m_skr_gl_shader_set_vec4(const GLuint program,
-                                            const char*  name,
-                                            const vec4   value) {
-	glUniform4fv(glGetUniformLocation(program, name), 1, value);
-	m_skr_last_error_clear();
+	if (p->Bloom < 0)
+		flags &= ~(unsigned int)SKR_POST_BLOOM;
+
+	unsigned int       keys[2];
+	const unsigned int passes = m_skr_post_keys(flags, keys);
+
+	p->Color = passes > 1 ? skr_graph_create(g, "post color",
+	                                         SKR_FORMAT_RGBA8, width,
+	                                         height)
+	                      : out;
+	for (unsigned int i = 0; i < passes; ++i) {
+		const int input = i ? p->Color : source;
+		const int output = i + 1 < passes ? p->Color : out;
+		const int pass = skr_graph_pass(g, "post", m_skr_gl_post_pass,
+		                                (void*)(uintptr_t)keys[i]);
+		if (input < 0 || output < 0 || pass < 0 ||
+		    !skr_graph_read(g, (unsigned int)pass,
+		                    (unsigned int)input) ||
+		    (!i && p->Bloom >= 0 &&
+		     !skr_graph_read(g, (unsigned int)pass,
+		                     (unsigned int)p->Bloom)) ||
+		    !skr_graph_write(g, (unsigned int)pass,
+		                     (unsigned int)output))
+			return 0;
+	}
+	return 1;
 }
 
-static inline void m_skr_gl_shader_set_mat2(const GLuint program,
-                                            const char*  name,
-                                            const mat2   value) {
-	glUniformMatrix2fv(glGetUniformLocation(program, name), 1, GL_FALSE,
-	                   (const float*)value);
-	m_skr_last_error_clear();
-}
+/**
+ * @internal
+ * @brief GL declare the passes of the frame into SkrState::Graph.
+ *
+ * The bound framebuffer and the shadow map are imported. With
+ * SkrState::Resolution below full scale, the scene is shaded into
+ * transient targets of the scaled size and an upscale pass fills the
+ * viewport. SkrState::Temporal resolves them into its history instead,
+ * and SkrState::Post presents either through its passes.
+ *
+ * @return 1 on success, 0 on error.
+ */
+static inline int m_skr_gl_frame_graph(SkrState* s) {
+	SkrGraph*      g = &s->Graph;
+	SkrResolution* res = &s->Resolution;
+	GLint          target = 0, viewport[4];
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	skr_graph_reset(g);
+	const int out = skr_graph_import(g, "target");
+	if (out < 0)
+		return 0;
+	g->Resources[out].Backend.GL.FBO = (GLuint)target;
+
+	int shadows = -1;
+	if (s->Camera) {
+		const SkrShadows* sh = &s->Shadows;
+		shadows = skr_graph_import(g, "shadow map");
+		const int pass = skr_graph_pass(g, "shadows",
+		                                m_skr_gl_shadows_pass, NULL);
+		if (shadows < 0 || pass < 0 ||
+		    !skr_graph_write(g, (unsigned int)pass,
+		                     (unsigned int)shadows))
+			return 0;
+		SkrGraphResource* map = &g->Resources[shadows];
+		map->Backend.GL.Texture = sh->Backend.GL.Texture;
+		map->Backend.GL.FBO = sh->Backend.GL.FBO;
+	}
 
-static inline void m_skr_gl_shader_set_mat3(const GLuint program,
-                                            const char*  name,
-                                            const mat3   value) {
-	glUniformMatrix3fv(glGetUniformLocation(program, name), 1, GL_FALSE,
-	                   (const float*)value);
-	m_skr_last_error_clear();
-}
+	res->Width = viewport[2];
+	res->Height = viewport[3];
+	if (res->Enabled && res->Backend.GL.Program) {
+		skr_resolution_update(res, 0.0);
+		res->Width = (int)((float)viewport[2] * res->Scale + 0.5f);
+		res->Height = (int)((float)viewport[3] * res->Scale + 0.5f);
+		res->Width = res->Width > 0 ? res->Width : 1;
+		res->Height = res->Height > 0 ? res->Height : 1;
+	}
 
-static inline void m_skr_gl_shader_set_mat4(const GLuint program,
-                                            const char*  name,
-                                            const mat4   value) {
-	glUniformMatrix4fv(glGetUniformLocation(program, name), 1, GL_FALSE,
-	                   (const float*)value);
-	m_skr_last_error_clear();
+	int depth;
+	if (viewport[2] <= 0 || viewport[3] <= 0)
+		return m_skr_gl_scene_graph(s, out, shadows, 1, 1, &depth);
+
+	/* Without their programs, TAA and post-processing stay off. */
+	SkrTemporal* t = &s->Temporal;
+	SkrPost*     post = &s->Post;
+	if (t->Enabled && s->Camera &&
+	    !m_skr_gl_temporal_prepare(s, viewport[2], viewport[3]))
+		t->Enabled = false;
+	unsigned int flags = post->Flags;
+	if (!post->Lut.Backend.GL.ID)
+		flags &= ~(unsigned int)SKR_POST_GRADE;
+	if (flags && !m_skr_gl_post_prepare(post, flags))
+		flags = post->Flags = 0;
+	SkrTransparency* tr = &s->Transparency;
+	if (tr->Mode == SKR_TRANSPARENCY_WEIGHTED &&
+	    !m_skr_gl_transparency_prepare(tr))
+		tr->Mode = SKR_TRANSPARENCY_SORTED;
+
+	/* Deferred and weighted transparents need a transient color. */
+	const bool blended =
+	        s->Renderables.TransparentCount &&
+	        ((s->Path == SKR_RENDER_DEFERRED && s->Camera) ||
+	         tr->Mode == SKR_TRANSPARENCY_WEIGHTED) &&
+	        m_skr_gl_resolution_prepare(res);
+
+	/* Post-processing works on the unclamped scene. */
+	const SkrFormat format = flags ? SKR_FORMAT_RGBA16F : SKR_FORMAT_RGBA8;
+	int color;
+	if (t->Enabled && s->Camera) {
+		color = m_skr_gl_temporal_graph(s, shadows, format);
+	} else if (!flags && !blended && res->Width == viewport[2] &&
+	           res->Height == viewport[3]) {
+		return m_skr_gl_scene_graph(s, out, shadows, res->Width,
+		                            res->Height, &depth);
+	} else {
+		color = skr_graph_create(g, "scene color", format, res->Width,
+		                         res->Height);
+		if (color >= 0 &&
+		    !m_skr_gl_scene_graph(s, color, shadows, res->Width,
+		                          res->Height, &depth))
+			color = -1;
+	}
+	if (color < 0)
+		return 0;
+	if (flags)
+		return m_skr_gl_post_graph(s, flags, color, out, viewport[2],
+		                           viewport[3]);
+
+	const int upscale = skr_graph_pass(g, "upscale", m_skr_gl_upscale_pass,
+	                                   (void*)(uintptr_t)color);
+	return upscale >= 0 &&
+	       skr_graph_read(g, (unsigned int)upscale, (unsigned int)color) &&
+	       skr_graph_write(g, (unsigned int)upscale, (unsigned int)out);
 }
 
 static inline void m_skr_gl_renderer_render(SkrState* s) {
+	SkrResolution* res = &s->Resolution;
 
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	skr_debug_frame_begin(s);
+	m_skr_gl_debug_group_push(s, "skr: scene");
 
-	for (unsigned int i = 0; i < s->ModelCount; ++i) {
-		SkrModel* model = &s->Models[i];
-		if (!model->Meshes)
-			continue;
+	/* Without its upscale, dynamic resolution stays off. */
+	if (res->Enabled && !m_skr_gl_resolution_prepare(res))
+		res->Enabled = false;
+	const bool timed = res->Enabled && m_skr_gl_resolution_begin(res);
 
-		for (unsigned int j = 0; j < model->MeshCount; ++j) {
-			SkrMesh* mesh = &model->Meshes[j];
+	m_skr_gl_view_upload(&s->View);
+	m_skr_gl_skinning_upload(&s->Skinning);
+	m_skr_gl_morphs_upload(&s->Morphs);
+	m_skr_gl_lights_upload(&s->Lights);
+	m_skr_gl_skin_prepass(s);
 
-			if (mesh->VAO == 0 || mesh->VertexCount == 0)
-				continue;
+	if (m_skr_gl_frame_graph(s) && skr_graph_compile(&s->Graph))
+		m_skr_gl_graph_execute(s, &s->Graph);
 
-			glUseProgram(mesh->Program->Backend.GL.ID);
-			glBindVertexArray(mesh->VAO);
+	if (timed)
+		glEndQuery(GL_TIME_ELAPSED);
 
-			if (model->Textures && model->TextureCount > 0) {
-				for (unsigned int t = 0;
-				     t < model->TextureCount; ++t) {
-					glActiveTexture(GL_TEXTURE0 + t);
-					glBindTexture(GL_TEXTURE_2D,
-					              model->Textures[t]
-					                      .Backend.GL.ID);
-				}
-			}
+	m_skr_gl_debug_group_pop(s);
+	m_skr_gl_debug_frame_end(s);
+}
 
-			if (mesh->IndexCount > 0) {
-				glDrawElements(GL_TRIANGLES, mesh->IndexCount,
-				               GL_UNSIGNED_INT, 0);
-			} else {
-				glDrawArrays(GL_TRIANGLES, 0,
-				             mesh->VertexCount);
-			}
-		}
-	}
+/**
+ * @internal
+ * @brief GL delete the buffers of a mesh, safe to call twice.
+ */
+static inline void m_skr_gl_mesh_finalize(SkrMesh* mesh) {
+	if (mesh->VAO)
+		glDeleteVertexArrays(1, &mesh->VAO);
+	if (mesh->VBO)
+		glDeleteBuffers(1, &mesh->VBO);
+	if (mesh->EBO)
+		glDeleteBuffers(1, &mesh->EBO);
+	if (mesh->PositionVAO)
+		glDeleteVertexArrays(1, &mesh->PositionVAO);
+	if (mesh->PositionVBO)
+		glDeleteBuffers(1, &mesh->PositionVBO);
+
+	mesh->VAO = mesh->VBO = mesh->EBO = 0;
+	mesh->PositionVAO = mesh->PositionVBO = 0;
 }
 
 static inline void m_skr_gl_renderer_finalize(SkrState* s) {
@@ -1033,21 +10582,114 @@ static inline void m_skr_gl_renderer_finalize(SkrState* s) {
 			}
 		}
 
-		if (!model->Meshes)
-			continue;
+		if (!model->Meshes)
+			continue;
+
+		for (unsigned int j = 0; j < model->MeshCount; ++j)
+			m_skr_gl_mesh_finalize(&model->Meshes[j]);
+	}
+
+	for (unsigned int i = 0; i < s->Renderables.Count; ++i)
+		m_skr_gl_mesh_finalize(s->Renderables.Mesh[i]);
+
+	if (s->View.Backend.GL.Buffer)
+		glDeleteBuffers(1, &s->View.Backend.GL.Buffer);
+	s->View.Backend.GL.Buffer = 0;
+
+	if (s->Skinning.Backend.GL.Buffer) {
+		glDeleteTextures(1, &s->Skinning.Backend.GL.Texture);
+		glDeleteBuffers(1, &s->Skinning.Backend.GL.Buffer);
+	}
+	s->Skinning.Backend.GL.Buffer = 0;
+	s->Skinning.Backend.GL.Texture = 0;
+	s->Skinning.Backend.GL.Capacity = 0;
+
+	for (unsigned int i = 0; i < s->Skinning.OutputCount; ++i) {
+		SkrSkinOutput* o = &s->Skinning.Outputs[i];
+		glDeleteVertexArrays(1, &o->Backend.GL.VAO);
+		glDeleteBuffers(1, &o->Backend.GL.Buffer);
+		o->Backend.GL.VAO = o->Backend.GL.Buffer = 0;
+	}
+	if (s->Skinning.Backend.GL.Compute)
+		glDeleteProgram(s->Skinning.Backend.GL.Compute);
+	s->Skinning.Backend.GL.Compute = 0;
+
+	if (s->Morphs.Backend.GL.Buffer) {
+		glDeleteTextures(1, &s->Morphs.Backend.GL.Texture);
+		glDeleteBuffers(1, &s->Morphs.Backend.GL.Buffer);
+	}
+	s->Morphs.Backend.GL.Buffer = 0;
+	s->Morphs.Backend.GL.Texture = 0;
+	s->Morphs.Backend.GL.Capacity = 0;
+
+	if (s->Lights.Backend.GL.Block) {
+		glDeleteTextures(3, s->Lights.Backend.GL.Textures);
+		glDeleteBuffers(3, s->Lights.Backend.GL.Buffers);
+		glDeleteBuffers(1, &s->Lights.Backend.GL.Block);
+	}
+	memset(&s->Lights.Backend, 0, sizeof(s->Lights.Backend));
+
+	SkrShadows* sh = &s->Shadows;
+	if (sh->Backend.GL.Block) {
+		glDeleteBuffers(1, &sh->Backend.GL.Block);
+		glDeleteTextures(1, &sh->Backend.GL.Texture);
+		glDeleteFramebuffers(1, &sh->Backend.GL.FBO);
+	}
+	memset(&sh->Backend, 0, sizeof(sh->Backend));
+
+	if (s->Depth.Backend.GL.Program)
+		glDeleteProgram(s->Depth.Backend.GL.Program);
+	if (s->Depth.Backend.GL.Deform)
+		glDeleteProgram(s->Depth.Backend.GL.Deform);
+	memset(&s->Depth.Backend, 0, sizeof(s->Depth.Backend));
+
+	SkrGBuffer* g = &s->GBuffer;
+	if (g->Resolve.Backend.GL.ID) {
+		glDeleteProgram(g->Resolve.Backend.GL.ID);
+		glDeleteVertexArrays(1, &g->Backend.GL.VAO);
+	}
+	memset(g, 0, sizeof(*g));
 
-		for (unsigned int j = 0; j < model->MeshCount; ++j) {
-			SkrMesh* mesh = &model->Meshes[j];
-			if (mesh->VAO)
-				glDeleteVertexArrays(1, &mesh->VAO);
-			if (mesh->VBO)
-				glDeleteBuffers(1, &mesh->VBO);
-			if (mesh->EBO)
-				glDeleteBuffers(1, &mesh->EBO);
+	m_skr_gl_graph_finalize(&s->Graph);
 
-			mesh->VAO = mesh->VBO = mesh->EBO = 0;
-		}
+	SkrResolution* res = &s->Resolution;
+	if (res->Backend.GL.Program) {
+		glDeleteProgram(res->Backend.GL.Program);
+		glDeleteVertexArrays(1, &res->Backend.GL.VAO);
+		glDeleteQueries(SKR_RESOLUTION_QUERIES,
+		                res->Backend.GL.Queries);
 	}
+	memset(&res->Backend, 0, sizeof(res->Backend));
+
+	SkrTemporal* t = &s->Temporal;
+	if (t->Backend.GL.Velocity) {
+		glDeleteProgram(t->Backend.GL.Velocity);
+		glDeleteProgram(t->Backend.GL.Resolve);
+	}
+	if (t->Backend.GL.History[0]) {
+		glDeleteFramebuffers(2, t->Backend.GL.FBO);
+		glDeleteTextures(2, t->Backend.GL.History);
+	}
+	memset(&t->Backend, 0, sizeof(t->Backend));
+	t->Valid = false;
+
+	SkrPost* post = &s->Post;
+	for (unsigned int k = 0; k < M_SKR_POST_VARIANTS; ++k)
+		if (post->Backend.GL.Programs[k])
+			glDeleteProgram(post->Backend.GL.Programs[k]);
+	if (post->Backend.GL.VAO) {
+		glDeleteProgram(post->Backend.GL.Downsample);
+		glDeleteProgram(post->Backend.GL.Upsample);
+		glDeleteVertexArrays(1, &post->Backend.GL.VAO);
+	}
+	memset(&post->Backend, 0, sizeof(post->Backend));
+
+	SkrTransparency* tr = &s->Transparency;
+	if (tr->Backend.GL.Composite) {
+		glDeleteProgram(tr->Backend.GL.Composite);
+		glDeleteVertexArrays(1, &tr->Backend.GL.VAO);
+	}
+	memset(&tr->Backend, 0, sizeof(tr->Backend));
 
 	glBindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -1055,14 +10697,26 @@ static inline void m_skr_gl_renderer_finalize(SkrState* s) {
 	glUseProgram(0);
 }
 
-static inline void m_skr_renderer_finalize(SkrState* s) {
-	if (s->Backend.GL) {
-		m_skr_gl_renderer_finalize(s);
-
-		if (s->Window->Backend.Type == SKR_BACKEND_WINDOW_GLFW) {
-			glfwTerminate();
-		}
-	}
+/**
+ * @internal
+ * @brief GLFW release GL objects and terminate GLFW.
+ */
+static inline void m_skr_gl_glfw_finalize(SkrState* s) {
+	m_skr_gl_renderer_finalize(s);
+	if (s->Pacing.Fence)
+		glDeleteSync((GLsync)s->Pacing.Fence);
+	s->Pacing.Fence = NULL;
+	glfwTerminate();
+
+	skr_scene_free(&s->Scene);
+	skr_renderables_free(&s->Renderables);
+	skr_animations_free(&s->Animations);
+	skr_skinning_free(&s->Skinning);
+	skr_morphs_free(&s->Morphs);
+	skr_lights_free(&s->Lights);
+	skr_shadows_free(&s->Shadows);
+	skr_graph_free(&s->Graph);
+	skr_radix_free(&s->Transparency.Sort);
 
 	s->Models = NULL;
 	s->ModelCount = 0;
@@ -1075,7 +10729,7 @@ static inline void m_skr_renderer_finalize(SkrState* s) {
  */
 static inline int m_skr_gl_glfw_should_close(SkrState* s) {
 	if (glfwWindowShouldClose(s->Window->Backend.Handler.GLFW)) {
-		m_skr_renderer_finalize(s);
+		m_skr_gl_glfw_finalize(s);
 		return 1;
 	}
 
@@ -1084,22 +10738,128 @@ static inline int m_skr_gl_glfw_should_close(SkrState* s) {
 
 /**
  * @internal
- * @brief GLFW Render a frame with GLFW with OpenGL.
+ * @brief GLFW apply SkrPacing::Vsync if it changed.
+ */
+static inline void m_skr_gl_glfw_swap_interval(SkrPacing* p) {
+	int interval;
+
+	switch (p->Vsync) {
+	case SKR_VSYNC_OFF:
+		interval = 0;
+		break;
+	case SKR_VSYNC_ON:
+		interval = 1;
+		break;
+	case SKR_VSYNC_ADAPTIVE:
+		interval = 1;
+		if (glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+		    glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+			interval = -1;
+		break;
+	default:
+		return;
+	}
+
+	if (interval == p->Applied)
+		return;
+
+	glfwSwapInterval(interval);
+	p->Applied = interval;
+}
+
+/**
+ * @internal
+ * @brief GL wait until the GPU has finished the previous frame.
+ */
+static inline void m_skr_gl_pacing_wait(SkrPacing* p) {
+	p->FenceWaited = 0.0;
+
+	if (!p->Fence)
+		return;
+
+	const double start = skr_clock_now();
+
+	/* Flush so the fence is guaranteed to signal; 100 ms timeout. */
+	glClientWaitSync((GLsync)p->Fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+	                 100000000);
+	glDeleteSync((GLsync)p->Fence);
+	p->Fence = NULL;
+
+	p->FenceWaited = skr_clock_now() - start;
+}
+
+/**
+ * @internal
+ * @brief GLFW start a frame: pace it, then sample input and the framebuffer
+ * size.
  *
- * Calls input handler, polls events, renders, swaps buffers.
+ * In low-latency mode events are polled only after the previous frame has
+ * left the GPU, so the input handler and simulation see the freshest input.
+ * The size is read here, before the view is built, so the first frame after
+ * a resize already uses the new aspect.
  */
-static inline void m_skr_gl_glfw_renderer_render(SkrState* s) {
+static inline void m_skr_gl_glfw_frame_begin(SkrState* s) {
+	SkrPacing* p = &s->Pacing;
+
+	m_skr_gl_glfw_swap_interval(p);
+	skr_pacing_limit(p);
+
+	if (p->LowLatency) {
+		m_skr_gl_pacing_wait(p);
+		glfwPollEvents();
+	}
+
 	if (s->Window->InputHandler) {
 		s->Window->InputHandler(s->Window);
 	}
 
 	glfwGetFramebufferSize(s->Window->Backend.Handler.GLFW,
 	                       &s->Window->Width, &s->Window->Height);
+}
+
+/**
+ * @internal
+ * @brief GLFW read the cursor now and pass its motion to SkrState::Look.
+ *
+ * Reads the position the window system has right now rather than the last
+ * queued event, keeping mouse look as fresh as possible.
+ */
+static inline void m_skr_glfw_sample_cursor(SkrState* s) {
+	SkrInput* in = &s->Window->Input;
+	double    x, y;
+
+	if (!s->Look)
+		return;
+
+	glfwGetCursorPos(s->Window->Backend.Handler.GLFW, &x, &y);
+
+	if (in->Sampled)
+		s->Look(s, x - in->CursorX, y - in->CursorY);
+
+	in->CursorX = x;
+	in->CursorY = y;
+	in->Sampled = true;
+}
 
+/**
+ * @internal
+ * @brief GLFW Render a frame with GLFW with OpenGL.
+ *
+ * Renders, swaps buffers and polls events, unless in low-latency mode
+ * where a fence is queued instead and polling waits for it.
+ */
+static inline void m_skr_gl_glfw_renderer_render(SkrState* s) {
 	m_skr_gl_renderer_render(s);
 
 	glfwSwapBuffers(s->Window->Backend.Handler.GLFW);
 
+	if (s->Pacing.LowLatency) {
+		if (!s->Pacing.Fence)
+			s->Pacing.Fence = (void*)glFenceSync(
+			        GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		return;
+	}
+
 	glfwPollEvents();
 }
 
@@ -1110,10 +10870,11 @@ static inline void m_skr_gl_glfw_renderer_render(SkrState* s) {
  * @param path    Path to image file.
  * @param texture Output texture ID.
  *
- * @return 1 on success, 0 on failure.
+ * @return ::SKR_SUCCESS, or ::SKR_ERROR_TEXTURE if the image could not be
+ * loaded.
  */
-static inline int m_skr_gl_load_texture_2d_from_path(const char*   path,
-                                                     unsigned int* texture) {
+static inline SkrResult
+m_skr_gl_load_texture_2d_from_path(const char* path, unsigned int* texture) {
 	glGenTextures(1, texture);
 	glBindTexture(GL_TEXTURE_2D, *texture);
 
@@ -1127,8 +10888,9 @@ static inline int m_skr_gl_load_texture_2d_from_path(const char*   path,
 	unsigned char* data =
 	        m_skr_load_image_from_file(path, &width, &height, &nrChannels);
 	if (!data) {
-		m_skr_last_error_set("failed to load texture");
-		return 0;
+		m_skr_last_error_set(SKR_ERROR_TEXTURE,
+		                     "failed to load texture %s", path);
+		return SKR_ERROR_TEXTURE;
 	}
 
 	GLenum format = GL_RGB;
@@ -1146,25 +10908,27 @@ static inline int m_skr_gl_load_texture_2d_from_path(const char*   path,
 	m_skr_free_image(data);
 
 	m_skr_last_error_clear();
-	return 1;
+	return SKR_SUCCESS;
 }
 
 /**
  * @internal
  * @brief GL load multiple 2D textures from file paths.
+ *
+ * @return ::SKR_SUCCESS, or the code of the first texture that failed.
  */
-static inline int m_skr_gl_load_textures_2d_from_paths(const char**  paths,
-                                                       unsigned int* textures,
-                                                       const int     count) {
+static inline SkrResult
+m_skr_gl_load_textures_2d_from_paths(const char** paths, unsigned int* textures,
+                                     const int count) {
 	for (int i = 0; i < count; i++) {
-		if (!m_skr_gl_load_texture_2d_from_path(paths[i],
-		                                        &textures[i])) {
-			return 0;
-		}
+		const SkrResult res =
+		        m_skr_gl_load_texture_2d_from_path(paths[i], &textures[i]);
+		if (res != SKR_SUCCESS)
+			return res;
 	}
 
 	m_skr_last_error_clear();
-	return 1;
+	return SKR_SUCCESS;
 }
 
 /**
@@ -1175,46 +10939,47 @@ static inline void m_skr_free_textures_2d(unsigned int* textures,
                                           const int     count) {
 	if (count > 0 && textures) {
 		glDeleteTextures(count, textures);
-		m_skr_last_error_clear();
 	}
 }
 
-static inline int m_skr_window_init(SkrState* s, int backend) {
-	if (SKR_BACKEND_WINDOW == SKR_BACKEND_WINDOW_GLFW) {
-		if (backend == SKR_BACKEND_API_GL) {
-			s->Backend.GL = true;
-
-			if (!m_skr_gl_glfw_init(s->Window)) {
-				return 0;
-			}
-		}
-	}
-
-	return 1;
-}
-
-static inline SkrState SkrInit(SkrWindow* w, int backend) {
-	SkrState s = {0};
-	s.Window = w;
-
-	if (!m_skr_window_init(&s, backend))
-		return (SkrState){0};
-
-	return s;
-}
-
-static inline int SkrShouldClose(SkrState* s) {
-	if (SKR_BACKEND_WINDOW == SKR_BACKEND_WINDOW_GLFW) {
-		return m_skr_gl_glfw_should_close(s);
-	}
+/**
+ * @internal
+ * @brief GL upload the position-only stream of a mesh for depth passes.
+ */
+static inline void m_skr_gl_mesh_position_init(SkrMesh* m) {
+	vec3* positions =
+	        (vec3*)malloc((size_t)m->VertexCount * sizeof(vec3) + 1);
+	if (!positions)
+		return; /* Depth passes skip the mesh. */
+
+	for (int v = 0; v < m->VertexCount; ++v)
+		glm_vec3_copy(m->Vertices[v].Position, positions[v]);
+
+	glGenVertexArrays(1, &m->PositionVAO);
+	glGenBuffers(1, &m->PositionVBO);
+	glBindVertexArray(m->PositionVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, m->PositionVBO);
+	glBufferData(GL_ARRAY_BUFFER, m->VertexCount * sizeof(vec3),
+	             positions, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (void*)0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m->EBO);
+	glBindVertexArray(0);
 
-	return 0;
+	free(positions);
 }
 
-static inline void m_skr_gl_mesh_init(SkrMesh* m) {
+/**
+ * @internal
+ * @brief GL upload the vertices and indices of a mesh.
+ *
+ * @return ::SKR_SUCCESS, or ::SKR_ERROR_INVALID_ARGUMENT if `m` is NULL.
+ */
+static inline SkrResult m_skr_gl_mesh_init(SkrMesh* m) {
 	if (!m) {
-		m_skr_last_error_set("missing vertices or size");
-		return;
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "missing vertices or size");
+		return SKR_ERROR_INVALID_ARGUMENT;
 	}
 
 	glGenVertexArrays(1, &m->VAO);
@@ -1263,46 +11028,401 @@ static inline void m_skr_gl_mesh_init(SkrMesh* m) {
 	glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(SkrVertex),
 	                      (void*)offsetof(SkrVertex, Bitangent));
 
+	// bone ids, integer so indices are exact
+	glEnableVertexAttribArray(6);
+	glVertexAttribIPointer(6, MAX_BONE_INFLUENCE, GL_INT, sizeof(SkrVertex),
+	                       (void*)offsetof(SkrVertex, BoneIDs));
+
+	// bone weights
+	glEnableVertexAttribArray(7);
+	glVertexAttribPointer(7, MAX_BONE_INFLUENCE, GL_FLOAT, GL_FALSE,
+	                      sizeof(SkrVertex),
+	                      (void*)offsetof(SkrVertex, BoneWeights));
+
 	// glBindVertexArray(0);
 	// glUseProgram(m->Program->Backend.GL.ID);
 
+	m_skr_gl_mesh_position_init(m);
+
 	m_skr_last_error_clear();
+	return SKR_SUCCESS;
+}
+
+/**
+ * @internal
+ * @brief GL upload a mesh and cache its program's uniform locations.
+ *
+ * Meshes and programs may be shared, each is only set up once.
+ *
+ * @return ::SKR_SUCCESS, or the code of the failed mesh upload.
+ */
+static inline SkrResult
+m_skr_gl_mesh_program_init(SkrMesh* mesh, SkrShaderProgram* program) {
+	if (mesh->VAO == 0) {
+		const SkrResult res = m_skr_gl_mesh_init(mesh);
+		if (res != SKR_SUCCESS)
+			return res;
+	}
+
+	if (program)
+		m_skr_gl_program_init(program);
+
+	return SKR_SUCCESS;
+}
+
+/**
+ * @internal
+ * @brief GL set up reverse-Z depth and the `SkrFrame` uniform buffer.
+ *
+ * Only done when there is a camera: scenes without one draw in clip space
+ * directly and keep the default depth convention.
+ */
+static inline void m_skr_gl_view_init(SkrState* s) {
+	SkrView* v = &s->View;
+
+	if (!s->Camera)
+		return;
+
+	if (m_skr_gl_has_version(4, 5) ||
+	    m_skr_gl_has_extension("GL_ARB_clip_control")) {
+		glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+		glClearDepth(0.0);
+		glDepthFunc(GL_GREATER);
+		v->ReverseZ = true;
+	}
+	v->Valid = false;
+
+	glGenBuffers(1, &v->Backend.GL.Buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, v->Backend.GL.Buffer);
+	glBufferData(GL_UNIFORM_BUFFER, 3 * sizeof(mat4) + sizeof(vec4), NULL,
+	             GL_DYNAMIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, SKR_FRAME_BINDING,
+	                 v->Backend.GL.Buffer);
+	v->Backend.GL.Version = 0;
 }
 
-static inline void m_skr_gl_renderer_init(SkrState* s) {
+/**
+ * @internal
+ * @brief GL enable global state and upload every mesh in the scene.
+ *
+ * @return ::SKR_SUCCESS, or the code of the first upload that failed.
+ */
+static inline SkrResult m_skr_gl_renderer_init(SkrState* s) {
+	SkrResult res;
+
+	m_skr_gl_debug_init(s);
+
 	glEnable(GL_DEPTH_TEST);
+	m_skr_gl_view_init(s);
+	m_skr_gl_skin_prepass_init(&s->Skinning);
 
-	for (int i = 0; i < s->ModelCount; i++) {
+	for (unsigned int i = 0; i < s->ModelCount; i++) {
 		SkrModel* model = &s->Models[i];
-		for (int j = 0; j < model->MeshCount; j++) {
-			SkrMesh* mesh = &model->Meshes[j];
-			m_skr_gl_mesh_init(mesh);
+		for (unsigned int j = 0; j < model->MeshCount; j++) {
+			res = m_skr_gl_mesh_program_init(
+			        &model->Meshes[j], model->Meshes[j].Program);
+			if (res != SKR_SUCCESS)
+				return res;
 		}
 	}
+
+	const SkrRenderables* r = &s->Renderables;
+	for (unsigned int i = 0; i < r->Count; i++) {
+		res = m_skr_gl_mesh_program_init(r->Mesh[i],
+		                                 r->Material[i]->Program);
+		if (res != SKR_SUCCESS)
+			return res;
+	}
+
+	return SKR_SUCCESS;
 }
 
-static inline void m_skr_renderer_init(SkrState* s) {
-	if (!s)
-		return;
+/*
+ * Backend selection.
+ *
+ * By default the API/window pair is fixed at compile time by SKR_BACKEND_API
+ * and SKR_BACKEND_WINDOW, and the m_skr_backend_* names below resolve to
+ * direct calls that the compiler can inline into the frame loop.
+ *
+ * Defining SKR_BACKEND_MULTI instead compiles every available pair into
+ * m_skr_backends, SkrInit picks one from its `backend` argument and the
+ * window's backend type, and each frame makes a single indirect call through
+ * SkrState::Dispatch.
+ */
+
+#if SKR_BACKEND_API == 0 && SKR_BACKEND_WINDOW == 0
+#define M_SKR_BACKEND_GL_GLFW
+#endif
+
+#ifdef SKR_BACKEND_MULTI
+
+/**
+ * @internal
+ * @brief Available backends, indexed by [SkrAPIBackendType][SkrWindowBackendType].
+ */
+static const SkrBackend m_skr_backends[2][2] = {
+        [SKR_BACKEND_API_GL][SKR_BACKEND_WINDOW_GLFW] =
+                {
+                        .WindowInit = m_skr_gl_glfw_init,
+                        .RendererInit = m_skr_gl_renderer_init,
+                        .FrameBegin = m_skr_gl_glfw_frame_begin,
+                        .SampleCursor = m_skr_glfw_sample_cursor,
+                        .Render = m_skr_gl_glfw_renderer_render,
+                        .ShouldClose = m_skr_gl_glfw_should_close,
+                        .Finalize = m_skr_gl_glfw_finalize,
+                },
+};
+
+#define m_skr_backend_window_init(s)   ((s)->Dispatch->WindowInit((s)->Window))
+#define m_skr_backend_renderer_init(s) ((s)->Dispatch->RendererInit(s))
+#define m_skr_backend_frame_begin(s)   ((s)->Dispatch->FrameBegin(s))
+#define m_skr_backend_sample_cursor(s) ((s)->Dispatch->SampleCursor(s))
+#define m_skr_backend_render(s)        ((s)->Dispatch->Render(s))
+#define m_skr_backend_should_close(s)  ((s)->Dispatch->ShouldClose(s))
+
+#elif defined(M_SKR_BACKEND_GL_GLFW)
+
+#define m_skr_backend_window_init(s)   m_skr_gl_glfw_init((s)->Window)
+#define m_skr_backend_renderer_init(s) m_skr_gl_renderer_init(s)
+#define m_skr_backend_frame_begin(s)   m_skr_gl_glfw_frame_begin(s)
+#define m_skr_backend_sample_cursor(s) m_skr_glfw_sample_cursor(s)
+#define m_skr_backend_render(s)        m_skr_gl_glfw_renderer_render(s)
+#define m_skr_backend_should_close(s)  m_skr_gl_glfw_should_close(s)
+
+#else
+#error "SKR: unsupported SKR_BACKEND_API / SKR_BACKEND_WINDOW combination"
+#endif
+
+/**
+ * @internal
+ * @brief Resolve the backend for `backend` and create the window.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static inline int m_skr_window_init(SkrState* s, int backend) {
+#ifdef SKR_BACKEND_MULTI
+	const SkrWindowBackendType window = s->Window->Backend.Type;
+
+	if ((unsigned int)window > SKR_BACKEND_WINDOW_SDL) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "window backend %d out of range", (int)window);
+		return 0;
+	}
+
+	if (backend < 0 || backend > SKR_BACKEND_API_VK ||
+	    !m_skr_backends[backend][window].WindowInit) {
+		m_skr_last_error_set(SKR_ERROR_BACKEND,
+		                     "backend %d not compiled in", backend);
+		return 0;
+	}
+
+	s->Dispatch = &m_skr_backends[backend][window];
+#else
+	if (backend != SKR_BACKEND_API) {
+		m_skr_last_error_set(SKR_ERROR_BACKEND,
+		                     "backend %d != SKR_BACKEND_API", backend);
+		return 0;
+	}
+#endif
+
+	s->Backend.GL = backend == SKR_BACKEND_API_GL;
+
+	return m_skr_backend_window_init(s);
+}
+
+/**
+ * @brief Create the window and graphics context.
+ *
+ * @param w       Window description (must not be NULL).
+ * @param backend Graphics API, one of @ref SkrAPIBackendType.
+ *
+ * @return Engine state, zeroed on failure.
+ */
+SKR_API SkrState SkrInit(SkrWindow* w, int backend) {
+	SkrState s = {0};
+	s.Window = w;
+	s.Pacing.Applied = -2;
+
+	SkrClearError();
+
+	if (!w || !m_skr_window_init(&s, backend))
+		return (SkrState){0};
+
+	return s;
+}
+
+/**
+ * @brief Upload the scene and set up the renderer.
+ *
+ * Must be called once after ::SkrInit, after the GL loader has been
+ * initialized and the scene (e.g. ::SkrTriangle) has been populated, and
+ * before the first ::SkrRendererRender.
+ *
+ * @return 1 on success, 0 on failure, like the rest of the public API. The
+ * ::SkrResult of the failure is left in ::SkrLastError.
+ */
+SKR_API int SkrRendererInit(SkrState* s) {
+	if (!s || !s->Window) {
+		m_skr_last_error_set(SKR_ERROR_INVALID_ARGUMENT,
+		                     "state is not initialized");
+		return 0;
+	}
+
+	return m_skr_backend_renderer_init(s) == SKR_SUCCESS;
+}
+
+/**
+ * @brief Check whether the window was asked to close.
+ *
+ * Releases the renderer and window when it returns nonzero.
+ */
+SKR_API int SkrShouldClose(SkrState* s) {
+	return m_skr_backend_should_close(s);
+}
 
-	if (s->Backend.GL)
-		m_skr_gl_renderer_init(s);
+/**
+ * @internal
+ * @brief Hand queued input events received up to `until` to the handler.
+ */
+static inline void m_skr_input_drain(SkrState* s, const double until) {
+	SkrInputEvent e;
+
+	while (skr_input_pop(&s->Window->Input, until, &e))
+		if (s->Event)
+			s->Event(s, &e);
 }
 
-static inline void SkrRendererRender(SkrState* s) {
-	if (!s || !s->Window)
+/**
+ * @internal
+ * @brief Run the fixed simulation steps due this frame and interpolate.
+ *
+ * Without an update handler nothing is simulated and the scene and camera
+ * are rendered as they are.
+ */
+static inline void m_skr_simulate(SkrState* s) {
+	SkrTime* t = &s->Time;
+
+	m_skr_time_frame_begin(t);
+
+	if (!s->Update) {
+		m_skr_input_drain(s, t->Now);
+		m_skr_backend_sample_cursor(s);
+
+		s->Scene.Interpolate = false;
+		t->Accumulator = 0.0;
+		t->Alpha = 1.0f;
+		if (s->Camera) {
+			s->CameraPrevious = s->CameraView = *s->Camera;
+			s->CameraSource = s->Camera;
+		}
+		return;
+	}
+
+	s->Scene.Interpolate = true;
+
+	while (t->Accumulator >= t->Step) {
+		if (t->Frames == t->MaxSteps) {
+			/* Can't keep up: drop time rather than spiral. */
+			t->Accumulator = 0.0;
+			break;
+		}
+
+		skr_scene_step_begin(&s->Scene);
+		if (s->Camera) {
+			s->CameraPrevious = *s->Camera;
+			s->CameraSource = s->Camera;
+		}
+
+		/* Simulated time lags real time by what is left to simulate. */
+		m_skr_input_drain(s, t->Now - t->Accumulator + t->Step);
+		s->Update(s, t->Step);
+
+		t->Accumulator -= t->Step;
+		t->Steps++;
+		t->Frames++;
+	}
+
+	t->Alpha = (float)(t->Accumulator / t->Step);
+
+	m_skr_backend_sample_cursor(s);
+
+	skr_scene_interpolate(&s->Scene, t->Alpha);
+	if (!s->Camera)
 		return;
 
-	if (!m_skr_renderer_initialized) {
-		m_skr_gl_renderer_init(s);
-		m_skr_renderer_initialized = true;
+	/* Nothing to blend from yet: hold the camera where it is. */
+	if (!t->Steps || s->CameraSource != s->Camera) {
+		s->CameraPrevious = *s->Camera;
+		s->CameraSource = s->Camera;
+	}
+
+	m_skr_camera_interpolate(&s->CameraPrevious, s->Camera, t->Alpha,
+	                         &s->CameraView);
+	if (s->Look) {
+		glm_vec3_copy(s->Camera->Front, s->CameraView.Front);
+		glm_vec3_copy(s->Camera->Up, s->CameraView.Up);
+		glm_vec3_copy(s->Camera->Right, s->CameraView.Right);
+		s->CameraView.Yaw = s->Camera->Yaw;
+		s->CameraView.Pitch = s->Camera->Pitch;
 	}
+}
 
-	if (SKR_BACKEND_WINDOW == SKR_BACKEND_WINDOW_GLFW) {
-		if (s->Backend.GL) {
-			m_skr_gl_glfw_renderer_render(s);
+/**
+ * @brief Render one frame.
+ *
+ * `s` must have gone through ::SkrRendererInit; no checks are made here.
+ */
+SKR_API void SkrRendererRender(SkrState* s) {
+	m_skr_backend_frame_begin(s);
+	m_skr_simulate(s);
+	skr_scene_update(&s->Scene);
+
+	const vec4* planes = NULL;
+	if (s->Camera) {
+		const float aspect = s->Window->Height > 0
+		                             ? (float)s->Window->Width /
+		                                       (float)s->Window->Height
+		                             : 1.0f;
+		if (s->Temporal.Enabled) {
+			skr_temporal_jitter(&s->Temporal, &s->View,
+			                    s->Resolution.Width,
+			                    s->Resolution.Height);
+		} else if (s->Temporal.Valid) {
+			/* Switched off: drop the jitter and the history. */
+			s->View.Jitter[0] = s->View.Jitter[1] = 0.0f;
+			s->View.Valid = false;
+			s->Temporal.Valid = false;
 		}
+		skr_view_update(&s->View, &s->CameraView, aspect);
+		planes = (const vec4*)s->View.Planes;
+
+		/* Lights move freely, so they are binned every frame. */
+		if (s->Lights.Count || s->Lights.IndexCount)
+			skr_lights_bin(&s->Lights, &s->View);
 	}
+
+	skr_renderables_update_bounds(&s->Renderables, &s->Scene);
+	if (s->Camera)
+		skr_shadows_update(&s->Shadows, &s->View, &s->Renderables);
+	if (s->Animations.Count)
+		skr_animations_update(&s->Animations, &s->Skinning,
+		                      s->Camera ? &s->View : NULL,
+		                      &s->Renderables, (float)s->Time.Delta);
+	skr_renderables_cull(&s->Renderables, planes);
+	skr_renderables_sort(&s->Renderables);
+	if (s->Camera)
+		skr_renderables_cull_clusters(&s->Renderables, &s->Scene,
+		                              &s->View);
+	if (s->Camera && s->Transparency.Mode == SKR_TRANSPARENCY_SORTED)
+		skr_renderables_sort_transparent(&s->Renderables, &s->View,
+		                                 &s->Transparency.Sort,
+		                                 s->Jobs);
+	skr_morphs_update(&s->Morphs);
+
+	m_skr_backend_render(s);
+	if (s->Camera && s->Temporal.Enabled)
+		skr_temporal_store(&s->Temporal, &s->View, &s->Renderables,
+		                   &s->Scene);
 }
 
 static inline void m_skr_gl_triangle(SkrState* s) {
@@ -1357,16 +11477,48 @@ static inline void m_skr_gl_triangle(SkrState* s) {
 	s->ModelCount = 1;
 }
 
-static inline void SkrTriangle(SkrState* s) {
+SKR_API void SkrTriangle(SkrState* s) {
 	if (s->Backend.GL) {
 		m_skr_gl_triangle(s);
 	}
 }
 
-static inline void SkrCaptureCursor(SkrState* s) {
+SKR_API void SkrCaptureCursor(SkrState* s) {
 	if (s->Window->Backend.Type == SKR_BACKEND_WINDOW_GLFW) {
 		glfwSetInputMode(s->Window->Backend.Handler.GLFW, GLFW_CURSOR,
 		                 GLFW_CURSOR_DISABLED);
+
+		if (s->Window->Input.RawMotion && glfwRawMouseMotionSupported())
+			glfwSetInputMode(s->Window->Backend.Handler.GLFW,
+			                 GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+
+		/* The cursor jumps when captured, don't report it as motion. */
+		s->Window->Input.Sampled = false;
+	}
+}
+
+/**
+ * @brief Rescale each vertex's bone weights to sum to 1.
+ *
+ * Vertices without weights are left rigid. Call before the mesh is
+ * uploaded.
+ */
+SKR_API void skr_mesh_normalize_weights(SkrMesh* mesh) {
+	if (!mesh || !mesh->Vertices)
+		return;
+
+	for (int v = 0; v < mesh->VertexCount; ++v) {
+		float* w = mesh->Vertices[v].BoneWeights;
+		float  sum = 0.0f;
+
+		for (int i = 0; i < MAX_BONE_INFLUENCE; ++i)
+			sum += w[i] > 0.0f ? w[i] : (w[i] = 0.0f);
+
+		if (sum <= 0.0f)
+			continue;
+
+		for (int i = 0; i < MAX_BONE_INFLUENCE; ++i)
+			w[i] /= sum;
 	}
 }
 
@@ -1378,9 +11530,9 @@ static inline void SkrCaptureCursor(SkrState* s) {
  * @param count Number of vertices to append.
  * @return int 0 on success, nonzero on allocation failure.
  */
-static inline int m_skr_mesh_append_vertices(SkrMesh*         mesh,
-                                             const SkrVertex* vertices,
-                                             const int        count) {
+SKR_API int m_skr_mesh_append_vertices(SkrMesh*         mesh,
+                                       const SkrVertex* vertices,
+                                       const int        count) {
 	if (!mesh || !vertices || count <= 0)
 		return 0;
 
@@ -1388,7 +11540,8 @@ static inline int m_skr_mesh_append_vertices(SkrMesh*         mesh,
 	SkrVertex* new_vertices =
 	        realloc(mesh->Vertices, new_count * sizeof(SkrVertex));
 	if (!new_vertices) {
-		m_skr_last_error_set("failed to realloc mesh vertices");
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to realloc mesh vertices");
 		return 0;
 	}
 
@@ -1407,14 +11560,15 @@ static inline int m_skr_mesh_append_vertices(SkrMesh*         mesh,
  * @param mesh Pointer to the mesh to append (copied by value).
  * @return int 0 on success, nonzero on allocation failure.
  */
-static inline int skr_model_append_mesh(SkrModel* model, const SkrMesh* mesh) {
+SKR_API int skr_model_append_mesh(SkrModel* model, const SkrMesh* mesh) {
 	if (!model || !mesh)
 		return 0;
 
 	SkrMesh* new_meshes = realloc(model->Meshes,
 	                              (model->MeshCount + 1) * sizeof(SkrMesh));
 	if (!new_meshes) {
-		m_skr_last_error_set("failed to realloc model meshes");
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to realloc model meshes");
 		return 0;
 	}
 
@@ -1431,15 +11585,16 @@ static inline int skr_model_append_mesh(SkrModel* model, const SkrMesh* mesh) {
  * @param model Pointer to the model to append (copied by value).
  * @return int 0 on success, nonzero on allocation failure.
  */
-static inline int skr_state_append_model(SkrState*       state,
-                                         const SkrModel* model) {
+SKR_API int skr_state_append_model(SkrState*       state,
+                                   const SkrModel* model) {
 	if (!state || !model)
 		return -1;
 
 	SkrModel* new_models = realloc(state->Models, (state->ModelCount + 1) *
 	                                                      sizeof(SkrModel));
 	if (!new_models) {
-		m_skr_last_error_set("failed to realloc state models");
+		m_skr_last_error_set(SKR_ERROR_OUT_OF_MEMORY,
+		                     "failed to realloc state models");
 		return 0;
 	}
 
@@ -1449,6 +11604,8 @@ static inline int skr_state_append_model(SkrState*       state,
 	return 1;
 }
 
+#endif /* M_SKR_DEFINE_IMPL */
+
 #ifdef __cplusplus
 }
 #endif
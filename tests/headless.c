@@ -0,0 +1,1162 @@
+/*
+ * Tests that need neither a display nor a GL context.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#define SKR_BACKEND_API 0    // using opengl
+#define SKR_BACKEND_WINDOW 0 // using glfw
+#include "../skr/skr.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                            \
+	do {                                                                   \
+		if (!(cond)) {                                                 \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, \
+			        __LINE__, #cond);                              \
+			failures++;                                            \
+		}                                                              \
+	} while (0)
+
+static void test_mesh_append_vertices(void) {
+	SkrMesh         mesh = {0};
+	const SkrVertex vertices[] = {
+	        {.Position = {0.0f, 0.0f, 0.0f}},
+	        {.Position = {1.0f, 0.0f, 0.0f}},
+	        {.Position = {0.0f, 1.0f, 0.0f}},
+	};
+
+	CHECK(m_skr_mesh_append_vertices(&mesh, vertices, 3));
+	CHECK(m_skr_mesh_append_vertices(&mesh, vertices, 2));
+	CHECK(mesh.VertexCount == 5);
+	CHECK(mesh.Vertices[4].Position[0] == 1.0f);
+	CHECK(!m_skr_mesh_append_vertices(&mesh, NULL, 1));
+
+	free(mesh.Vertices);
+}
+
+static void test_state_append_model(void) {
+	SkrState state = {0};
+	SkrModel model = {0};
+	SkrMesh  mesh = {.VertexCount = 3};
+
+	CHECK(skr_model_append_mesh(&model, &mesh));
+	CHECK(model.MeshCount == 1);
+	CHECK(model.Meshes[0].VertexCount == 3);
+
+	for (int i = 0; i < 16; ++i)
+		CHECK(skr_state_append_model(&state, &model));
+	CHECK(state.ModelCount == 16);
+	CHECK(state.Models[15].Meshes == model.Meshes);
+
+	free(state.Models);
+	free(model.Meshes);
+}
+
+static void* other_thread_error(void* arg) {
+	*(SkrResult*)arg = SkrLastError();
+	return NULL;
+}
+
+static void test_last_error(void) {
+	SkrClearError();
+	CHECK(SKR_OK);
+	CHECK(SKR_LAST_ERROR[0] == '\0');
+
+	CHECK(!SkrRendererInit(NULL));
+	CHECK(!SKR_OK);
+	CHECK(SkrLastError() == SKR_ERROR_INVALID_ARGUMENT);
+	CHECK(strstr(SKR_LAST_ERROR, "invalid argument") != NULL);
+	CHECK(strstr(SKR_LAST_ERROR, "SkrRendererInit") != NULL);
+	CHECK(strstr(SKR_LAST_ERROR, ": state is not initialized") != NULL);
+
+	/* Errors are per thread. */
+	SkrResult other = SKR_ERROR_IO;
+	pthread_t thread;
+	CHECK(pthread_create(&thread, NULL, other_thread_error, &other) == 0);
+	pthread_join(thread, NULL);
+	CHECK(other == SKR_SUCCESS);
+	CHECK(SkrLastError() == SKR_ERROR_INVALID_ARGUMENT);
+
+	SkrClearError();
+	CHECK(SKR_OK);
+}
+
+static unsigned int debug_logged[SKR_DEBUG_SLOTS + 1];
+
+static void debug_count(SkrDebugCategory category, unsigned int id,
+                        const char* message) {
+	(void)category;
+	(void)message;
+	debug_logged[id]++;
+}
+
+static void debug_frame(SkrState* s, unsigned int id, int repeats) {
+	skr_debug_frame_begin(s);
+	for (int i = 0; i < repeats; ++i)
+		skr_debug_report(s, SKR_DEBUG_PERFORMANCE, id, "slow");
+}
+
+static void test_debug(void) {
+	static SkrState s;
+	s.Debug.Mask = ~0u;
+	s.Debug.Handler = debug_count;
+
+	/* Repeats are capped within a window and logged again after it. */
+	debug_frame(&s, 0, SKR_DEBUG_MAX_REPEATS + 2);
+	CHECK(debug_logged[0] == SKR_DEBUG_MAX_REPEATS);
+	CHECK(s.Stats.Suppressed == 2);
+	while (s.Stats.Frame + 1 < SKR_DEBUG_REPEAT_FRAMES)
+		debug_frame(&s, 0, 1);
+	CHECK(debug_logged[0] == SKR_DEBUG_MAX_REPEATS);
+	debug_frame(&s, 0, 1);
+	CHECK(debug_logged[0] == SKR_DEBUG_MAX_REPEATS + 1);
+
+	/* A full table leaves every tracked ID its own count. */
+	for (unsigned int id = 1; id < SKR_DEBUG_SLOTS; ++id)
+		debug_frame(&s, id, 1);
+	debug_frame(&s, SKR_DEBUG_SLOTS, SKR_DEBUG_MAX_REPEATS + 2);
+	CHECK(debug_logged[SKR_DEBUG_SLOTS] == SKR_DEBUG_MAX_REPEATS + 2);
+	debug_frame(&s, 0, SKR_DEBUG_MAX_REPEATS);
+	CHECK(debug_logged[0] == 2 * SKR_DEBUG_MAX_REPEATS);
+	for (unsigned int id = 1; id < SKR_DEBUG_SLOTS; ++id)
+		CHECK(debug_logged[id] == 1);
+}
+
+static void test_pacing(void) {
+	SkrPacing p = {.TargetFPS = 200.0};
+
+	/* The first frame starts the schedule, the next ones are held. */
+	skr_pacing_limit(&p);
+	const double start = skr_clock_now();
+	skr_pacing_limit(&p);
+	skr_pacing_limit(&p);
+	CHECK(skr_clock_now() - start >= 0.009);
+	CHECK(p.Waited > 0.0);
+	CHECK(!p.Spinning);
+
+	/* A deadline far ahead, as after a clock step back, is not waited on. */
+	p.Deadline = skr_clock_now() + 100.0;
+	skr_pacing_limit(&p);
+	CHECK(p.Waited < 1.0);
+}
+
+#define INPUT_EVENTS 100000
+
+static void* input_producer(void* arg) {
+	SkrInput* in = arg;
+
+	for (int i = 0; i < INPUT_EVENTS;) {
+		const SkrInputEvent e = {.Type = SKR_INPUT_KEY, .Code = i};
+		if (skr_input_push(in, &e))
+			++i;
+	}
+
+	return NULL;
+}
+
+static void test_input(void) {
+	static SkrInput in;
+	SkrInputEvent   e;
+
+	/* Events newer than `until` stay queued. */
+	CHECK(skr_input_push(&in, &(SkrInputEvent){.Time = 2.0}));
+	CHECK(!skr_input_pop(&in, 1.0, &e));
+	CHECK(skr_input_pop(&in, 2.0, &e) && e.Time == 2.0);
+	CHECK(!skr_input_pop(&in, 2.0, &e));
+
+	for (int i = 0; i < SKR_INPUT_CAPACITY; ++i)
+		CHECK(skr_input_push(&in, &(SkrInputEvent){0}));
+	CHECK(!skr_input_push(&in, &(SkrInputEvent){0}));
+	CHECK(in.Dropped == 1);
+	while (skr_input_pop(&in, 0.0, &e))
+		;
+
+	/* One producer and one consumer see every event in order. */
+	pthread_t thread;
+	int       next = 0;
+	CHECK(pthread_create(&thread, NULL, input_producer, &in) == 0);
+	while (next < INPUT_EVENTS) {
+		if (!skr_input_pop(&in, 0.0, &e))
+			continue;
+		if (e.Code != next)
+			break;
+		++next;
+	}
+	pthread_join(thread, NULL);
+	CHECK(next == INPUT_EVENTS);
+}
+
+static int view_sees(const SkrView* view, float x, float y, float z) {
+	for (int p = 0; p < 6; ++p) {
+		const float* pl = view->Planes[p];
+		if (pl[0] * x + pl[1] * y + pl[2] * z + pl[3] < 0.0f)
+			return 0;
+	}
+	return 1;
+}
+
+static void test_view(void) {
+	SkrCamera camera = *SkrDefaultFPSCamera;
+	SkrView   view = {.ReverseZ = true};
+
+	skr_camera_rotate(&camera, 0.0f, 0.0f);
+	CHECK(fabsf(camera.Front[2] + 1.0f) < 1e-5f);
+	CHECK(fabsf(camera.Right[0] - 1.0f) < 1e-5f);
+
+	CHECK(skr_view_update(&view, &camera, 1.0f));
+	CHECK(!skr_view_update(&view, &camera, 1.0f));
+	CHECK(view.Version == 1);
+
+	/* Reverse-Z: depth 1 at the near plane, towards 0 far away. */
+	vec4 clip;
+	glm_mat4_mulv(view.ViewProjection, (vec4){0.0f, 0.0f, 2.9f, 1.0f},
+	              clip);
+	CHECK(fabsf(clip[2] / clip[3] - 1.0f) < 1e-4f);
+	glm_mat4_mulv(view.ViewProjection, (vec4){0.0f, 0.0f, -1e6f, 1.0f},
+	              clip);
+	CHECK(clip[2] / clip[3] > 0.0f && clip[2] / clip[3] < 1e-6f);
+
+	CHECK(view_sees(&view, 0.0f, 0.0f, -1000.0f));
+	CHECK(!view_sees(&view, 0.0f, 0.0f, 4.0f));
+	CHECK(!view_sees(&view, 100.0f, 0.0f, -10.0f));
+
+	camera.Position[0] = 1.0f;
+	CHECK(skr_view_update(&view, &camera, 1.0f));
+	CHECK(skr_view_update(&view, &camera, 2.0f));
+	CHECK(view.Version == 3);
+}
+
+static bool cluster_has(const SkrLights* l, unsigned int cluster,
+                        unsigned int light) {
+	const unsigned int* cell = &l->Grid[cluster * 2];
+	for (unsigned int i = cell[0]; i < cell[0] + cell[1]; ++i)
+		if (l->Indices[i] == light)
+			return true;
+	return false;
+}
+
+static void test_lights(void) {
+	SkrCamera camera = *SkrDefaultFPSCamera;
+	SkrView   view = {0};
+	SkrLights lights = {0};
+
+	skr_camera_rotate(&camera, 0.0f, 0.0f);
+	skr_view_update(&view, &camera, 16.0f / 9.0f);
+
+	const vec3 white = {1.0f, 1.0f, 1.0f};
+	const int  ahead = skr_lights_add(&lights, (vec3){0, 0, -7}, 1.0f,
+	                                  white, 1.0f);
+	skr_lights_add(&lights, (vec3){0, 0, 10}, 1.0f, white, 1.0f);
+	skr_lights_add(&lights, (vec3){100, 0, -7}, 1.0f, white, 1.0f);
+	CHECK(ahead == 0 && lights.Count == 3);
+	CHECK(skr_lights_add(&lights, (vec3){0}, 0.0f, white, 1.0f) == -1);
+	SkrClearError();
+
+	CHECK(skr_lights_bin(&lights, &view));
+
+	/* The light ahead reaches the cluster around its center and a few
+	 * neighbours; the ones behind and beside reach none. */
+	const unsigned int slice =
+	        (unsigned int)(logf(10.0f / lights.Near) * lights.Scale);
+	const unsigned int center =
+	        (slice * SKR_CLUSTER_Y + SKR_CLUSTER_Y / 2) * SKR_CLUSTER_X +
+	        SKR_CLUSTER_X / 2;
+	CHECK(cluster_has(&lights, center, 0));
+	CHECK(!cluster_has(&lights, 0, 0));
+	CHECK(lights.IndexCount > 0 && lights.IndexCount < 64);
+
+	unsigned int next = 0;
+	for (unsigned int c = 0; c < SKR_CLUSTERS; ++c) {
+		CHECK(lights.Grid[c * 2] == next);
+		next += lights.Grid[c * 2 + 1];
+		CHECK(!cluster_has(&lights, c, 1));
+		CHECK(!cluster_has(&lights, c, 2));
+	}
+	CHECK(next == lights.IndexCount);
+
+	/* A light around the camera reaches every cluster. */
+	const unsigned int before = lights.IndexCount;
+	skr_lights_add(&lights, (vec3){0, 0, 3}, 1e4f, white, 1.0f);
+	CHECK(skr_lights_bin(&lights, &view));
+	CHECK(lights.IndexCount == before + SKR_CLUSTERS);
+	CHECK(cluster_has(&lights, SKR_CLUSTERS - 1, 3));
+
+	skr_lights_remove(&lights, 0);
+	CHECK(lights.Count == 3 && lights.Points[0].Position[3] == 1e4f);
+
+	skr_lights_free(&lights);
+	CHECK(lights.Points == NULL && lights.Grid == NULL);
+}
+
+static void test_shadows(void) {
+	SkrCamera      camera = *SkrDefaultFPSCamera;
+	SkrView        view = {0};
+	SkrRenderables r = {0};
+	SkrMesh        mesh = {.VertexCount = 3};
+	SkrMaterial    material = {0};
+	SkrShadows     sh = {.Direction = {0.3f, -1.0f, 0.2f}};
+
+	skr_camera_rotate(&camera, 0.0f, 0.0f);
+	skr_view_update(&view, &camera, 16.0f / 9.0f);
+
+	const unsigned int cast =
+	        SKR_RENDERABLE_VISIBLE | SKR_RENDERABLE_CAST_SHADOW;
+	skr_renderables_add(&r, 0, &mesh, &material, (vec4){0, 0, -2, 1},
+	                    cast);
+	skr_renderables_add(&r, 0, &mesh, &material, (vec4){0, 0, -40, 5},
+	                    cast | SKR_RENDERABLE_STATIC);
+	skr_renderables_add(&r, 0, &mesh, &material, (vec4){0, 0, -2, 1},
+	                    SKR_RENDERABLE_VISIBLE);
+
+	CHECK(skr_shadows_update(&sh, &view, &r));
+	CHECK(sh.Count == SKR_CASCADES);
+	CHECK(fabsf(sh.Cascades[SKR_CASCADES - 1].Far - 100.0f) < 1e-3f);
+	for (unsigned int c = 1; c < SKR_CASCADES; ++c)
+		CHECK(sh.Cascades[c].Far > sh.Cascades[c - 1].Far);
+
+	/* Near cascades take every caster in reach, cached ones statics. */
+	CHECK(!sh.Cascades[0].Cached && sh.Cascades[SKR_CASCADES - 1].Cached);
+	CHECK(sh.Cascades[0].CasterCount >= 1 &&
+	      sh.Cascades[0].Casters[0] == 0);
+	CHECK(sh.Cascades[SKR_CASCADES - 1].CasterCount == 1);
+	for (unsigned int c = 0; c < SKR_CASCADES; ++c)
+		for (unsigned int j = 0; j < sh.Cascades[c].CasterCount; ++j)
+			CHECK(sh.Cascades[c].Casters[j] != 2 &&
+			      (!sh.Cascades[c].Cached ||
+			       sh.Cascades[c].Casters[j] == 1));
+
+	/* Cached cascades stay put until the camera leaves the margin. */
+	const float radius = sh.Cascades[0].Radius;
+	camera.Position[0] += 0.01f;
+	skr_camera_rotate(&camera, 30.0f, 0.0f);
+	skr_view_update(&view, &camera, 16.0f / 9.0f);
+	CHECK(skr_shadows_update(&sh, &view, &r));
+	CHECK(sh.Cascades[0].Dirty && sh.Cascades[0].Radius == radius);
+
+	CHECK(skr_shadows_update(&sh, &view, &r));
+	CHECK(!sh.Cascades[SKR_CASCADES - 1].Dirty);
+
+	skr_shadows_invalidate(&sh);
+	CHECK(skr_shadows_update(&sh, &view, &r));
+	CHECK(sh.Cascades[SKR_CASCADES - 1].Dirty);
+
+	sh.Direction[0] = -0.3f;
+	CHECK(skr_shadows_update(&sh, &view, &r));
+	CHECK(sh.Cascades[SKR_CASCADES - 1].Dirty);
+
+	skr_shadows_free(&sh);
+	CHECK(sh.Cascades[0].Casters == NULL && sh.Direction[1] == -1.0f);
+	skr_renderables_free(&r);
+}
+
+static void noop_pass(SkrState* s, const SkrGraph* g, void* user) {
+	(void)s;
+	(void)g;
+	(void)user;
+}
+
+static void test_graph(void) {
+	SkrGraph g = {0};
+
+	const int out = skr_graph_import(&g, "target");
+	const int a = skr_graph_create(&g, "a", SKR_FORMAT_RGBA16F, 64, 64);
+	const int b = skr_graph_create(&g, "b", SKR_FORMAT_RGBA16F, 64, 64);
+	const int c = skr_graph_create(&g, "c", SKR_FORMAT_RGBA16F, 64, 64);
+	const int d = skr_graph_create(&g, "d", SKR_FORMAT_RGBA8, 64, 64);
+	CHECK(out == 0 && d == 4);
+
+	/* a -> b -> c -> target, and an unread pass writing d. */
+	int p[5];
+	for (int i = 0; i < 5; ++i)
+		p[i] = skr_graph_pass(&g, "pass", noop_pass, NULL);
+	CHECK(skr_graph_write(&g, p[0], a));
+	CHECK(skr_graph_read(&g, p[1], a) && skr_graph_write(&g, p[1], b));
+	CHECK(skr_graph_read(&g, p[2], b) && skr_graph_write(&g, p[2], c));
+	CHECK(skr_graph_write(&g, p[3], d));
+	CHECK(skr_graph_read(&g, p[4], c) && skr_graph_write(&g, p[4], out));
+
+	/* A pass renders to one framebuffer. */
+	CHECK(!skr_graph_write(&g, p[4], a));
+	CHECK(!skr_graph_read(&g, p[1], b));
+
+	CHECK(skr_graph_compile(&g));
+	CHECK(g.OrderCount == 4 && g.Passes[p[3]].Position == -1);
+	for (int i = 0; i < 4; ++i)
+		CHECK(g.Order[i] == (unsigned int)(i < 3 ? p[i] : p[4]));
+
+	/* a is dead once c is written: they share a target. */
+	CHECK(g.TargetCount == 2);
+	CHECK(g.Resources[a].Target == g.Resources[c].Target);
+	CHECK(g.Resources[b].Target != g.Resources[a].Target);
+	CHECK(g.Resources[out].Target == -1 && g.Resources[d].Target == -1);
+
+	/* Independent passes writing a are kept together. */
+	skr_graph_reset(&g);
+	const int x = skr_graph_create(&g, "x", SKR_FORMAT_RGBA8, 8, 8);
+	const int y = skr_graph_create(&g, "y", SKR_FORMAT_RGBA8, 8, 8);
+	const int o = skr_graph_import(&g, "target");
+	for (int i = 0; i < 4; ++i)
+		p[i] = skr_graph_pass(&g, "pass", noop_pass, NULL);
+	CHECK(skr_graph_write(&g, p[0], x));
+	CHECK(skr_graph_write(&g, p[1], y));
+	CHECK(skr_graph_write(&g, p[2], x));
+	CHECK(skr_graph_read(&g, p[3], x) && skr_graph_read(&g, p[3], y) &&
+	      skr_graph_write(&g, p[3], o));
+
+	CHECK(skr_graph_compile(&g));
+	CHECK(g.OrderCount == 4);
+	CHECK(g.Order[0] == (unsigned int)p[0] &&
+	      g.Order[1] == (unsigned int)p[2] &&
+	      g.Order[2] == (unsigned int)p[1]);
+
+	skr_graph_free(&g);
+	CHECK(g.Passes == NULL && g.TargetCount == 0);
+}
+
+static void test_resolution(void) {
+	SkrResolution r = {.Budget = 0.010};
+
+	skr_resolution_update(&r, 0.0);
+	CHECK(r.Scale == 1.0f);
+
+	/* Twice the budget: halve the pixels at once, on a step. */
+	skr_resolution_update(&r, 0.020);
+	CHECK(fabsf(r.Scale - 0.70f) < 1e-4f);
+
+	/* A spike never goes below the floor. */
+	skr_resolution_update(&r, 1.0);
+	CHECK(r.Scale == 0.5f);
+
+	/* Growth waits for a run of fast frames, one step at a time. */
+	for (int i = 0; i < 29; ++i)
+		skr_resolution_update(&r, 0.002);
+	CHECK(r.Scale == 0.5f);
+	skr_resolution_update(&r, 0.002);
+	CHECK(fabsf(r.Scale - 0.55f) < 1e-4f);
+
+	/* Within a step of the budget, nothing moves. */
+	const float scale = r.Scale;
+	for (int i = 0; i < 60; ++i)
+		skr_resolution_update(&r, 0.0095);
+	CHECK(r.Scale == scale && r.GpuTime == 0.0095);
+}
+
+static void test_temporal(void) {
+	SkrCamera   camera = *SkrDefaultFPSCamera;
+	SkrView     plain = {0}, view = {0};
+	SkrTemporal t = {0};
+
+	/* Halton offsets stay inside the pixel, around its center. */
+	vec2 sum = {0.0f, 0.0f};
+	for (int i = 0; i < 8; ++i) {
+		skr_temporal_jitter(&t, &view, 100, 50);
+		CHECK(fabsf(t.Jitter[0]) < 0.5f && fabsf(t.Jitter[1]) < 0.5f);
+		CHECK(fabsf(view.Jitter[0] - t.Jitter[0] / 50.0f) < 1e-6f);
+		CHECK(!view.Valid);
+		sum[0] += t.Jitter[0];
+		sum[1] += t.Jitter[1];
+	}
+	CHECK(fabsf(sum[0]) < 0.5f && fabsf(sum[1]) < 0.5f);
+
+	/* Jitter moves the projection, not the unjittered matrix or culling. */
+	skr_view_update(&plain, &camera, 2.0f);
+	CHECK(skr_view_update(&view, &camera, 2.0f));
+	CHECK(memcmp(view.Unjittered, plain.ViewProjection, sizeof(mat4)) == 0);
+	CHECK(memcmp(view.Planes, plain.Planes, sizeof(view.Planes)) == 0);
+	vec4 a, b, p = {0.0f, 0.0f, -5.0f, 1.0f};
+	glm_mat4_mulv(view.ViewProjection, p, a);
+	glm_mat4_mulv(plain.ViewProjection, p, b);
+	CHECK(fabsf(a[0] / a[3] - b[0] / b[3] - view.Jitter[0]) < 1e-5f);
+
+	/* Rows start without a previous transform until stored. */
+	SkrMesh        mesh = {0};
+	SkrMaterial    material = {0};
+	SkrRenderables r = {0};
+	SkrScene       scene = {0};
+	skr_renderables_add(&r, 0, &mesh, &material, (vec4){0, 0, 0, 1}, 0);
+	CHECK(r.Previous[0][3][3] == 0.0f);
+	skr_temporal_store(&t, &view, &r, &scene);
+	CHECK(t.Valid && r.Previous[0][3][3] == 1.0f);
+	CHECK(memcmp(t.PreviousViewProjection, view.Unjittered,
+	             sizeof(mat4)) == 0);
+	skr_temporal_reset(&t);
+	CHECK(!t.Valid);
+	skr_renderables_free(&r);
+}
+
+static void test_lut(void) {
+	unsigned char lut[4 * 4 * 4 * 4];
+	skr_lut_identity(4, lut);
+
+	/* Slices side by side along x by blue, red within, green up. */
+	const unsigned char* p = &lut[((2 * 4 + 3) * 4 + 1) * 4];
+	CHECK(p[0] == 85 && p[1] == 170 && p[2] == 255 && p[3] == 255);
+	CHECK(lut[0] == 0 && lut[sizeof(lut) - 2] == 255);
+}
+
+static void test_skinning(void) {
+	SkrSkinning skin = {0};
+
+	const int a = skr_skinning_alloc(&skin, 3);
+	const int b = skr_skinning_alloc(&skin, 300);
+	CHECK(a == 0 && b == 3);
+	CHECK(skin.Count == 303 && skin.Capacity >= 303);
+	CHECK(skin.Bones[(b + 299) * 3 + 2][2] == 1.0f);
+
+	/* Rows of the affine matrix, translation in w. */
+	mat4 m;
+	glm_translate_make(m, (vec3){1.0f, 2.0f, 3.0f});
+	skin.DirtyBegin = skin.DirtyEnd = 0;
+	skr_skinning_set(&skin, b, 7, m);
+	CHECK(skin.Bones[(b + 7) * 3 + 1][3] == 2.0f);
+	CHECK(skin.DirtyBegin == 10 && skin.DirtyEnd == 11);
+
+	/* Dual part of a pure translation is half of it. */
+	skr_skinning_set_dq(&skin, a, 1, (versor){0.0f, 0.0f, 0.0f, 1.0f},
+	                    (vec3){2.0f, 4.0f, 6.0f});
+	CHECK(skin.Bones[1 * 3 + 1][0] == 1.0f);
+	CHECK(skin.Bones[1 * 3 + 1][2] == 3.0f);
+	CHECK(skin.DirtyBegin == 1 && skin.DirtyEnd == 11);
+
+	SkrVertex verts[2] = {{.BoneWeights = {2.0f, 1.0f, 1.0f, 0.0f}}};
+	SkrMesh   mesh = {.Vertices = verts, .VertexCount = 2};
+	skr_mesh_normalize_weights(&mesh);
+	CHECK(verts[0].BoneWeights[0] == 0.5f);
+	CHECK(verts[0].BoneWeights[2] == 0.25f);
+	CHECK(verts[1].BoneWeights[0] == 0.0f);
+
+	/* CPU skinning blends the rows like the shaders do. */
+	const SkrVertex skinned[2] = {
+	        {.Position = {1.0f, 0.0f, 0.0f},
+	         .Normal = {0.0f, 1.0f, 0.0f},
+	         .BoneIDs = {0, 7},
+	         .BoneWeights = {0.5f, 0.5f}},
+	        {.Position = {1.0f, 0.0f, 0.0f}},
+	};
+	vec4 out[4];
+	skr_skin_vertices(&skin, b, skinned, 2, out);
+	CHECK(out[0][0] == 1.5f && out[0][1] == 1.0f && out[0][2] == 1.5f);
+	CHECK(out[1][1] == 1.0f && out[1][3] == 0.0f);
+	CHECK(out[2][0] == 1.0f && out[2][1] == 0.0f && out[2][3] == 1.0f);
+
+	skr_skinning_free(&skin);
+	CHECK(skin.Bones == NULL);
+}
+
+static void test_morphs(void) {
+	SkrVertex verts[4] = {0};
+	SkrMesh   mesh = {.Vertices = verts, .VertexCount = 4};
+
+	/* Smile moves vertex 1 on x, brow moves vertices 1 and 2 on y. */
+	const vec3 smile[4] = {{0}, {1.0f, 0.0f, 0.0f}, {0}, {0}};
+	const vec3 brow[4] = {{0}, {0.0f, 0.5f, 0.0f}, {0.0f, 2.0f, 0.0f}, {0}};
+	const vec3 tilt[4] = {{0}, {0}, {0.0f, 0.0f, 1.0f}, {0}};
+	CHECK(skr_mesh_add_morph_target(&mesh, smile, NULL, 1e-4f) == 0);
+	CHECK(skr_mesh_add_morph_target(&mesh, brow, tilt, 1e-4f) == 1);
+	CHECK(mesh.DeltaCount == 3 && mesh.Targets[1].Count == 2);
+
+	SkrMorphs m = {0};
+	CHECK(skr_morphs_alloc(&m, &mesh) == 0);
+	CHECK(skr_morphs_alloc(&m, &mesh) == 1);
+	const unsigned int base = m.Instances[1].Base;
+	CHECK(base == 4 && m.Count == 8);
+
+	m.DirtyBegin = m.DirtyEnd = 0;
+	skr_morphs_set_weight(&m, 1, 0, 1.0f);
+	skr_morphs_set_weight(&m, 1, 1, 0.5f);
+	skr_morphs_update(&m);
+	CHECK(fabsf(m.Deltas[(base + 1) * 2][0] - 1.0f) < 1e-3f);
+	CHECK(fabsf(m.Deltas[(base + 1) * 2][1] - 0.25f) < 1e-3f);
+	CHECK(fabsf(m.Deltas[(base + 2) * 2][1] - 1.0f) < 1e-3f);
+	CHECK(fabsf(m.Deltas[(base + 2) * 2 + 1][2] - 0.5f) < 1e-3f);
+	CHECK(m.Instances[1].TouchedCount == 2);
+	CHECK(m.DirtyBegin == base + 1 && m.DirtyEnd == base + 3);
+
+	/* Zeroed targets are cleared and skipped, other instances untouched. */
+	skr_morphs_set_weight(&m, 1, 1, 0.0f);
+	skr_morphs_update(&m);
+	CHECK(m.Deltas[(base + 2) * 2][1] == 0.0f);
+	CHECK(m.Deltas[(base + 2) * 2 + 1][2] == 0.0f);
+	CHECK(fabsf(m.Deltas[(base + 1) * 2][0] - 1.0f) < 1e-3f);
+	CHECK(m.Deltas[(base + 1) * 2][1] == 0.0f);
+	CHECK(m.Instances[1].TouchedCount == 1);
+	CHECK(m.Deltas[1 * 2][0] == 0.0f);
+
+	/* A target added after the instances gets a weight of its own. */
+	const vec3 jaw[4] = {{0}, {0}, {0}, {0.0f, 0.0f, 4.0f}};
+	CHECK(skr_mesh_add_morph_target(&mesh, jaw, NULL, 1e-4f) == 2);
+	skr_morphs_set_weight(&m, 1, 2, 0.25f);
+	skr_morphs_update(&m);
+	CHECK(m.Instances[1].TargetCount == 3);
+	CHECK(m.Instances[0].TargetCount == 2);
+	CHECK(fabsf(m.Deltas[(base + 3) * 2][2] - 1.0f) < 1e-3f);
+	CHECK(fabsf(m.Deltas[(base + 1) * 2][0] - 1.0f) < 1e-3f);
+
+	skr_morphs_free(&m);
+	skr_mesh_free_morph_targets(&mesh);
+	CHECK(m.Deltas == NULL && mesh.TargetCount == 0);
+}
+
+static void sum_slice(void* user, unsigned int begin, unsigned int end) {
+	atomic_uint* sum = user;
+	unsigned int local = 0;
+
+	for (unsigned int i = begin; i < end; ++i)
+		local += i;
+	atomic_fetch_add(sum, local);
+}
+
+static void test_jobs(void) {
+	SkrJobs jobs;
+	CHECK(skr_jobs_init(&jobs, 3));
+	CHECK(jobs.ThreadCount == 3);
+
+	for (int run = 0; run < 100; ++run) {
+		atomic_uint sum = 0;
+		skr_jobs_for(&jobs, 1000, 7, sum_slice, &sum);
+		CHECK(sum == 999 * 1000 / 2);
+	}
+
+	skr_jobs_free(&jobs);
+}
+
+static void test_radix_sort(void) {
+	const float  floats[5] = {-2.0f, -0.5f, 0.0f, 1.0f, 3.0f};
+	SkrRadixSort sort = {0};
+	SkrJobs      jobs;
+
+	for (int i = 1; i < 5; ++i)
+		CHECK(skr_radix_float_key(floats[i - 1]) <
+		      skr_radix_float_key(floats[i]));
+
+	/* 16-bit keys with many repeats: two passes, equal keys in order. */
+	CHECK(skr_jobs_init(&jobs, 3));
+	for (int run = 0; run < 2; ++run) {
+		const unsigned int count = 100000;
+		unsigned int       seed = 1;
+		CHECK(skr_radix_reserve(&sort, count));
+		for (unsigned int i = 0; i < count; ++i) {
+			seed = seed * 1664525u + 1013904223u;
+			sort.Keys[i] = seed >> 8 & 0xffffu;
+			sort.Values[i] = i;
+		}
+
+		skr_radix_sort(&sort, count, run ? &jobs : NULL);
+		CHECK(sort.Passes == 2);
+
+		int ordered = 1;
+		for (unsigned int i = 1; i < count; ++i)
+			ordered &= sort.Keys[i - 1] < sort.Keys[i] ||
+			           (sort.Keys[i - 1] == sort.Keys[i] &&
+			            sort.Values[i - 1] < sort.Values[i]);
+		CHECK(ordered);
+	}
+
+	skr_jobs_free(&jobs);
+	skr_radix_free(&sort);
+}
+
+static void test_animation(void) {
+	/* One bone: translation 0 -> 10 on x, rotation 0 -> 90 deg on y. */
+	const float    times[2] = {0.0f, 1.0f};
+	const float    pos[6] = {0.0f, 0.0f, 0.0f, 10.0f, 0.0f, 0.0f};
+	const float    s = 0.70710678f;
+	const float    rot[8] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, s, 0.0f, s};
+	SkrTrackSource tracks[SKR_TRACK_TYPES] = {
+	        [SKR_TRACK_TRANSLATION] = {times, pos, 2},
+	        [SKR_TRACK_ROTATION] = {times, rot, 2},
+	};
+
+	SkrClip clip;
+	CHECK(skr_clip_build(&clip, 1.0f, 1, tracks));
+	CHECK(clip.KeyCount == 4);
+
+	SkrSkeleton skel;
+	CHECK(skr_skeleton_init(&skel, 1));
+
+	SkrClipCursor cursor;
+	CHECK(skr_clip_cursor_init(&cursor, &clip));
+
+	SkrBonePose pose = skel.BindPose[0];
+	skr_clip_sample(&clip, &cursor, 0.5f, &pose);
+	CHECK(fabsf(pose.Translation[0] - 5.0f) < 1e-3f);
+	CHECK(fabsf(pose.Rotation[1] - sinf(GLM_PI / 8.0f)) < 1e-2f);
+	CHECK(pose.Scale[0] == 1.0f);
+
+	/* Rewinding resets the cursor. */
+	skr_clip_sample(&clip, &cursor, 1.0f, &pose);
+	CHECK(fabsf(pose.Rotation[1] - s) < 1e-3f);
+	skr_clip_sample(&clip, &cursor, 0.0f, &pose);
+	CHECK(fabsf(pose.Rotation[3] - 1.0f) < 1e-3f);
+	CHECK(fabsf(pose.Translation[0]) < 1e-3f);
+
+	SkrBonePose half;
+	skr_pose_blend(&half, &skel.BindPose[0], &pose, 0.5f, NULL, 1);
+	CHECK(fabsf(half.Rotation[3] - 1.0f) < 1e-3f);
+
+	mat4 model[1];
+	skr_clip_sample(&clip, &cursor, 1.0f, &pose);
+	skr_skeleton_model(&skel, &pose, model);
+	CHECK(fabsf(model[0][3][0] - 10.0f) < 1e-3f);
+
+	skr_clip_cursor_free(&cursor);
+	skr_clip_free(&clip);
+	skr_skeleton_free(&skel);
+}
+
+static float anim_x(const SkrSkinning* skin, int base, unsigned int bone) {
+	return skin->Bones[((unsigned int)base + bone) * 3][3];
+}
+
+static float anim_y(const SkrSkinning* skin, int base, unsigned int bone) {
+	return skin->Bones[((unsigned int)base + bone) * 3 + 1][3];
+}
+
+static void test_animation_lod(void) {
+	/* Root slides 10 units a second on x, its child sits 1 up. */
+	const float    times[2] = {0.0f, 2.0f};
+	const float    root[6] = {0.0f, 0.0f, 0.0f, 20.0f, 0.0f, 0.0f};
+	const float    child[6] = {0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+	SkrTrackSource tracks[2 * SKR_TRACK_TYPES] = {
+	        [SKR_TRACK_TRANSLATION] = {times, root, 2},
+	        [SKR_TRACK_TYPES + SKR_TRACK_TRANSLATION] = {times, child, 2},
+	};
+
+	SkrClip clip;
+	CHECK(skr_clip_build(&clip, 2.0f, 2, tracks));
+
+	/* Below the first level the child follows the root. */
+	static const int follow[2] = {0, 0};
+	SkrSkeleton      skel;
+	CHECK(skr_skeleton_init(&skel, 2));
+	skel.Parent[1] = 0;
+	for (int l = 1; l < SKR_ANIM_LODS; ++l)
+		skel.Remap[l] = follow;
+
+	SkrMesh        mesh = {0};
+	SkrMaterial    material = {0};
+	SkrRenderables r = {0};
+	SkrRenderable  h[3];
+	for (unsigned int k = 0; k < 3; ++k) {
+		skr_renderables_add(&r, 0, &mesh, &material, (vec4){0, 0, 2, 1},
+		                    SKR_RENDERABLE_VISIBLE);
+		h[k] = skr_renderables_handle(&r, k);
+	}
+
+	SkrView view = {0};
+	view.Valid = 1;
+	for (int p = 0; p < 6; ++p)
+		view.Planes[p][3] = 1.0f;
+
+	SkrSkinning   skin = {0};
+	SkrAnimations a = {0};
+	const int     i = skr_animations_add(&a, &skin, &skel, &clip, h[0]);
+	CHECK(i == 0);
+	CHECK(a.Lods[0].Interval == 1);
+	const int base = a.Palette[i];
+
+	/* Near: sampled every frame on every bone. */
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Lod[i] == 0 && a.Sampled == 1);
+	CHECK(fabsf(anim_x(&skin, base, 0) - 1.0f) < 1e-3f);
+	CHECK(fabsf(anim_y(&skin, base, 1) - 1.0f) < 1e-3f);
+
+	/* Far: sampled every 4 frames, blended in between. Row 0 enters the
+	 * rate with a one frame span, and its dropped child eases onto the
+	 * root by the end of the first full span. */
+	r.Bounds[0][2] = 50.0f;
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Lod[i] == 2 && a.Sampled == 1);
+	CHECK(fabsf(anim_x(&skin, base, 0) - 2.0f) < 1e-3f);
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Sampled == 1 && a.Interval[i] == 4);
+	CHECK(fabsf(anim_x(&skin, base, 0) - 3.0f) < 1e-3f);
+	for (int f = 4; f <= 6; ++f) {
+		skr_animations_update(&a, &skin, &view, &r, 0.1f);
+		CHECK(a.Sampled == 0);
+		CHECK(fabsf(anim_x(&skin, base, 0) - (float)f) < 1e-3f);
+	}
+	CHECK(fabsf(anim_y(&skin, base, 1)) < 1e-3f);
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Sampled == 1);
+	CHECK(fabsf(anim_x(&skin, base, 0) - 7.0f) < 1e-3f);
+
+	/* Offscreen: frozen by default. */
+	view.Planes[0][3] = -100.0f;
+	const float held = anim_x(&skin, base, 0);
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Frozen == 1 && a.Sampled == 0);
+	CHECK(anim_x(&skin, base, 0) == held);
+	view.Planes[0][3] = 1.0f;
+	r.Bounds[0][2] = 2.0f;
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Sampled == 1 && a.Frozen == 0);
+
+	/* Over budget the most urgent row runs, the rest wait. */
+	CHECK(skr_animations_add(&a, &skin, &skel, &clip, h[1]) == 1);
+	CHECK(skr_animations_add(&a, &skin, &skel, &clip, h[2]) == 2);
+	a.Budget = 1e-9f;
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Sampled == 1 && a.Deferred == 2);
+	a.Budget = 0.0f;
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Sampled == 3 && a.Deferred == 0);
+
+	/* Removing a renderable moves the last one, animations follow it. */
+	skr_renderables_remove(&r, 0);
+	CHECK(skr_renderables_row(&r, h[0]) == -1);
+	CHECK(skr_renderables_row(&r, h[2]) == 0);
+	r.Bounds[0][2] = 50.0f;
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Lod[0] == 0 && a.Lod[1] == 0 && a.Lod[2] == 2);
+
+	/* Clips without a length are refused and hold still. */
+	clip.Duration = 0.0f;
+	CHECK(skr_animations_add(&a, &skin, &skel, &clip, 0) == -1);
+	skr_animations_update(&a, &skin, &view, &r, 0.1f);
+	CHECK(a.Time[0] == 0.0f && a.Time[2] == 0.0f);
+	CHECK(!isnan(anim_x(&skin, base, 0)));
+	SkrClearError();
+
+	skr_renderables_free(&r);
+	skr_animations_free(&a);
+	CHECK(a.Count == 0 && a.Lods[0].Interval == 1);
+	skr_skinning_free(&skin);
+	skr_clip_free(&clip);
+	skr_skeleton_free(&skel);
+}
+
+static SkrNode scene_node(SkrScene* scene, SkrNode parent, float x) {
+	const SkrNode node = skr_scene_node_create(scene, parent);
+	skr_scene_node_set_position(scene, node, (vec3){x, 0.0f, 0.0f});
+	return node;
+}
+
+static float scene_world_x(const SkrScene* scene, SkrNode node) {
+	return scene->World[scene->Slot[node]][3][0];
+}
+
+static void test_scene(void) {
+	SkrScene scene = {0};
+
+	const SkrNode a = scene_node(&scene, 0, 1.0f);
+	const SkrNode b = scene_node(&scene, a, 2.0f);
+	const SkrNode c = scene_node(&scene, b, 4.0f);
+	const SkrNode d = scene_node(&scene, 0, 8.0f);
+
+	skr_scene_update(&scene);
+	CHECK(scene_world_x(&scene, c) == 7.0f);
+	CHECK(scene_world_x(&scene, d) == 8.0f);
+	CHECK(scene.DirtyCount == 0);
+
+	/* Stale or out-of-range handles are refused without touching slots. */
+	CHECK(!skr_scene_node_set_position(&scene, 0, (vec3){1.0f, 0.0f, 0.0f}));
+	CHECK(!skr_scene_node_set_rotation(&scene, d + 1,
+	                                   (versor){0.0f, 0.0f, 0.0f, 1.0f}));
+	CHECK(!skr_scene_node_set_scale(&scene, 1000, (vec3){2.0f, 2.0f, 2.0f}));
+	CHECK(SkrLastError() == SKR_ERROR_INVALID_ARGUMENT);
+	CHECK(scene.DirtyCount == 0);
+	SkrClearError();
+
+	/* Moving a parent moves its subtree only. */
+	skr_scene_node_set_position(&scene, a, (vec3){10.0f, 0.0f, 0.0f});
+	skr_scene_node_set_scale(&scene, b, (vec3){2.0f, 2.0f, 2.0f});
+	skr_scene_update(&scene);
+	CHECK(scene_world_x(&scene, b) == 12.0f);
+	CHECK(scene_world_x(&scene, c) == 20.0f);
+	CHECK(scene_world_x(&scene, d) == 8.0f);
+
+	/* Reparenting re-sorts by depth and keeps handles valid. */
+	CHECK(skr_scene_node_set_parent(&scene, d, c));
+	CHECK(!skr_scene_node_set_parent(&scene, a, c));
+	skr_scene_update(&scene);
+	CHECK(scene_world_x(&scene, d) == 36.0f);
+	for (unsigned int i = 1; i < scene.Count; ++i)
+		CHECK(scene.Depth[i - 1] <= scene.Depth[i]);
+
+	CHECK(skr_scene_node_set_parent(&scene, c, 0));
+	skr_scene_update(&scene);
+	CHECK(scene_world_x(&scene, c) == 4.0f);
+	CHECK(scene_world_x(&scene, d) == 12.0f);
+
+	skr_scene_free(&scene);
+	CHECK(scene.Count == 0);
+}
+
+static void test_scene_resort(void) {
+	SkrScene scene = {0};
+
+	const SkrNode a = scene_node(&scene, 0, 1.0f);
+	const SkrNode b = scene_node(&scene, 0, 2.0f);
+	const SkrNode c = scene_node(&scene, a, 4.0f);
+
+	/* Reparenting every frame re-sorts every frame, without growing. */
+	const unsigned int capacity = scene.Capacity;
+	for (int i = 0; i < 100; ++i) {
+		CHECK(skr_scene_node_set_parent(&scene, c, i & 1 ? a : b));
+		skr_scene_update(&scene);
+		CHECK(!scene.Unsorted);
+		CHECK(scene_world_x(&scene, c) == (i & 1 ? 5.0f : 6.0f));
+	}
+	CHECK(scene.Capacity == capacity);
+
+	skr_scene_free(&scene);
+}
+
+static void test_scene_interpolate(void) {
+	SkrScene scene = {.Interpolate = true};
+
+	const SkrNode a = scene_node(&scene, 0, 0.0f);
+	const SkrNode b = scene_node(&scene, a, 1.0f);
+
+	/* One simulation step moves `a` from 0 to 4. */
+	skr_scene_step_begin(&scene);
+	skr_scene_node_set_position(&scene, a, (vec3){4.0f, 0.0f, 0.0f});
+
+	skr_scene_interpolate(&scene, 0.25f);
+	skr_scene_update(&scene);
+	CHECK(scene_world_x(&scene, a) == 1.0f);
+	CHECK(scene_world_x(&scene, b) == 2.0f);
+
+	skr_scene_interpolate(&scene, 1.0f);
+	skr_scene_update(&scene);
+	CHECK(scene_world_x(&scene, b) == 5.0f);
+
+	/* A step without movement settles on the current transform. */
+	skr_scene_step_begin(&scene);
+	skr_scene_interpolate(&scene, 0.5f);
+	skr_scene_update(&scene);
+	CHECK(scene.MovingCount == 0);
+	CHECK(scene_world_x(&scene, a) == 4.0f);
+
+	/* Placed without interpolation, the first move starts from there. */
+	scene.Interpolate = false;
+	const SkrNode c = scene_node(&scene, 0, 10.0f);
+	scene.Interpolate = true;
+	skr_scene_step_begin(&scene);
+	skr_scene_node_set_position(&scene, c, (vec3){12.0f, 0.0f, 0.0f});
+	skr_scene_interpolate(&scene, 0.5f);
+	skr_scene_update(&scene);
+	CHECK(scene_world_x(&scene, c) == 11.0f);
+
+	/* Reparenting mid-step snaps instead of blending across parents. */
+	CHECK(skr_scene_node_set_parent(&scene, c, a));
+	skr_scene_update(&scene);
+	CHECK(scene_world_x(&scene, c) == 16.0f);
+
+	skr_scene_free(&scene);
+}
+
+static void test_renderables(void) {
+	SkrScene       scene = {0};
+	SkrRenderables r = {0};
+	SkrMesh        meshes[2] = {{.VertexCount = 3}, {.VertexCount = 3}};
+	SkrMaterial    materials[2] = {{0}, {0}};
+
+	const SkrNode near = scene_node(&scene, 0, 0.0f);
+	const SkrNode far = scene_node(&scene, 0, 100.0f);
+	skr_scene_update(&scene);
+
+	const vec4 unit = {0.0f, 0.0f, 0.0f, 1.0f};
+	CHECK(skr_renderables_add(&r, near, &meshes[1], &materials[1], unit,
+	                          SKR_RENDERABLE_VISIBLE) == 0);
+	CHECK(skr_renderables_add(&r, far, &meshes[0], &materials[0], unit,
+	                          SKR_RENDERABLE_VISIBLE) == 1);
+	CHECK(skr_renderables_add(&r, near, &meshes[0], &materials[0], unit,
+	                          SKR_RENDERABLE_VISIBLE) == 2);
+	CHECK(skr_renderables_add(&r, near, &meshes[0], &materials[0], unit,
+	                          0) == 3);
+	CHECK(skr_renderables_add(&r, near, NULL, &materials[0], unit, 0) ==
+	      -1);
+
+	skr_renderables_update_bounds(&r, &scene);
+	CHECK(r.Bounds[1][0] == 100.0f);
+
+	/* Everything visible, sorted by material then mesh. */
+	CHECK(skr_renderables_cull(&r, NULL) == 3);
+	skr_renderables_sort(&r);
+	for (unsigned int i = 1; i < r.DrawCount; ++i)
+		CHECK(r.Draws[i - 1].Material <= r.Draws[i].Material);
+
+	/* x <= 10 half-space drops the far renderable. */
+	const vec4 planes[6] = {
+	        {-1.0f, 0.0f, 0.0f, 10.0f}, {0.0f, 0.0f, 0.0f, 1.0f},
+	        {0.0f, 0.0f, 0.0f, 1.0f},   {0.0f, 0.0f, 0.0f, 1.0f},
+	        {0.0f, 0.0f, 0.0f, 1.0f},   {0.0f, 0.0f, 0.0f, 1.0f},
+	};
+	CHECK(skr_renderables_cull(&r, planes) == 2);
+
+	const SkrRenderable first = skr_renderables_handle(&r, 0);
+	const SkrRenderable last = skr_renderables_handle(&r, 3);
+	skr_renderables_remove(&r, 0);
+	CHECK(r.Count == 3);
+	CHECK(r.Mesh[0] == &meshes[0] && r.Flags[0] == 0);
+	CHECK(skr_renderables_row(&r, last) == 0);
+	CHECK(skr_renderables_row(&r, first) == -1);
+
+	/* Released handles are reused. */
+	CHECK(skr_renderables_add(&r, near, &meshes[0], &materials[0], unit,
+	                          0) == 3);
+	CHECK(skr_renderables_handle(&r, 3) == first);
+
+	skr_renderables_free(&r);
+	skr_scene_free(&scene);
+}
+
+static void test_clusters(void) {
+	enum { W = 4, H = 64 };
+	static SkrVertex    verts[(W + 1) * (H + 1)];
+	static unsigned int idx[W * H * 6];
+	SkrMesh        mesh = {.Vertices = verts,
+	                       .VertexCount = (W + 1) * (H + 1),
+	                       .Indices = idx,
+	                       .IndexCount = W * H * 6};
+	SkrMaterial    material = {0};
+	SkrRenderables r = {0};
+	SkrView        view = {0};
+	SkrCamera      camera = *SkrDefaultFPSCamera;
+
+	/* A tall strip at z = 0 facing +z, one row of quads per cluster. */
+	for (int y = 0; y <= H; ++y)
+		for (int x = 0; x <= W; ++x)
+			glm_vec3_copy((vec3){x * 2.5f - 5.0f, y * 2.5f - 80.0f,
+			                     0.0f},
+			              verts[y * (W + 1) + x].Position);
+	for (int q = 0; q < W * H; ++q) {
+		const unsigned int v = (unsigned int)(q / W * (W + 1) + q % W);
+		const unsigned int quad[6] = {v, v + 1, v + W + 2,
+		                              v, v + W + 2, v + W + 1};
+		memcpy(&idx[q * 6], quad, sizeof(quad));
+	}
+
+	CHECK(skr_mesh_build_clusters(&mesh, W * 2) == H);
+	CHECK(mesh.Clusters[1].First == W * 6);
+	CHECK(mesh.Clusters[1].Cone[2] == 1.0f);
+	CHECK(mesh.Clusters[1].Cone[3] == 0.0f);
+	CHECK(fabsf(mesh.Clusters[0].Bounds[1] + 78.75f) < 1e-4f);
+
+	camera.Position[2] = 20.0f;
+	skr_camera_rotate(&camera, 0.0f, 0.0f);
+	CHECK(skr_view_update(&view, &camera, 1.0f));
+	skr_renderables_add(&r, 0, &mesh, &material, (vec4){0, 0, 0, 90},
+	                    SKR_RENDERABLE_VISIBLE);
+
+	/* Rows outside the frustum go, the rest merge into one run. */
+	skr_renderables_cull(&r, (const vec4*)view.Planes);
+	CHECK(skr_renderables_cull_clusters(&r, NULL, &view) == 1);
+	CHECK(r.ClusterCount == H);
+	CHECK(r.ClusterVisible > 0 && r.ClusterVisible < H);
+	CHECK(r.Draws[0].RunCount == 1 && r.RunCount == 1);
+	CHECK(r.Runs[1] == r.ClusterVisible * W * 6);
+
+	/* Flipped, every triangle faces away and the draw is dropped. */
+	for (int t = 0; t < W * H * 2; ++t) {
+		const unsigned int swap = idx[t * 3 + 1];
+		idx[t * 3 + 1] = idx[t * 3 + 2];
+		idx[t * 3 + 2] = swap;
+	}
+	CHECK(skr_mesh_build_clusters(&mesh, W * 2) == H);
+	const unsigned int visible = r.ClusterVisible;
+
+	/* Both sides are drawn unless the material culls back faces. */
+	skr_renderables_cull(&r, (const vec4*)view.Planes);
+	CHECK(skr_renderables_cull_clusters(&r, NULL, &view) == 1);
+	CHECK(r.ClusterVisible == visible);
+
+	/* Culled, every triangle faces away and the draw is dropped. */
+	material.CullBackFaces = true;
+	skr_renderables_cull(&r, (const vec4*)view.Planes);
+	CHECK(skr_renderables_cull_clusters(&r, NULL, &view) == 0);
+	CHECK(r.ClusterVisible == 0);
+
+	/* A mirroring transform flips the winding, the cone test is skipped. */
+	SkrScene      scene = {0};
+	const SkrNode mirror = skr_scene_node_create(&scene, 0);
+	skr_scene_node_set_scale(&scene, mirror, (vec3){-1.0f, 1.0f, 1.0f});
+	skr_scene_update(&scene);
+	r.Node[0] = mirror;
+	skr_renderables_cull(&r, (const vec4*)view.Planes);
+	CHECK(skr_renderables_cull_clusters(&r, &scene, &view) == 1);
+	CHECK(r.ClusterVisible == visible);
+
+	skr_scene_free(&scene);
+	skr_mesh_free_clusters(&mesh);
+	skr_renderables_free(&r);
+}
+
+static void test_transparent(void) {
+	SkrRenderables r = {0};
+	SkrRadixSort   sort = {0};
+	SkrMesh        mesh = {.VertexCount = 3};
+	SkrMaterial    material = {0};
+	SkrView        view = {0};
+	SkrCamera      camera = *SkrDefaultFPSCamera;
+
+	/* The camera looks down -z; transparents at z = -2, -8 and -4. */
+	const float z[4] = {-2.0f, -8.0f, -6.0f, -4.0f};
+	for (int i = 0; i < 4; ++i) {
+		const unsigned int flags =
+		        SKR_RENDERABLE_VISIBLE |
+		        (i == 2 ? 0u : SKR_RENDERABLE_TRANSPARENT);
+		skr_renderables_add(&r, 0, &mesh, &material,
+		                    (vec4){0.0f, 0.0f, z[i], 1.0f}, flags);
+	}
+
+	CHECK(skr_renderables_cull(&r, NULL) == 4);
+	CHECK(r.DrawCount == 1 && r.Draws[0].Index == 2);
+	CHECK(r.TransparentCount == 3);
+
+	/* Farthest first. */
+	skr_camera_rotate(&camera, 0.0f, 0.0f);
+	CHECK(skr_view_update(&view, &camera, 1.0f));
+	CHECK(skr_renderables_sort_transparent(&r, &view, &sort, NULL));
+	CHECK(r.Transparent[0].Index == 1);
+	CHECK(r.Transparent[1].Index == 3);
+	CHECK(r.Transparent[2].Index == 0);
+	CHECK(r.Transparent[2].Mesh == &mesh);
+
+	skr_radix_free(&sort);
+	skr_renderables_free(&r);
+}
+
+int main(void) {
+	test_mesh_append_vertices();
+	test_state_append_model();
+	test_last_error();
+	test_debug();
+	test_pacing();
+	test_input();
+	test_view();
+	test_lights();
+	test_shadows();
+	test_graph();
+	test_resolution();
+	test_temporal();
+	test_lut();
+	test_skinning();
+	test_morphs();
+	test_jobs();
+	test_radix_sort();
+	test_animation();
+	test_animation_lod();
+	test_scene();
+	test_scene_resort();
+	test_scene_interpolate();
+	test_renderables();
+	test_transparent();
+	test_clusters();
+
+	if (failures) {
+		fprintf(stderr, "%d check(s) failed\n", failures);
+		return 1;
+	}
+
+	return 0;
+}
@@ -7,6 +7,8 @@
 #define SKR_BACKEND_WINDOW 0 // using glfw
 #include "../skr/skr.h"
 
+#define FRAMES 60
+
 int main(void) {
 	SkrWindow window = {
 	        .Title = "Hello SKR",
@@ -14,7 +16,7 @@ int main(void) {
 	        .Height = 600,
 	};
 
-	SkrState state = SkrInit(&window);
+	SkrState state = SkrInit(&window, SKR_BACKEND_API_GL);
 	if (!SKR_OK) {
 		fprintf(stderr, "Failed to init window: %s\n", SKR_LAST_ERROR);
 		return 1;
@@ -25,10 +27,17 @@ int main(void) {
 		return 1;
 	}
 
-	while (!SkrWindowShouldClose(&window)) {
+	SkrTriangle(&state);
+
+	if (!SkrRendererInit(&state)) {
+		fprintf(stderr, "Failed to init renderer: %s\n", SKR_LAST_ERROR);
+		return 1;
+	}
+
+	for (int frame = 0; frame < FRAMES && !SkrShouldClose(&state);
+	     ++frame) {
 		SkrRendererRender(&state);
 	}
 
-	SkrFinalize(&state);
 	return 0;
 }